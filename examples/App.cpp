@@ -50,11 +50,9 @@ App::App()
             }
     }
     // Create per frame data
+    _frameTimeline = _ctx->CreateTimelineSemaphore(0);
     for (uint32_t i = 0; i < MAX_FRAMES; i++)
         {
-            _frameData[i].Fence                   = _ctx->CreateFence(true); // already signaled
-            _frameData[i].CmdPool                 = _ctx->CreateCommandPool();
-            _frameData[i].Cmd                     = _ctx->CreateCommandBuffer(_frameData[i].CmdPool);
             _frameData[i].ImageAvailableSemaphore = _ctx->CreateGpuSemaphore();
             _frameData[i].WorkFinishedSemaphore   = _ctx->CreateGpuSemaphore();
         }
@@ -69,12 +67,10 @@ App ::~App()
     _ctx->WaitDeviceIdle();
     for (uint32_t i = 0; i < MAX_FRAMES; i++)
         {
-            _ctx->DestroyFence(_frameData[i].Fence);
-            _ctx->DestroyCommandBuffer(_frameData[i].Cmd);
-            _ctx->DestroyCommandPool(_frameData[i].CmdPool);
             _ctx->DestroyGpuSemaphore(_frameData[i].ImageAvailableSemaphore);
             _ctx->DestroyGpuSemaphore(_frameData[i].WorkFinishedSemaphore);
         }
+    _ctx->DestroyTimelineSemaphore(_frameTimeline);
 
     glfwDestroyWindow(_window);
     glfwTerminate();
@@ -93,14 +89,12 @@ App::Run()
 
             PerFrameData& data = _frameData[_frameIndex];
 
-            // Wait for fence
-            if (!_ctx->IsFenceSignaled(data.Fence))
+            // Wait for the previous use of the frame data to complete
+            if (_ctx->GetTimelineSemaphoreValue(_frameTimeline) < data.FrameValue)
                 {
-                    _ctx->WaitForFence(data.Fence, 0xFFFFFFFFFFFFF);
+                    _ctx->WaitTimelineSemaphore(_frameTimeline, data.FrameValue, 0xFFFFFFFFFFFFF);
                 }
 
-            _ctx->ResetCommandPool(data.CmdPool);
-
             const bool success = _ctx->SwapchainAcquireNextImageIndex(_swapchain, 0xFFFFFFFFFFFFF, data.ImageAvailableSemaphore, &_swapchainImageIndex);
             if (!success)
                 {
@@ -120,12 +114,20 @@ App::Run()
                     _ctx->SwapchainAcquireNextImageIndex(_swapchain, 0xFFFFFFF, data.ImageAvailableSemaphore, &_swapchainImageIndex);
                 }
 
-            // Perform drawing
-            Draw(data.Cmd, w, h);
-
-            _ctx->ResetFence(data.Fence);
-            _ctx->QueueSubmit({ data.ImageAvailableSemaphore }, { data.WorkFinishedSemaphore }, { data.Cmd }, data.Fence);
-
-            _ctx->QueuePresent(_swapchain, _swapchainImageIndex, { data.WorkFinishedSemaphore });
+            // Perform drawing, the command buffer is recycled by the context once the frame completed
+            const uint32_t cmd = _ctx->AcquireCommandBuffer();
+            Draw(cmd, w, h);
+
+            // Submitted from the stack, no allocation per frame
+            data.FrameValue                           = ++_frameCount;
+            const uint32_t            waitSemaphore[] = { data.ImageAvailableSemaphore };
+            const uint32_t            workFinished[]  = { data.WorkFinishedSemaphore };
+            const Fox::DTimelineValue frameSignal[]   = { { _frameTimeline, data.FrameValue } };
+            const uint32_t            cmds[]          = { cmd };
+            _ctx->QueueSubmit(waitSemaphore, {}, workFinished, frameSignal, cmds, NULL);
+
+            _ctx->QueuePresent(_swapchain, _swapchainImageIndex, workFinished);
+            _ctx->BeginFrame();
+            _frameIndex = (_frameIndex + 1) % MAX_FRAMES;
         }
 }
\ No newline at end of file
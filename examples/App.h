@@ -37,9 +37,7 @@ class App
 
     struct PerFrameData
     {
-        uint32_t Fence{};
-        uint32_t CmdPool{};
-        uint32_t Cmd{};
+        uint64_t FrameValue{}; // Value of the frame timeline signaled when the frame completes
         uint32_t ImageAvailableSemaphore;
         uint32_t WorkFinishedSemaphore;
     };
@@ -47,4 +45,6 @@ class App
     std::array<PerFrameData, MAX_FRAMES> _frameData;
     std::array<uint32_t, MAX_FRAMES>     _swapchainRenderTargets;
     uint32_t                             _frameIndex{};
+    uint32_t                             _frameTimeline{};
+    uint64_t                             _frameCount{};
 };
\ No newline at end of file
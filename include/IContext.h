@@ -5,6 +5,7 @@
 #include <array>
 #include <map>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -42,14 +43,64 @@ enum EResourceType : uint8_t
     DESCRIPTOR_SET        = 15,
     SAMPLER               = 16,
     INDIRECT_DRAW_COMMAND = 17,
+    RENDER_PASS           = 18,
+    COMPUTE_PIPELINE      = 19,
+    TIMELINE_SEMAPHORE    = 20,
 };
 // SHOULD BE PRIVATE
 
+/*Number of slots of a resource pool, it starts with Initial slots and grows on demand up to Max. A slot is retired after 2047
+reuses, handles of its earlier resources stay invalid. Retired slots are reused, oldest first, once the pool has grown to Max
+and has no other free slot, then a handle destroyed 2047 reuses earlier can alias the new resource*/
+struct DResourcePoolCapacity
+{
+    uint32_t Initial{ 64 };
+    uint32_t Max{ 65536 }; // Can't exceed 65536, the index inside a resource id is 16 bits
+};
+
 struct DContextConfig
 {
     uint32_t stagingBufferSize{ 64 * 1024 * 1024 }; // 64mb
     void (*warningFunction)(const char*){};
     void (*logOutputFunction)(const char*){};
+    // Begin rendering straight from the render target views, pipelines are created against the attachment formats only.
+    // Falls back to render passes and framebuffers if the device doesn't support VK_KHR_dynamic_rendering
+    bool dynamicRendering{};
+    // The context tracks the state of every image and render target subresource in recording order. ResourceBarrier ignores
+    // the current state passed by the caller and drops transitions to the state a resource is already in. Binding render
+    // targets, descriptor sets and copying to images insert the transitions they need, descriptor sets must be bound before
+    // the render targets to be transitioned outside of the render pass. Buffer states aren't tracked and split barriers are
+    // recorded as full barriers. Release and Acquire barriers are recorded with the states passed by the caller, both halves
+    // of a queue family ownership transfer must match. Resources shared by several recording threads must be transitioned
+    // before recording, see CreateCommandPool
+    bool automaticBarriers{};
+    // Barriers are recorded with vkCmdPipelineBarrier2KHR, every barrier waits only on the stages of its own states instead
+    // of the stages of all the barriers recorded with it. Falls back to vkCmdPipelineBarrier without VK_KHR_synchronization2
+    bool synchronization2{};
+    // Descriptors of every array of the bindless heap, 0 sizes each array to the initial capacity of its resource pool. Clamped
+    // to the pool max capacity and the device limits, resources whose index is past the end of their array have no bindless index
+    uint32_t bindlessHeapSize{};
+
+    // Per resource type pool capacities
+    DResourcePoolCapacity swapchainCapacity{ 4, 64 };
+    DResourcePoolCapacity vertexIndexBufferCapacity;
+    DResourcePoolCapacity uniformBufferCapacity;
+    DResourcePoolCapacity transferBufferCapacity;
+    DResourcePoolCapacity indirectBufferCapacity;
+    DResourcePoolCapacity imageCapacity;
+    DResourcePoolCapacity renderTargetCapacity;
+    DResourcePoolCapacity framebufferCapacity;
+    DResourcePoolCapacity shaderCapacity;
+    DResourcePoolCapacity vertexLayoutCapacity;
+    DResourcePoolCapacity pipelineCapacity;
+    DResourcePoolCapacity rootSignatureCapacity;
+    DResourcePoolCapacity descriptorSetCapacity;
+    DResourcePoolCapacity samplerCapacity;
+    DResourcePoolCapacity commandPoolCapacity;
+    DResourcePoolCapacity commandBufferCapacity;
+    DResourcePoolCapacity fenceCapacity;
+    DResourcePoolCapacity semaphoreCapacity;
+    DResourcePoolCapacity renderPassCapacity;
 };
 
 struct WindowData
@@ -132,17 +183,32 @@ enum class EVertexInputClassification
     PER_INSTANCE_DATA
 };
 
+enum class EIndexType
+{
+    UINT16,
+    UINT32
+};
+
+/*Attributes are read from vertex streams, each one bound to its own vertex buffer. By default per vertex attributes are read
+from VERTEX_STREAM and per instance ones from INSTANCE_STREAM, eg. positions can be split in a stream of their own for depth
+only passes. All the attributes of a stream must have the same classification*/
 struct VertexLayoutInfo
 {
+    static constexpr uint32_t MAX_STREAMS     = 4;
+    static constexpr uint32_t VERTEX_STREAM   = 0;
+    static constexpr uint32_t INSTANCE_STREAM = 1;
 
     const char*                Semantic;
     EFormat                    Format;
-    uint32_t                   ByteOffset;
+    uint32_t                   ByteOffset; // From the start of the element in its stream
     EVertexInputClassification Classification;
     uint32_t                   InstanceDataStepRate;
+    uint32_t                   Stream;
 
     VertexLayoutInfo(const char* semantic, EFormat format, uint32_t byteOffset, EVertexInputClassification classification, uint32_t instanceDataStepRate = 0)
-      : Semantic(semantic), Format(format), ByteOffset(byteOffset), Classification(classification), InstanceDataStepRate(instanceDataStepRate){};
+      : VertexLayoutInfo(semantic, format, byteOffset, classification, instanceDataStepRate, classification == EVertexInputClassification::PER_INSTANCE_DATA ? INSTANCE_STREAM : VERTEX_STREAM){};
+    VertexLayoutInfo(const char* semantic, EFormat format, uint32_t byteOffset, EVertexInputClassification classification, uint32_t instanceDataStepRate, uint32_t stream)
+      : Semantic(semantic), Format(format), ByteOffset(byteOffset), Classification(classification), InstanceDataStepRate(instanceDataStepRate), Stream(stream){};
 };
 
 enum class ETopology
@@ -398,7 +464,8 @@ enum class EShaderStage
 {
     VERTEX,
     FRAGMENT,
-    ALL
+    ALL, // All the graphics stages
+    COMPUTE
 };
 
 struct ShaderDescriptorBindings
@@ -476,9 +543,36 @@ class RIShaderDescriptorBindingsEqualFn
     }
 };
 
+/*Bytes of the push constant block the stage reads, offset and size are multiple of 4 and a stage is in one range only. The
+block must fit in the device push constant size, every device supports at least 128 bytes*/
+struct ShaderPushConstantRange
+{
+    EShaderStage Stage{};
+    uint32_t     Offset{};
+    uint32_t     Size{};
+};
+
+/*Bindings of the global bindless heap, an update-after-bind descriptor set with an array per binding. Images, samplers,
+uniform buffers and vertex/index buffers are written to it when they are created, at the stable index returned by
+GetBindlessIndex. The buffers are storage buffer descriptors. Descriptors of destroyed resources point to empty ones, the
+arrays are partially bound and must be indexed with nonuniformEXT if the index isn't uniform*/
+enum class EBindlessHeapBinding : uint32_t
+{
+    IMAGES = 0,
+    SAMPLERS,
+    UNIFORM_BUFFERS,
+    VERTEX_INDEX_BUFFERS,
+    MAX_COUNT
+};
+
 struct ShaderLayout
 {
+    static constexpr uint32_t BINDLESS_HEAP_SET = 0; // Set of the NEVER frequency
+
     std::map<uint32_t /*Set*/, std::map<uint32_t /*binding*/, ShaderDescriptorBindings>> SetsLayout;
+    std::vector<ShaderPushConstantRange>                                                 PushConstants;
+    // The heap takes BINDLESS_HEAP_SET and is bound with the pipelines, SetsLayout can't have it
+    bool BindlessHeap{};
 };
 
 struct ShaderByteCode
@@ -486,15 +580,18 @@ struct ShaderByteCode
     // Compiled shader raw binary data
     std::vector<unsigned char> VertexShader;
     std::vector<unsigned char> PixelShader;
+    std::vector<unsigned char> ComputeShader; // A compute shader has no other stage
 };
 
 struct ShaderSource
 {
-    ShaderByteCode      SourceCode;
-    VertexInputLayoutId VertexLayout{};
-    uint32_t            VertexStride{};
-    uint32_t            ColorAttachments{};
-    bool                DepthStencilAttachment{};
+    ShaderByteCode                                      SourceCode;
+    VertexInputLayoutId                                 VertexLayout{};
+    uint32_t                                            VertexStride{}; // Of VERTEX_STREAM
+    uint32_t                                            InstanceStride{}; // Of INSTANCE_STREAM
+    std::array<uint32_t, VertexLayoutInfo::MAX_STREAMS> StreamStrides{}; // Of every stream, when 0 the first two are VertexStride and InstanceStride
+    uint32_t                                            ColorAttachments{};
+    bool                                                DepthStencilAttachment{};
 };
 
 struct DFramebufferAttachments
@@ -505,6 +602,18 @@ struct DFramebufferAttachments
     uint32_t                              DepthStencil{};
 };
 
+/*Render target living only inside a frame. Render targets with the same AliasGroup share the same memory, they must not be
+used at the same time and their content is undefined at their first use*/
+struct DTransientRenderTargetDesc
+{
+    EFormat  Format{};
+    bool     IsDepth{};
+    uint32_t Width{};
+    uint32_t Height{};
+    uint32_t AliasGroup{};
+    bool     AttachmentOnly{}; // Never sampled, uses lazily allocated memory when available instead of an alias group
+};
+
 struct DPipelineAttachments
 {
     //@TODO USE RAW ARRAY
@@ -514,12 +623,12 @@ struct DPipelineAttachments
 
 struct DFramebufferAttachmentsHashFn
 {
-    size_t operator()(const DFramebufferAttachments& attachments)
+    size_t operator()(const DFramebufferAttachments& attachments) const
     {
-        size_t hash{};
+        size_t hash = std::hash<uint32_t>{}(attachments.DepthStencil);
         for (size_t i = 0; i < DFramebufferAttachments::MAX_ATTACHMENTS; i++)
             {
-                hash += std::hash<uint32_t>{}(attachments.RenderTargets[i]);
+                hash ^= std::hash<uint32_t>{}(attachments.RenderTargets[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
             }
         return hash;
     };
@@ -527,8 +636,12 @@ struct DFramebufferAttachmentsHashFn
 
 struct DFramebufferAttachmentEqualFn
 {
-    bool operator()(const DFramebufferAttachments& lhs, const DFramebufferAttachments& rhs)
+    bool operator()(const DFramebufferAttachments& lhs, const DFramebufferAttachments& rhs) const
     {
+        if (lhs.DepthStencil != rhs.DepthStencil)
+            {
+                return false;
+            }
 
         for (size_t i = 0; i < DFramebufferAttachments::MAX_ATTACHMENTS; i++)
             {
@@ -652,6 +765,8 @@ typedef struct TextureBarrier
     /// Following values are ignored if mSubresourceBarrier is false
     uint8_t  mMipLevel{};
     uint16_t mArrayLayer;
+    /// Last state of the resource previously using the same memory, its accesses are waited before the transition from UNDEFINED
+    EResourceState AliasedState{};
 } TextureBarrier;
 
 typedef struct RenderTargetBarrier
@@ -669,6 +784,8 @@ typedef struct RenderTargetBarrier
     /// Following values are ignored if mSubresourceBarrier is false
     uint8_t  mMipLevel{};
     uint16_t mArrayLayer{};
+    /// Last state of the resource previously using the same memory, its accesses are waited before the transition from UNDEFINED
+    EResourceState mAliasedState{};
 } RenderTargetBarrier;
 
 typedef struct DescriptorData
@@ -695,6 +812,31 @@ typedef struct DrawIndexedIndirectCommand
     uint32_t firstInstance{};
 } DrawIndexedIndirectCommand;
 
+typedef struct DispatchIndirectCommand
+{
+    uint32_t groupCountX{};
+    uint32_t groupCountY{};
+    uint32_t groupCountZ{};
+} DispatchIndirectCommand;
+
+/*Value of a timeline semaphore to wait for or to signal*/
+struct DTimelineValue
+{
+    uint32_t Semaphore{};
+    uint64_t Value{};
+};
+
+/*Calls skipped while recording a command buffer because the same state was already bound on it*/
+struct DRedundantStateCounters
+{
+    uint32_t Pipelines{};
+    uint32_t DescriptorSets{};
+    uint32_t VertexBuffers{};
+    uint32_t IndexBuffers{};
+    uint32_t Viewports{};
+    uint32_t Scissors{};
+};
+
 class IContext
 {
   public:
@@ -716,35 +858,90 @@ class IContext
     virtual uint32_t CreateShader(const ShaderSource& source)                                                                                               = 0;
     virtual void     DestroyShader(const uint32_t shader)                                                                                                   = 0;
     virtual uint32_t CreatePipeline(const uint32_t shader, uint32_t rootSignatureId, const DPipelineAttachments& attachments, const PipelineFormat& format) = 0;
+    /*The root signature of a compute pipeline has only compute stage bindings*/
+    virtual uint32_t CreateComputePipeline(const uint32_t shader, uint32_t rootSignatureId)                                                                 = 0;
     virtual void     DestroyPipeline(uint32_t pipelineId)                                                                                                   = 0;
     virtual uint32_t CreateRootSignature(const ShaderLayout& layout)                                                                                        = 0;
     virtual void     DestroyRootSignature(uint32_t rootSignatureId)                                                                                         = 0;
     virtual uint32_t CreateDescriptorSets(uint32_t rootSignatureId, EDescriptorFrequency frequency, uint32_t count)                                         = 0;
     virtual void     DestroyDescriptorSet(uint32_t descriptorSetId)                                                                                         = 0;
+    /*Updates are queued and applied together at the next BindDescriptorSet, BeginFrame or FlushDescriptorWrites, or before a
+    destroyed resource is released. A set can't be updated while a command buffer it's bound to is being recorded or executed.
+    An update made from another thread must be synchronized by the application before the bind that needs it, binding doesn't
+    lock when nothing is queued*/
     virtual void     UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex, uint32_t paramCount, DescriptorData* params)                          = 0;
+    /*Applies the queued descriptor set updates with a single vkUpdateDescriptorSets*/
+    virtual void     FlushDescriptorWrites()                                                                                                                = 0;
     virtual uint32_t CreateSampler(uint32_t minLod, uint32_t maxLod)                                                                                        = 0;
-
-    virtual uint32_t CreateCommandPool()                                                                                                                                            = 0;
-    virtual void     DestroyCommandPool(uint32_t commandPoolId)                                                                                                                     = 0;
-    virtual void     ResetCommandPool(uint32_t commandPoolId)                                                                                                                       = 0;
-    virtual uint32_t CreateCommandBuffer(uint32_t commandPoolId)                                                                                                                    = 0;
-    virtual void     DestroyCommandBuffer(uint32_t commandBufferId)                                                                                                                 = 0;
-    virtual void     BeginCommandBuffer(uint32_t commandBufferId)                                                                                                                   = 0;
-    virtual void     EndCommandBuffer(uint32_t commandBufferId)                                                                                                                     = 0;
-    virtual void     BindRenderTargets(uint32_t commandBufferId, const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP)                                             = 0;
-    virtual void     SetViewport(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float znear, float zfar)                                        = 0;
-    virtual void     SetScissor(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height)                                                                  = 0;
-    virtual void     BindPipeline(uint32_t commandBufferId, uint32_t pipeline)                                                                                                      = 0;
-    virtual void     BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId)                                                                                                  = 0;
-    virtual void     BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId)                                                                                                   = 0;
-    virtual void     Draw(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count)                                                                                           = 0;
-    virtual void     DrawIndexed(uint32_t commandBufferId, uint32_t index_count, uint32_t first_index, uint32_t first_vertex)                                                       = 0;
-    virtual void     DrawIndexedIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t drawCount, uint32_t stride)                                           = 0;
-    virtual void     BindDescriptorSet(uint32_t commandBufferId, uint32_t setIndex, uint32_t descriptorSetId)                                                                       = 0;
-    virtual void     CopyImage(uint32_t commandId, uint32_t imageId, uint32_t width, uint32_t height, uint32_t mipMapIndex, uint32_t stagingBufferId, uint32_t stagingBufferOffset) = 0;
+    /*Index of an image, sampler, uniform buffer or vertex/index buffer in its array of the bindless heap, stable for the lifetime of
+    the resource. A destroyed resource index is given to the next one of the same type. Draws usually pass the indices with
+    PushConstants instead of binding descriptor sets. Images read through the heap aren't transitioned by automaticBarriers. Fails
+    if the index is past the end of the heap array, see DContextConfig::bindlessHeapSize*/
+    virtual uint32_t GetBindlessIndex(uint32_t resourceId) const                                                                                            = 0;
+
+    /*Command buffers of a transfer or compute pool are submitted to the queue of a family dedicated to it if the device has one, to the
+    graphics queue otherwise.
+    Recording can be spread over several threads, each one with its own command pools: creating, resetting and destroying pools,
+    creating command buffers and recording them are thread-safe as long as a pool and its command buffers are used by one
+    thread at a time. The command buffers are merged by submitting them together in recording order from a single thread, which
+    also destroys command buffers and creates and destroys the other resources. Automatic barriers track the state of a
+    resource per context and are recorded in recording order, including the transitions made by BindRenderTargets,
+    BindDescriptorSet and CopyImage. A resource used by several threads at once, eg. a G-buffer rendered into or a texture
+    sampled by all of them, must already be in the state they use, transitioned explicitly before recording: its tracked state
+    is then only read. Changing its state from one thread while the others record is a data race*/
+    virtual uint32_t CreateCommandPool(EQueueType queueType = EQueueType::GRAPHICS)    = 0;
+    virtual void     DestroyCommandPool(uint32_t commandPoolId)                        = 0;
+    virtual void     ResetCommandPool(uint32_t commandPoolId)                          = 0;
+    virtual uint32_t CreateCommandBuffer(uint32_t commandPoolId)                       = 0;
+    virtual void     DestroyCommandBuffer(uint32_t commandBufferId)                    = 0;
+    virtual void     BeginCommandBuffer(uint32_t commandBufferId)                      = 0;
+    virtual void     EndCommandBuffer(uint32_t commandBufferId)                        = 0;
+    /*Managed command buffers, the calling thread gets them from its own command pool for the current frame in flight and queue type.
+    They are in the initial state and must be begun, ended and submitted before the next BeginFrame, they must not be destroyed.
+    The pool is reset when the thread acquires from it again frames in flight later, once the submissions of its frame completed*/
+    virtual uint32_t AcquireCommandBuffer(EQueueType queueType = EQueueType::GRAPHICS) = 0;
+    /*Starts a new frame of the managed command buffers, called by the submitting thread while no thread is acquiring them*/
+    virtual void     BeginFrame()                                                      = 0;
+
+    /*Binding a pipeline, descriptor set, vertex or index buffer, viewport or scissor already bound on the command buffer is skipped.
+    Counted from the beginning of the recording*/
+    virtual DRedundantStateCounters GetRedundantStateCounters(uint32_t commandBufferId) const = 0;
+
+    virtual void     BindRenderTargets(uint32_t commandBufferId, const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP)                                                       = 0;
+    virtual uint32_t CreateRenderPass(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP)                                                                                  = 0;
+    virtual void     DestroyRenderPass(uint32_t renderPassId)                                                                                                                                 = 0;
+    virtual void     BindRenderPass(uint32_t commandBufferId, uint32_t renderPassId)                                                                                                          = 0;
+    virtual void     SetViewport(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float znear, float zfar)                                                  = 0;
+    virtual void     SetScissor(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height)                                                                            = 0;
+    virtual void     BindPipeline(uint32_t commandBufferId, uint32_t pipeline)                                                                                                                = 0;
+    /*Offsets are in bytes from the start of the buffer, several meshes can share a buffer*/
+    virtual void     BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0)                                                                                       = 0;
+    /*Buffer of the PER_INSTANCE_DATA attributes read from INSTANCE_STREAM*/
+    virtual void     BindInstanceBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0)                                                                                     = 0;
+    /*Binds a buffer to each stream starting from firstStream, one offset per buffer*/
+    virtual void     BindVertexBuffers(uint32_t commandBufferId, uint32_t firstStream, std::span<const uint32_t> bufferIds, std::span<const uint64_t> offsets)                                = 0;
+    /*16 bit indices halve the memory of meshes with less than 65536 vertices, the offset must be a multiple of the index size*/
+    virtual void     BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0, EIndexType indexType = EIndexType::UINT32)                                             = 0;
+    virtual void     Draw(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count)                                                                                                     = 0;
+    virtual void     DrawIndexed(uint32_t commandBufferId, uint32_t index_count, uint32_t first_index, uint32_t first_vertex)                                                                 = 0;
+    virtual void     DrawInstanced(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count, uint32_t firstInstance, uint32_t instanceCount)                                            = 0;
+    virtual void     DrawIndexedInstanced(uint32_t commandBufferId, uint32_t indexCount, uint32_t firstIndex, uint32_t firstVertex, uint32_t firstInstance, uint32_t instanceCount)           = 0;
+    virtual void     DrawIndexedIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t drawCount, uint32_t stride)                                                     = 0;
+    /*The number of draws is read as a uint32_t from countBuffer at countOffset, clamped to maxDrawCount. Requires VK_KHR_draw_indirect_count*/
+    virtual void     DrawIndexedIndirectCount(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t countBuffer, uint32_t countOffset, uint32_t maxDrawCount, uint32_t stride) = 0;
+    virtual void     Dispatch(uint32_t commandBufferId, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)                                                                     = 0;
+    virtual void     DispatchIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset)                                                                                             = 0;
+    /*Writes the bytes of the push constant block of the bound pipeline the stage reads, they stay set until overwritten. The
+    ranges of the root signature overlapping the bytes must all be of that stage*/
+    virtual void     PushConstants(uint32_t commandBufferId, EShaderStage stage, uint32_t offset, uint32_t size, const void* data)                                                            = 0;
+    virtual void     BindDescriptorSet(uint32_t commandBufferId, uint32_t setIndex, uint32_t descriptorSetId)                                                                                 = 0;
+    virtual void     CopyImage(uint32_t commandId, uint32_t imageId, uint32_t width, uint32_t height, uint32_t mipMapIndex, uint32_t stagingBufferId, uint32_t stagingBufferOffset)           = 0;
 
     virtual uint32_t CreateRenderTarget(EFormat format, ESampleBit samples, bool isDepth, uint32_t width, uint32_t height, uint32_t arrayLength, uint32_t mipMapCount, EResourceState initialState) = 0;
     virtual void     DestroyRenderTarget(uint32_t renderTargetId)                                                                                                                                   = 0;
+    /*Release and Acquire barriers transfer the ownership of a resource to and from the queue of QueueType, both halves must have the
+    same states. The acquire is dropped when both queues are of the same family*/
+    virtual void     ResourceBarrier(uint32_t commandBufferId, std::span<const BufferBarrier> bufferBarriers, std::span<const TextureBarrier> textureBarriers, std::span<const RenderTargetBarrier> renderTargetBarriers) = 0;
     virtual void     ResourceBarrier(uint32_t commandBufferId,
         uint32_t                              buffer_barrier_count,
         BufferBarrier*                        p_buffer_barriers,
@@ -753,18 +950,51 @@ class IContext
         uint32_t                              rt_barrier_count,
         RenderTargetBarrier*                  p_rt_barriers)                                                                                                                                                         = 0;
 
+    /*Creates all the transient render targets of a frame at once, the memory of an alias group is sized for its largest render target.
+    Destroyed with DestroyRenderTarget, the memory of an alias group is released with its last render target once the work submitted
+    before its destruction completes*/
+    virtual void CreateTransientRenderTargets(uint32_t count, const DTransientRenderTargetDesc* descs, uint32_t* outRenderTargetIds) = 0;
+
     virtual uint32_t CreateFence(bool signaled)                                  = 0;
     virtual void     DestroyFence(uint32_t fenceId)                              = 0;
     virtual bool     IsFenceSignaled(uint32_t fenceId)                           = 0;
     virtual void     WaitForFence(uint32_t fenceId, uint64_t timeoutNanoseconds) = 0;
     virtual void     ResetFence(uint32_t fenceId)                                = 0;
 
+    /*Submitting and presenting don't allocate, the spans can point to the caller's own storage*/
+    virtual void QueueSubmit(std::span<const uint32_t> waitSemaphore,
+    std::span<const DTimelineValue>                   waitTimeline,
+    std::span<const uint32_t>                         finishSemaphore,
+    std::span<const DTimelineValue>                   signalTimeline,
+    std::span<const uint32_t>                         cmdIds,
+    uint32_t                                          fenceId)                                                     = 0;
+    virtual void QueuePresent(uint32_t swapchainId, uint32_t imageIndex, std::span<const uint32_t> waitSemaphore) = 0;
+
     virtual void QueueSubmit(const std::vector<uint32_t>& waitSemaphore, const std::vector<uint32_t>& finishSemaphore, const std::vector<uint32_t>& cmdIds, uint32_t fenceId) = 0;
-    virtual void QueuePresent(uint32_t swapchainId, uint32_t imageIndex, const std::vector<uint32_t>& waitSemaphore)                                                          = 0;
+    /*Waits for and signals timeline semaphore values along with the binary semaphores, eg. of the swapchain*/
+    virtual void QueueSubmit(const std::vector<uint32_t>& waitSemaphore,
+    const std::vector<DTimelineValue>&                   waitTimeline,
+    const std::vector<uint32_t>&                         finishSemaphore,
+    const std::vector<DTimelineValue>&                   signalTimeline,
+    const std::vector<uint32_t>&                         cmdIds)                                                     = 0;
+    virtual void QueuePresent(uint32_t swapchainId, uint32_t imageIndex, const std::vector<uint32_t>& waitSemaphore) = 0;
 
     virtual uint32_t CreateGpuSemaphore()                      = 0;
     virtual void     DestroyGpuSemaphore(uint32_t semaphoreId) = 0;
 
+    /*A timeline semaphore holds a counter that only increases, submissions signal it to a value and wait for it to reach a value.
+    The cpu can poll it and wait for a value without fences*/
+    virtual uint32_t CreateTimelineSemaphore(uint64_t initialValue)                                           = 0;
+    virtual void     DestroyTimelineSemaphore(uint32_t semaphoreId)                                           = 0;
+    /*Current value of the counter, doesn't block*/
+    virtual uint64_t GetTimelineSemaphoreValue(uint32_t semaphoreId)                                          = 0;
+    /*Returns false if the counter didn't reach the value before the timeout*/
+    virtual bool     WaitTimelineSemaphore(uint32_t semaphoreId, uint64_t value, uint64_t timeoutNanoseconds) = 0;
+    /*Signals the value from the cpu, it must be greater than the current one*/
+    virtual void     SignalTimelineSemaphore(uint32_t semaphoreId, uint64_t value)                            = 0;
+
+    /*Destroyed resources are released once the work submitted before their destruction completed, without blocking. Blocks until
+    all of them can be released*/
     virtual void FlushDeletedBuffers() = 0;
 
     virtual unsigned char* GetAdapterDescription() const          = 0;
@@ -0,0 +1,146 @@
+// Copyright RedFox Studio 2022
+
+#pragma once
+
+#include "IContext.h"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Fox
+{
+
+/*Declares the passes of a frame with the resources they read and write, then records them on a command buffer.
+Passes that don't contribute to an output are culled, the remaining ones are reordered to reduce state transitions
+without breaking their dependencies and the minimal set of barriers is emitted between them.
+Built on top of the IContext calls, a pass with attachments is bound with BindRenderTargets before its execute callback.
+Passes without attachments rely on the barriers before them to end a previous render pass.
+Transient render targets are created by the graph, the ones with non-overlapping lifetimes share the same memory*/
+class RenderGraph
+{
+  public:
+    using ExecuteFn = std::function<void(IContext* context, uint32_t commandBufferId)>;
+
+    struct DBarriers
+    {
+        std::vector<TextureBarrier>      TextureBarriers;
+        std::vector<RenderTargetBarrier> RenderTargetBarriers;
+    };
+
+    RenderGraph(IContext* context) : _context(context){};
+    ~RenderGraph();
+
+    /*Imported resources are owned by the caller, the graph transitions them from currentState and leaves them in finalState.
+    Passing UNDEFINED as finalState leaves the resource in the state of its last use*/
+    uint32_t ImportRenderTarget(uint32_t renderTargetId, EResourceState currentState, EResourceState finalState);
+    uint32_t ImportTexture(uint32_t imageId, EResourceState currentState, EResourceState finalState);
+    /*Render target that lives only between its first and last use in the frame, its content is undefined at its first use.
+    Render targets used only as attachments are never sampled and can be backed by lazily allocated memory*/
+    uint32_t CreateTransientRenderTarget(EFormat format, bool isDepth, uint32_t width, uint32_t height);
+    /*Passes contributing to an output resource are never culled*/
+    void MarkOutput(uint32_t resource);
+
+    uint32_t AddPass(const std::string& name, ExecuteFn&& execute);
+    void     AddRead(uint32_t pass, uint32_t resource, EResourceState state);
+    void     AddWrite(uint32_t pass, uint32_t resource, EResourceState state);
+    /*Attachments are written as RENDER_TARGET or DEPTH_WRITE and bound in declaration order*/
+    void AddColorAttachment(uint32_t pass, uint32_t resource, ERenderPassLoad load, ERenderPassStore store, DClearValue clear = {});
+    void AddDepthStencilAttachment(uint32_t pass, uint32_t resource, ERenderPassLoad load, ERenderPassStore store, DClearDepthStencilValue clear = {});
+    /*Pass is never culled, eg. writes to a buffer read back by the cpu*/
+    void SetSideEffect(uint32_t pass);
+
+    /*Culls, orders and computes the barriers of the declared passes*/
+    void Compile();
+    /*Records the compiled passes, must be called after Compile*/
+    void Execute(uint32_t commandBufferId);
+    /*Removes all passes and resources, to build the graph of the next frame. Transient render targets are kept and reused
+    by the next Compile if the frame needs the same ones, their first use waits for the last accesses of the previous frame*/
+    void Reset();
+    /*Destroys the transient render targets, their memory is released once the work submitted before completes. Compile does it
+    when the transient render targets of the frame change, eg. on resize*/
+    void ReleaseTransientRenderTargets();
+
+    const std::vector<uint32_t>& GetExecutionOrder() const { return _executionOrder; };
+    bool                         IsPassCulled(uint32_t pass) const { return _passes.at(pass).Culled; };
+    const DBarriers&             GetPassBarriers(uint32_t pass) const { return _passes.at(pass).Barriers; };
+    const DBarriers&             GetFinalBarriers() const { return _finalBarriers; };
+    /*Render target or image id of a resource, transient render targets have an id only after Compile*/
+    uint32_t GetResourceId(uint32_t resource) const { return _resources.at(resource).Id; };
+    /*Transient render targets with the same alias group share memory, NO_ALIAS_GROUP if culled away*/
+    static constexpr uint32_t NO_ALIAS_GROUP = 0xFFFFFFFF;
+    uint32_t                  GetAliasGroup(uint32_t resource) const { return _resources.at(resource).AliasGroup; };
+    uint32_t                  GetAliasGroupCount() const { return _aliasGroupCount; };
+
+  private:
+    static constexpr uint32_t NO_RESOURCE = 0xFFFFFFFF;
+
+    struct DGraphResource
+    {
+        uint32_t       Id{};
+        bool           IsRenderTarget{};
+        bool           IsOutput{};
+        EResourceState InitialState{};
+        EResourceState FinalState{};
+        // Transient render targets only
+        bool     IsTransient{};
+        EFormat  Format{};
+        bool     IsDepth{};
+        uint32_t Width{};
+        uint32_t Height{};
+        bool     AttachmentOnly{};
+        uint32_t AliasGroup{ NO_ALIAS_GROUP };
+        uint32_t AliasedAfter{ NO_RESOURCE }; // Previous resource using the same memory
+    };
+
+    struct DGraphAccess
+    {
+        uint32_t       Resource{};
+        EResourceState State{};
+        bool           Write{};
+        bool           Discard{}; // Previous content is overwritten, eg. cleared attachment
+    };
+
+    struct DGraphPass
+    {
+        std::string               Name;
+        ExecuteFn                 Execute;
+        std::vector<DGraphAccess> Accesses;
+        DFramebufferAttachments   Attachments;
+        DLoadOpPass               LoadOp{};
+        uint32_t                  ColorAttachmentCount{};
+        bool                      HasAttachments{};
+        bool                      SideEffect{};
+        bool                      Culled{};
+        DBarriers                 Barriers;
+        // Resource indices of the attachments, resolved to ids in Attachments when compiling
+        std::array<uint32_t, DFramebufferAttachments::MAX_ATTACHMENTS> ColorResources{};
+        uint32_t                                                      DepthStencilResource{};
+        bool                                                          HasDepthStencil{};
+    };
+
+    IContext*                   _context{};
+    std::vector<DGraphResource> _resources;
+    std::vector<DGraphPass>     _passes;
+    std::vector<uint32_t>       _executionOrder;
+    DBarriers                   _finalBarriers;
+    bool                        _compiled{};
+    uint32_t                    _aliasGroupCount{};
+    /*Transient render targets created by the last Compile, reused while the frame needs the same ones*/
+    std::vector<DTransientRenderTargetDesc> _transientDescs;
+    std::vector<uint32_t>                   _transientIds;
+    /*State each alias group memory is left in by the last compiled frame, the first use in the next frame waits for it*/
+    std::vector<EResourceState>             _transientLastStates;
+
+    void _addAccess(uint32_t pass, uint32_t resource, EResourceState state, bool write, bool discard);
+    void _cullPasses();
+    void _orderPasses();
+    void _aliasTransients();
+    void _createTransients();
+    void _resolveAttachments();
+    void _computeBarriers();
+    bool _dependsOn(const DGraphPass& pass, const DGraphPass& previous) const;
+    void _addBarrier(DBarriers& barriers, uint32_t resource, EResourceState currentState, EResourceState newState, EResourceState aliasedState = EResourceState::UNDEFINED);
+};
+}
@@ -0,0 +1,183 @@
+// Copyright RedFox Studio 2022
+
+#pragma once
+
+#include "asserts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+namespace Fox
+{
+
+/*Growable table of resources allocated in chunks, elements never move in memory once created.
+Has an O(1) free list, released slots are reused in LIFO order. Retired slots are quarantined in FIFO order and handed out
+again, oldest first, only when there's no free slot and the table can't grow anymore.
+Allocate and Release can be called from any thread, the chunk list is reserved up front so accessing an allocated slot
+never takes the lock*/
+template<class T, size_t chunkSize = 64>
+class RIResourceTable
+{
+  public:
+    template<class TableType, class ValueType>
+    class TIterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ValueType;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ValueType*;
+        using reference         = ValueType&;
+
+        TIterator() = default;
+        TIterator(TableType* table, size_t index) : _table(table), _index(index) {}
+
+        reference operator*() const { return _table->at(_index); }
+        pointer   operator->() const { return &_table->at(_index); }
+        TIterator& operator++()
+        {
+            _index++;
+            return *this;
+        }
+        TIterator operator++(int)
+        {
+            TIterator it = *this;
+            _index++;
+            return it;
+        }
+        bool   operator==(const TIterator& other) const { return _index == other._index; }
+        bool   operator!=(const TIterator& other) const { return _index != other._index; }
+        size_t Index() const { return _index; }
+
+      private:
+        TableType* _table{};
+        size_t     _index{};
+    };
+
+    using Iterator      = TIterator<RIResourceTable, T>;
+    using ConstIterator = TIterator<const RIResourceTable, const T>;
+
+    /*Allocates the initial chunks, the table will never grow above maxCapacity slots*/
+    void Initialize(size_t initialCapacity, size_t maxCapacity)
+    {
+        check(_chunks.empty()); // Must be initialized only once
+        check(initialCapacity <= maxCapacity);
+        _maxCapacity = maxCapacity;
+        _chunks.reserve((maxCapacity + chunkSize - 1) / chunkSize);
+        while (_capacity < initialCapacity)
+            {
+                _grow();
+            }
+    }
+
+    /*Returns the index of a free slot, grows the table if needed. At max capacity the oldest retired slot is reused, throws if
+    there's none*/
+    size_t Allocate()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_freeList.empty())
+            {
+                if (_capacity >= _maxCapacity)
+                    {
+                        if (_retired.empty())
+                            {
+                                throw std::runtime_error("Failed to allocate!");
+                            }
+                        const size_t index = _retired.front();
+                        _retired.pop_front();
+                        return index;
+                    }
+                _grow();
+            }
+        const size_t index = _freeList.back();
+        _freeList.pop_back();
+        return index;
+    }
+
+    /*Gives back the slot, the next Allocate will return it*/
+    void Release(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        check(index < _capacity);
+        check(_freeList.size() + _retired.size() < _capacity); // Released more slots than allocated
+        _freeList.push_back((uint32_t)index);
+    }
+
+    /*Gives back a slot that can't be reused safely, it's reused only once the table is full and every slot retired before it
+    has been reused*/
+    void Retire(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        check(index < _capacity);
+        check(_freeList.size() + _retired.size() < _capacity); // Released more slots than allocated
+        _retired.push_back((uint32_t)index);
+    }
+
+    size_t FreeCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _freeList.size();
+    }
+    size_t RetiredCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _retired.size();
+    }
+    size_t MaxCapacity() const { return _maxCapacity; }
+
+    T& at(size_t index)
+    {
+        check(index < _capacity);
+        return _chunks[index / chunkSize][index % chunkSize];
+    }
+    const T& at(size_t index) const
+    {
+        check(index < _capacity);
+        return _chunks[index / chunkSize][index % chunkSize];
+    }
+    T&       operator[](size_t index) { return _chunks[index / chunkSize][index % chunkSize]; }
+    const T& operator[](size_t index) const { return _chunks[index / chunkSize][index % chunkSize]; }
+
+    /*Number of slots currently backed by memory*/
+    size_t size() const { return _capacity; }
+
+    Iterator      begin() { return Iterator(this, 0); }
+    Iterator      end() { return Iterator(this, _capacity); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, _capacity); }
+
+  private:
+    std::vector<std::unique_ptr<T[]>> _chunks;
+    std::vector<uint32_t>             _freeList;
+    std::atomic<size_t>               _capacity{};
+    size_t                            _maxCapacity{};
+    std::deque<uint32_t>              _retired;
+    mutable std::mutex                _mutex;
+
+    void _grow()
+    {
+        const size_t first = _capacity;
+        const size_t last  = std::min(first + chunkSize, _maxCapacity);
+        check(last > first);
+
+        // Never reallocates, the size was reserved at initialization
+        check(_chunks.size() < _chunks.capacity());
+        _chunks.emplace_back(std::make_unique<T[]>(chunkSize));
+        _capacity = last;
+
+        // Lowest indices are on top of the stack so allocations are contiguous
+        _freeList.reserve(_freeList.size() + (last - first));
+        for (size_t i = last; i > first; i--)
+            {
+                _freeList.push_back((uint32_t)(i - 1));
+            }
+    }
+};
+}
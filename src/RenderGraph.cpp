@@ -0,0 +1,558 @@
+// Copyright RedFox Studio 2022
+
+#include "RenderGraph.h"
+
+#include "asserts.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Fox
+{
+
+RenderGraph::~RenderGraph()
+{
+    ReleaseTransientRenderTargets();
+}
+
+uint32_t
+RenderGraph::ImportRenderTarget(uint32_t renderTargetId, EResourceState currentState, EResourceState finalState)
+{
+    check(renderTargetId != 0);
+    DGraphResource resource;
+    resource.Id             = renderTargetId;
+    resource.IsRenderTarget = true;
+    resource.InitialState   = currentState;
+    resource.FinalState     = finalState;
+    _resources.emplace_back(std::move(resource));
+    return (uint32_t)_resources.size() - 1;
+}
+
+uint32_t
+RenderGraph::ImportTexture(uint32_t imageId, EResourceState currentState, EResourceState finalState)
+{
+    check(imageId != 0);
+    DGraphResource resource;
+    resource.Id           = imageId;
+    resource.InitialState = currentState;
+    resource.FinalState   = finalState;
+    _resources.emplace_back(std::move(resource));
+    return (uint32_t)_resources.size() - 1;
+}
+
+uint32_t
+RenderGraph::CreateTransientRenderTarget(EFormat format, bool isDepth, uint32_t width, uint32_t height)
+{
+    DGraphResource resource;
+    resource.IsRenderTarget = true;
+    resource.InitialState   = EResourceState::UNDEFINED;
+    resource.FinalState     = EResourceState::UNDEFINED;
+    resource.IsTransient    = true;
+    resource.Format         = format;
+    resource.IsDepth        = isDepth;
+    resource.Width          = width;
+    resource.Height         = height;
+    resource.AttachmentOnly = true; // Until it's accessed outside of a render pass
+    _resources.emplace_back(std::move(resource));
+    return (uint32_t)_resources.size() - 1;
+}
+
+void
+RenderGraph::MarkOutput(uint32_t resource)
+{
+    _resources.at(resource).IsOutput = true;
+}
+
+uint32_t
+RenderGraph::AddPass(const std::string& name, ExecuteFn&& execute)
+{
+    DGraphPass pass;
+    pass.Name    = name;
+    pass.Execute = std::move(execute);
+    _passes.emplace_back(std::move(pass));
+    _compiled = false;
+    return (uint32_t)_passes.size() - 1;
+}
+
+void
+RenderGraph::AddRead(uint32_t pass, uint32_t resource, EResourceState state)
+{
+    _resources.at(resource).AttachmentOnly = false;
+    _addAccess(pass, resource, state, false, false);
+}
+
+void
+RenderGraph::AddWrite(uint32_t pass, uint32_t resource, EResourceState state)
+{
+    _resources.at(resource).AttachmentOnly = false;
+    _addAccess(pass, resource, state, true, false);
+}
+
+void
+RenderGraph::AddColorAttachment(uint32_t pass, uint32_t resource, ERenderPassLoad load, ERenderPassStore store, DClearValue clear)
+{
+    auto& passRef = _passes.at(pass);
+    check(_resources.at(resource).IsRenderTarget); // Only render targets can be attached
+    critical(passRef.ColorAttachmentCount < DFramebufferAttachments::MAX_ATTACHMENTS);
+
+    const auto index                         = passRef.ColorAttachmentCount++;
+    passRef.ColorResources[index]           = resource;
+    passRef.LoadOp.LoadColor[index]         = load;
+    passRef.LoadOp.StoreActionsColor[index] = store;
+    passRef.LoadOp.ClearColor[index]        = clear;
+    passRef.HasAttachments                  = true;
+
+    _addAccess(pass, resource, EResourceState::RENDER_TARGET, true, load == ERenderPassLoad::Clear);
+}
+
+void
+RenderGraph::AddDepthStencilAttachment(uint32_t pass, uint32_t resource, ERenderPassLoad load, ERenderPassStore store, DClearDepthStencilValue clear)
+{
+    auto& passRef = _passes.at(pass);
+    check(_resources.at(resource).IsRenderTarget); // Only render targets can be attached
+    check(!passRef.HasDepthStencil); // Only one depth stencil attachment
+
+    passRef.DepthStencilResource     = resource;
+    passRef.HasDepthStencil          = true;
+    passRef.LoadOp.LoadDepth         = load;
+    passRef.LoadOp.StoreDepth        = store;
+    passRef.LoadOp.LoadStencil       = load;
+    passRef.LoadOp.StoreStencil      = store;
+    passRef.LoadOp.ClearDepthStencil = clear;
+    passRef.HasAttachments           = true;
+
+    _addAccess(pass, resource, EResourceState::DEPTH_WRITE, true, load == ERenderPassLoad::Clear);
+}
+
+void
+RenderGraph::SetSideEffect(uint32_t pass)
+{
+    _passes.at(pass).SideEffect = true;
+}
+
+void
+RenderGraph::Compile()
+{
+    _cullPasses();
+    _orderPasses();
+    _aliasTransients();
+    // Without a context the graph is only compiled, transient render targets can't be created
+    if (_context)
+        {
+            _createTransients();
+        }
+    _resolveAttachments();
+    _computeBarriers();
+    _compiled = true;
+}
+
+void
+RenderGraph::Execute(uint32_t commandBufferId)
+{
+    check(_context);
+    check(_compiled); // Must call Compile first
+
+    for (const auto passIndex : _executionOrder)
+        {
+            auto& passRef = _passes[passIndex];
+
+            auto& barriers = passRef.Barriers;
+            if (barriers.TextureBarriers.size() > 0 || barriers.RenderTargetBarriers.size() > 0)
+                {
+                    _context->ResourceBarrier(commandBufferId,
+                    0,
+                    nullptr,
+                    (uint32_t)barriers.TextureBarriers.size(),
+                    barriers.TextureBarriers.data(),
+                    (uint32_t)barriers.RenderTargetBarriers.size(),
+                    barriers.RenderTargetBarriers.data());
+                }
+
+            if (passRef.HasAttachments)
+                {
+                    _context->BindRenderTargets(commandBufferId, passRef.Attachments, passRef.LoadOp);
+                }
+
+            if (passRef.Execute)
+                {
+                    passRef.Execute(_context, commandBufferId);
+                }
+        }
+
+    if (_finalBarriers.TextureBarriers.size() > 0 || _finalBarriers.RenderTargetBarriers.size() > 0)
+        {
+            _context->ResourceBarrier(commandBufferId,
+            0,
+            nullptr,
+            (uint32_t)_finalBarriers.TextureBarriers.size(),
+            _finalBarriers.TextureBarriers.data(),
+            (uint32_t)_finalBarriers.RenderTargetBarriers.size(),
+            _finalBarriers.RenderTargetBarriers.data());
+        }
+}
+
+void
+RenderGraph::Reset()
+{
+    _resources.clear();
+    _passes.clear();
+    _executionOrder.clear();
+    _finalBarriers.TextureBarriers.clear();
+    _finalBarriers.RenderTargetBarriers.clear();
+    _compiled        = false;
+    _aliasGroupCount = 0;
+}
+
+void
+RenderGraph::ReleaseTransientRenderTargets()
+{
+    for (const auto renderTargetId : _transientIds)
+        {
+            _context->DestroyRenderTarget(renderTargetId);
+        }
+    _transientIds.clear();
+    _transientDescs.clear();
+    _transientLastStates.clear();
+}
+
+void
+RenderGraph::_addAccess(uint32_t pass, uint32_t resource, EResourceState state, bool write, bool discard)
+{
+    check(resource < _resources.size());
+    auto& accesses = _passes.at(pass).Accesses;
+
+    // A pass accesses a resource in a single state, merge read and write of the same resource
+    auto it = std::find_if(accesses.begin(), accesses.end(), [resource](const DGraphAccess& access) { return access.Resource == resource; });
+    if (it != accesses.end())
+        {
+            check(it->State == state); // Can't use the same resource in two different states inside a pass
+            it->Write   = it->Write || write;
+            it->Discard = it->Discard && discard;
+            return;
+        }
+
+    DGraphAccess access;
+    access.Resource = resource;
+    access.State    = state;
+    access.Write    = write;
+    access.Discard  = discard;
+    accesses.emplace_back(std::move(access));
+    _compiled = false;
+}
+
+void
+RenderGraph::_cullPasses()
+{
+    // Walk backward from the outputs, a pass is needed if it writes a resource that is read afterwards
+    std::vector<bool> needed(_resources.size());
+    for (size_t i = 0; i < _resources.size(); i++)
+        {
+            needed[i] = _resources[i].IsOutput;
+        }
+
+    for (size_t i = _passes.size(); i > 0; i--)
+        {
+            auto& passRef = _passes[i - 1];
+
+            const bool writesNeeded = std::any_of(passRef.Accesses.begin(), passRef.Accesses.end(), [&needed](const DGraphAccess& access) { return access.Write && needed[access.Resource]; });
+            passRef.Culled          = !passRef.SideEffect && !writesNeeded;
+            if (passRef.Culled)
+                continue;
+
+            // Content written before a discarding write is never observed by this pass
+            for (const auto& access : passRef.Accesses)
+                {
+                    needed[access.Resource] = !access.Discard;
+                }
+        }
+}
+
+bool
+RenderGraph::_dependsOn(const DGraphPass& pass, const DGraphPass& previous) const
+{
+    for (const auto& access : pass.Accesses)
+        {
+            for (const auto& previousAccess : previous.Accesses)
+                {
+                    if (access.Resource == previousAccess.Resource && (access.Write || previousAccess.Write))
+                        {
+                            return true;
+                        }
+                }
+        }
+    return false;
+}
+
+void
+RenderGraph::_orderPasses()
+{
+    _executionOrder.clear();
+
+    std::vector<uint32_t> pending;
+    for (uint32_t i = 0; i < (uint32_t)_passes.size(); i++)
+        {
+            if (!_passes[i].Culled)
+                {
+                    pending.push_back(i);
+                }
+        }
+
+    std::vector<EResourceState> states(_resources.size());
+    for (size_t i = 0; i < _resources.size(); i++)
+        {
+            states[i] = _resources[i].InitialState;
+        }
+
+    // Greedy topological sort, among the passes whose dependencies have been scheduled pick the one needing less
+    // transitions. Pending is kept in declaration order so ties keep the declaration order
+    while (pending.size() > 0)
+        {
+            size_t   best{};
+            uint32_t bestCost = std::numeric_limits<uint32_t>::max();
+            for (size_t i = 0; i < pending.size(); i++)
+                {
+                    const auto& passRef = _passes[pending[i]];
+
+                    bool ready = true;
+                    for (size_t j = 0; j < i && ready; j++)
+                        {
+                            ready = !_dependsOn(passRef, _passes[pending[j]]);
+                        }
+                    if (!ready)
+                        continue;
+
+                    const auto cost = (uint32_t)std::count_if(passRef.Accesses.begin(), passRef.Accesses.end(), [&states](const DGraphAccess& access) { return states[access.Resource] != access.State; });
+                    if (cost < bestCost)
+                        {
+                            best     = i;
+                            bestCost = cost;
+                        }
+                }
+
+            const auto passIndex = pending[best];
+            for (const auto& access : _passes[passIndex].Accesses)
+                {
+                    states[access.Resource] = access.State;
+                }
+            _executionOrder.push_back(passIndex);
+            pending.erase(pending.begin() + best);
+        }
+}
+
+void
+RenderGraph::_aliasTransients()
+{
+    constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+    // The lifetime of a transient render target goes from its first to its last use in the execution order
+    std::vector<uint32_t> firstUse(_resources.size(), unused);
+    std::vector<uint32_t> lastUse(_resources.size());
+    for (uint32_t i = 0; i < (uint32_t)_executionOrder.size(); i++)
+        {
+            for (const auto& access : _passes[_executionOrder[i]].Accesses)
+                {
+                    firstUse[access.Resource] = std::min(firstUse[access.Resource], i);
+                    lastUse[access.Resource]  = i;
+                }
+        }
+
+    std::vector<uint32_t> transients;
+    for (uint32_t i = 0; i < (uint32_t)_resources.size(); i++)
+        {
+            auto& resourceRef        = _resources[i];
+            resourceRef.AliasGroup   = NO_ALIAS_GROUP;
+            resourceRef.AliasedAfter = NO_RESOURCE;
+            if (resourceRef.IsTransient && firstUse[i] != unused)
+                {
+                    transients.push_back(i);
+                }
+        }
+    std::stable_sort(transients.begin(), transients.end(), [&firstUse](uint32_t lhs, uint32_t rhs) { return firstUse[lhs] < firstUse[rhs]; });
+
+    // Each render target takes the memory of an alias group whose last user is done, preferring one with the same size
+    // because the memory of a group is as large as its largest render target
+    std::vector<uint32_t> groupLastResource;
+    for (const auto resource : transients)
+        {
+            auto&  resourceRef = _resources[resource];
+            size_t best        = groupLastResource.size();
+            for (size_t i = 0; i < groupLastResource.size(); i++)
+                {
+                    const auto& lastRef = _resources[groupLastResource[i]];
+                    if (lastUse[groupLastResource[i]] >= firstUse[resource])
+                        continue;
+
+                    const bool sameSize = lastRef.Width == resourceRef.Width && lastRef.Height == resourceRef.Height && lastRef.Format == resourceRef.Format;
+                    if (best == groupLastResource.size() || sameSize)
+                        {
+                            best = i;
+                        }
+                    if (sameSize)
+                        break;
+                }
+
+            if (best == groupLastResource.size())
+                {
+                    groupLastResource.push_back(resource);
+                }
+            else
+                {
+                    resourceRef.AliasedAfter = groupLastResource[best];
+                    groupLastResource[best]  = resource;
+                }
+            resourceRef.AliasGroup = (uint32_t)best;
+        }
+    _aliasGroupCount = (uint32_t)groupLastResource.size();
+}
+
+void
+RenderGraph::_createTransients()
+{
+    std::vector<DTransientRenderTargetDesc> descs;
+    std::vector<uint32_t>                   resources;
+    for (uint32_t i = 0; i < (uint32_t)_resources.size(); i++)
+        {
+            const auto& resourceRef = _resources[i];
+            if (resourceRef.AliasGroup == NO_ALIAS_GROUP)
+                continue;
+
+            DTransientRenderTargetDesc desc;
+            desc.Format         = resourceRef.Format;
+            desc.IsDepth        = resourceRef.IsDepth;
+            desc.Width          = resourceRef.Width;
+            desc.Height         = resourceRef.Height;
+            desc.AliasGroup     = resourceRef.AliasGroup;
+            desc.AttachmentOnly = resourceRef.AttachmentOnly;
+            descs.emplace_back(std::move(desc));
+            resources.push_back(i);
+        }
+
+    // Frames usually need the same transient render targets, recreate them only when something changes
+    const auto equalFn = [](const DTransientRenderTargetDesc& lhs, const DTransientRenderTargetDesc& rhs) {
+        return lhs.Format == rhs.Format && lhs.IsDepth == rhs.IsDepth && lhs.Width == rhs.Width && lhs.Height == rhs.Height && lhs.AliasGroup == rhs.AliasGroup &&
+        lhs.AttachmentOnly == rhs.AttachmentOnly;
+    };
+    if (descs.size() != _transientDescs.size() || !std::equal(descs.begin(), descs.end(), _transientDescs.begin(), equalFn))
+        {
+            ReleaseTransientRenderTargets();
+            _transientIds.resize(descs.size());
+            if (descs.size() > 0)
+                {
+                    _context->CreateTransientRenderTargets((uint32_t)descs.size(), descs.data(), _transientIds.data());
+                }
+            _transientDescs = std::move(descs);
+        }
+
+    for (size_t i = 0; i < resources.size(); i++)
+        {
+            _resources[resources[i]].Id = _transientIds[i];
+        }
+}
+
+void
+RenderGraph::_resolveAttachments()
+{
+    for (auto& passRef : _passes)
+        {
+            for (uint32_t i = 0; i < passRef.ColorAttachmentCount; i++)
+                {
+                    passRef.Attachments.RenderTargets[i] = _resources[passRef.ColorResources[i]].Id;
+                }
+            if (passRef.HasDepthStencil)
+                {
+                    passRef.Attachments.DepthStencil = _resources[passRef.DepthStencilResource].Id;
+                }
+        }
+}
+
+void
+RenderGraph::_computeBarriers()
+{
+    std::vector<EResourceState> states(_resources.size());
+    std::vector<bool>           written(_resources.size());
+    std::vector<bool>           used(_resources.size());
+    std::vector<EResourceState> groupStates(_aliasGroupCount);
+    for (size_t i = 0; i < _resources.size(); i++)
+        {
+            states[i] = _resources[i].InitialState;
+        }
+
+    for (auto& passRef : _passes)
+        {
+            passRef.Barriers.TextureBarriers.clear();
+            passRef.Barriers.RenderTargetBarriers.clear();
+        }
+
+    for (const auto passIndex : _executionOrder)
+        {
+            auto& passRef = _passes[passIndex];
+            for (const auto& access : passRef.Accesses)
+                {
+                    // Aliased memory, the first use must wait for the last accesses of the previous render target of the alias group.
+                    // The first render target of a group waits for the last accesses of the group in the previous frame, that might
+                    // still be executing
+                    const auto&    resourceRef  = _resources[access.Resource];
+                    EResourceState aliasedState = EResourceState::UNDEFINED;
+                    if (!used[access.Resource] && resourceRef.AliasedAfter != NO_RESOURCE)
+                        {
+                            aliasedState = states[resourceRef.AliasedAfter];
+                        }
+                    else if (!used[access.Resource] && resourceRef.AliasGroup < _transientLastStates.size())
+                        {
+                            aliasedState = _transientLastStates[resourceRef.AliasGroup];
+                        }
+                    used[access.Resource] = true;
+                    if (resourceRef.AliasGroup != NO_ALIAS_GROUP)
+                        {
+                            groupStates[resourceRef.AliasGroup] = access.State;
+                        }
+
+                    const auto current = states[access.Resource];
+                    // Unordered access to unordered access needs a barrier only if one of the two writes
+                    const bool unorderedHazard = current == EResourceState::UNORDERED_ACCESS && access.State == EResourceState::UNORDERED_ACCESS && (access.Write || written[access.Resource]);
+                    if (current != access.State || unorderedHazard || aliasedState != EResourceState::UNDEFINED)
+                        {
+                            _addBarrier(passRef.Barriers, access.Resource, current, access.State, aliasedState);
+                        }
+                    states[access.Resource]  = access.State;
+                    written[access.Resource] = access.Write;
+                }
+        }
+    _transientLastStates = std::move(groupStates);
+
+    _finalBarriers.TextureBarriers.clear();
+    _finalBarriers.RenderTargetBarriers.clear();
+    for (uint32_t i = 0; i < (uint32_t)_resources.size(); i++)
+        {
+            const auto finalState = _resources[i].FinalState;
+            if (finalState != EResourceState::UNDEFINED && states[i] != finalState)
+                {
+                    _addBarrier(_finalBarriers, i, states[i], finalState);
+                }
+        }
+}
+
+void
+RenderGraph::_addBarrier(DBarriers& barriers, uint32_t resource, EResourceState currentState, EResourceState newState, EResourceState aliasedState)
+{
+    const auto& resourceRef = _resources[resource];
+    if (resourceRef.IsRenderTarget)
+        {
+            RenderTargetBarrier barrier{};
+            barrier.RenderTarget  = resourceRef.Id;
+            barrier.mCurrentState = currentState;
+            barrier.mNewState     = newState;
+            barrier.mAliasedState = aliasedState;
+            barriers.RenderTargetBarriers.emplace_back(std::move(barrier));
+        }
+    else
+        {
+            TextureBarrier barrier{};
+            barrier.ImageId      = resourceRef.Id;
+            barrier.CurrentState = currentState;
+            barrier.NewState     = newState;
+            barrier.AliasedState = aliasedState;
+            barriers.TextureBarriers.emplace_back(std::move(barrier));
+        }
+}
+}
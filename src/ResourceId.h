@@ -7,38 +7,38 @@
 namespace Fox
 {
 
-struct Id_T
-{
-    uint8_t  First;
-    uint8_t  Second;
-    uint16_t Value;
-};
-
-union IdType
-{
-    Id_T     Decompose;
-    uint32_t Value;
-};
-
+/*32 bits handle: 5 bits resource type | 11 bits slot generation | 16 bits slot index.
+Generation is never 0 so a valid handle is never 0, a slot whose generation reached MAX_GENERATION is retired instead of
+reused otherwise a stale handle would match the next occupant. Retired slots wrap around only when their pool is full*/
 class ResourceId
 {
   public:
-    ResourceId(uint32_t id) { _data.Value = id; };
-    ResourceId(uint8_t first, uint8_t second, uint16_t value)
+    static constexpr uint32_t TYPE_BITS       = 5;
+    static constexpr uint32_t GENERATION_BITS = 11;
+    static constexpr uint32_t INDEX_BITS      = 16;
+    static constexpr uint32_t MAX_TYPE        = (1u << TYPE_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION  = (1u << GENERATION_BITS) - 1;
+    static constexpr uint32_t MAX_INDEX       = (1u << INDEX_BITS) - 1;
+
+    ResourceId(uint32_t id) : _data(id){};
+    ResourceId(uint8_t first, uint16_t second, uint16_t value)
     {
-        _data.Decompose.First  = first;
-        _data.Decompose.Second = second;
-        _data.Decompose.Value  = value;
+        _data = ((uint32_t)first & MAX_TYPE) | (((uint32_t)second & MAX_GENERATION) << TYPE_BITS) | ((uint32_t)value << (TYPE_BITS + GENERATION_BITS));
     };
 
-    uint16_t Value() const { return _data.Decompose.Value; };
+    uint16_t Value() const { return (uint16_t)(_data >> (TYPE_BITS + GENERATION_BITS)); };
+
+    uint16_t First() const { return (uint16_t)(_data & MAX_TYPE); };
+    uint16_t Second() const { return (uint16_t)((_data >> TYPE_BITS) & MAX_GENERATION); };
 
-    uint16_t First() const { return _data.Decompose.First; };
-    uint16_t Second() const { return _data.Decompose.Second; };
+    uint32_t operator*() const { return _data; };
 
-    uint32_t operator*() const { return _data.Value; };
+    /*Returns the generation that follows the given one, wraps around skipping 0*/
+    static uint16_t NextGeneration(uint16_t generation) { return (uint16_t)(generation % MAX_GENERATION + 1); };
+    /*Returns true if a slot with this generation can't be reused without its handles aliasing older ones*/
+    static bool IsLastGeneration(uint16_t generation) { return generation >= MAX_GENERATION; };
 
   private:
-    IdType _data;
+    uint32_t _data;
 };
-}
\ No newline at end of file
+}
@@ -190,8 +190,10 @@ CResourceTransfer::BlitMipMap_DEPRECATED(VkImage src, VkImage destination, VkExt
 }
 
 void
-CResourceTransfer::CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, VkExtent2D extent, uint32_t mipIndex)
+CResourceTransfer::CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, VkExtent2D extent, uint32_t mipIndex, VkImageLayout currentLayout)
 {
+    const VkImageLayout finalLayout = currentLayout == VK_IMAGE_LAYOUT_UNDEFINED ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : currentLayout;
+
     VkBufferImageCopy region{};
     {
         region.bufferOffset      = 0;
@@ -210,7 +212,7 @@ CResourceTransfer::CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, V
     VkImageMemoryBarrier barrierTransfer{};
     {
         barrierTransfer.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrierTransfer.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrierTransfer.oldLayout                       = currentLayout;
         barrierTransfer.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         barrierTransfer.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
         barrierTransfer.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
@@ -231,7 +233,7 @@ CResourceTransfer::CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, V
     {
         barrierSampler.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrierSampler.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrierSampler.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrierSampler.newLayout                       = finalLayout;
         barrierSampler.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
         barrierSampler.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
         barrierSampler.image                           = sourceImage;
@@ -18,7 +18,8 @@ class CResourceTransfer
     void CopyMipMap(VkBuffer sourceBuffer, VkImage destination, VkExtent2D extent, uint32_t mipIndex, uint32_t internalOffset, size_t sourceOffset);
     void CopyBuffer(VkBuffer sourceBuffer, VkBuffer destination, size_t length, size_t beginOffset = 0);
     void BlitMipMap_DEPRECATED(VkImage src, VkImage destination, VkExtent2D extent, uint32_t mipIndex);
-    void CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, VkExtent2D extent, uint32_t mipIndex);
+    /*The image is left in currentLayout, an undefined current layout discards the content and leaves it shader read only*/
+    void CopyImageToBuffer(VkBuffer destBuffer, VkImage sourceImage, VkExtent2D extent, uint32_t mipIndex, VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED);
     void FinishCommandBuffer();
 
   private:
@@ -9,7 +9,9 @@
 #include <volk.h>
 
 #include <algorithm>
+#include <array>
 #include <iterator>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -256,6 +258,93 @@ convertAttachmentStoreOp(const Fox::ERenderPassStore store)
     return VK_ATTACHMENT_STORE_OP_STORE;
 }
 
+inline VkIndexType
+convertIndexType(const Fox::EIndexType indexType)
+{
+    switch (indexType)
+        {
+            case Fox::EIndexType::UINT16:
+                return VK_INDEX_TYPE_UINT16;
+            case Fox::EIndexType::UINT32:
+                return VK_INDEX_TYPE_UINT32;
+        }
+
+    check(0);
+    return VK_INDEX_TYPE_UINT32;
+}
+
+/*Offsets in an index buffer must be a multiple of the index size*/
+inline bool
+isIndexOffsetAligned(uint64_t offset, const Fox::EIndexType indexType)
+{
+    return offset % (indexType == Fox::EIndexType::UINT16 ? sizeof(uint16_t) : sizeof(uint32_t)) == 0;
+}
+
+/*Every attribute reads the next location from the binding of its stream and a binding has a single input rate. Returns false if
+a step rate is above 1, it requires VK_EXT_vertex_attribute_divisor, if a stream is out of range or if per vertex and per
+instance attributes share a stream*/
+inline bool
+convertVertexLayout(const std::vector<Fox::VertexLayoutInfo>& info, std::vector<VkVertexInputAttributeDescription>& outAttributes, std::array<std::optional<VkVertexInputRate>, Fox::VertexLayoutInfo::MAX_STREAMS>& outStreamInputRates)
+{
+    outAttributes.clear();
+    outAttributes.reserve(info.size());
+    outStreamInputRates = {};
+
+    uint32_t location{};
+    for (const auto& i : info)
+        {
+            const bool perInstance = i.Classification == Fox::EVertexInputClassification::PER_INSTANCE_DATA;
+            if ((perInstance && i.InstanceDataStepRate > 1) || i.Stream >= Fox::VertexLayoutInfo::MAX_STREAMS)
+                return false;
+
+            const VkVertexInputRate inputRate  = perInstance ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
+            auto&                   streamRate = outStreamInputRates[i.Stream];
+            if (streamRate.has_value() && *streamRate != inputRate)
+                return false;
+            streamRate = inputRate;
+
+            VkVertexInputAttributeDescription attr{};
+            attr.location = location++;
+            attr.binding  = i.Stream;
+            attr.format   = convertFormat(i.Format);
+            attr.offset   = i.ByteOffset; // From the start of the element in the stream
+            outAttributes.push_back(attr);
+        }
+    return true;
+}
+
+/*Stride of every stream of the shader, the vertex and instance streams without one take VertexStride and InstanceStride*/
+inline std::array<uint32_t, Fox::VertexLayoutInfo::MAX_STREAMS>
+resolveStreamStrides(const Fox::ShaderSource& source)
+{
+    auto strides = source.StreamStrides;
+    if (strides[Fox::VertexLayoutInfo::VERTEX_STREAM] == 0)
+        {
+            strides[Fox::VertexLayoutInfo::VERTEX_STREAM] = source.VertexStride;
+        }
+    if (strides[Fox::VertexLayoutInfo::INSTANCE_STREAM] == 0)
+        {
+            strides[Fox::VertexLayoutInfo::INSTANCE_STREAM] = source.InstanceStride;
+        }
+    return strides;
+}
+
+/*A binding for every stream read by an attribute, with the stride of the stream*/
+inline std::vector<VkVertexInputBindingDescription>
+convertVertexInputBindings(const std::array<std::optional<VkVertexInputRate>, Fox::VertexLayoutInfo::MAX_STREAMS>& streamInputRates, const std::array<uint32_t, Fox::VertexLayoutInfo::MAX_STREAMS>& streamStrides)
+{
+    std::vector<VkVertexInputBindingDescription> bindings;
+    for (uint32_t stream = 0; stream < Fox::VertexLayoutInfo::MAX_STREAMS; stream++)
+        {
+            if (!streamInputRates[stream].has_value())
+                continue;
+
+            check(streamStrides[stream] > 0); // The shader source must have the stride of every stream read
+            bindings.push_back(VkVertexInputBindingDescription{ stream, streamStrides[stream], *streamInputRates[stream] });
+        }
+    return bindings;
+}
+
 inline bool
 isColorFormat(const VkFormat format)
 {
@@ -491,6 +580,51 @@ convertAttachmentReferenceLayout(const Fox::EAttachmentReference& att)
     return VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL;
 }
 
+inline VkShaderStageFlags
+convertShaderStage(const ::Fox::EShaderStage stage)
+{
+    switch (stage)
+        {
+            case ::Fox::EShaderStage::VERTEX:
+                return VK_SHADER_STAGE_VERTEX_BIT;
+            case ::Fox::EShaderStage::FRAGMENT:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case ::Fox::EShaderStage::ALL:
+                return VK_SHADER_STAGE_ALL_GRAPHICS;
+            case ::Fox::EShaderStage::COMPUTE:
+                return VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+    check(0);
+    return VK_SHADER_STAGE_ALL_GRAPHICS;
+}
+
+/*A stage can be only in one range*/
+inline std::vector<VkPushConstantRange>
+convertPushConstantRanges(const std::vector<::Fox::ShaderPushConstantRange>& ranges)
+{
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    VkShaderStageFlags               stages{};
+    for (const auto& range : ranges)
+        {
+            check(range.Offset % 4 == 0 && range.Size % 4 == 0); // Must be multiple of 4
+            check(range.Size > 0);
+
+            const VkShaderStageFlags stageFlags = convertShaderStage(range.Stage);
+            check((stages & stageFlags) == 0); // The stage is already in another range
+            stages |= stageFlags;
+
+            pushConstantRanges.push_back(VkPushConstantRange{ stageFlags, range.Offset, range.Size });
+        }
+    return pushConstantRanges;
+}
+
+/*Every range must end within the device push constant size*/
+inline bool
+fitsPushConstantSize(const std::vector<::Fox::ShaderPushConstantRange>& ranges, uint32_t maxPushConstantsSize)
+{
+    return std::all_of(ranges.begin(), ranges.end(), [maxPushConstantsSize](const ::Fox::ShaderPushConstantRange& range) { return range.Offset + range.Size <= maxPushConstantsSize; });
+}
+
 //@TODO add unit test
 inline std::vector<VkDescriptorSetLayoutBinding>
 convertDescriptorBindings(const std::map<uint32_t /*binding*/, ::Fox::ShaderDescriptorBindings>& bindingToDescription)
@@ -529,18 +663,7 @@ convertDescriptorBindings(const std::map<uint32_t /*binding*/, ::Fox::ShaderDesc
                         break;
                 }
 
-            switch (description.Stage)
-                {
-                    case ::Fox::EShaderStage::VERTEX:
-                        b.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-                        break;
-                    case ::Fox::EShaderStage::FRAGMENT:
-                        b.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-                        break;
-                    case ::Fox::EShaderStage::ALL:
-                        b.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
-                        break;
-                }
+            b.stageFlags = convertShaderStage(description.Stage);
             bindings.emplace_back(std::move(b));
         }
 
@@ -608,7 +731,7 @@ createShaderStageInfo(VkShaderStageFlagBits stage, VkShaderModule shaderModule)
 {
     constexpr const char* PENTRYPOINTNAME{ "main" };
     check(shaderModule);
-    check(stage == VK_SHADER_STAGE_VERTEX_BIT || stage == VK_SHADER_STAGE_FRAGMENT_BIT);
+    check(stage == VK_SHADER_STAGE_VERTEX_BIT || stage == VK_SHADER_STAGE_FRAGMENT_BIT || stage == VK_SHADER_STAGE_COMPUTE_BIT);
 
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.pNext               = nullptr;
@@ -801,6 +924,87 @@ resourceStateToAccessFlag(Fox::EResourceState state)
     return ret;
 }
 
+/*Stages accessing a resource in the given state, used by the synchronization2 barriers where every barrier has its own
+stage masks. Shader resources are split between pixel and non pixel stages*/
+inline VkPipelineStageFlags2KHR
+resourceStateToPipelineStage2(Fox::EResourceState state)
+{
+    if (state == Fox::EResourceState::UNDEFINED || state == Fox::EResourceState::PRESENT)
+        {
+            // Nothing to wait for, presentation is ordered by the semaphores
+            return VK_PIPELINE_STAGE_2_NONE_KHR;
+        }
+
+    VkPipelineStageFlags2KHR ret = 0;
+    if ((uint32_t)state & ((uint32_t)Fox::EResourceState::COPY_SOURCE | (uint32_t)Fox::EResourceState::COPY_DEST))
+        {
+            ret |= VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::VERTEX_AND_CONSTANT_BUFFER)
+        {
+            ret |= VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::INDEX_BUFFER)
+        {
+            ret |= VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::UNORDERED_ACCESS)
+        {
+            ret |= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::NON_PIXEL_SHADER_RESOURCE)
+        {
+            ret |= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::PIXEL_SHADER_RESOURCE)
+        {
+            ret |= VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::INDIRECT_ARGUMENT)
+        {
+            ret |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR;
+        }
+    if ((uint32_t)state & (uint32_t)Fox::EResourceState::RENDER_TARGET)
+        {
+            ret |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        }
+    if ((uint32_t)state & ((uint32_t)Fox::EResourceState::DEPTH_WRITE | (uint32_t)Fox::EResourceState::DEPTH_READ))
+        {
+            ret |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR;
+        }
+
+    // States without a known stage, eg. COMMON
+    return ret != 0 ? ret : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+}
+
+/*Drops the stages the queue doesn't support, eg. the fragment stage of a shader resource barrier on the compute queue*/
+inline VkPipelineStageFlags2KHR
+restrictPipelineStages2(VkPipelineStageFlags2KHR stages, Fox::EQueueType queueType)
+{
+    constexpr VkPipelineStageFlags2KHR COMMON_STAGES = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT_KHR |
+    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_HOST_BIT_KHR;
+
+    VkPipelineStageFlags2KHR supported{};
+    switch (queueType)
+        {
+            case Fox::EQueueType::COMPUTE:
+                supported = COMMON_STAGES | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR;
+                break;
+            case Fox::EQueueType::TRANSFER:
+                supported = COMMON_STAGES;
+                break;
+            default:
+                return stages;
+        }
+
+    if (stages == VK_PIPELINE_STAGE_2_NONE_KHR)
+        return stages;
+
+    const VkPipelineStageFlags2KHR restricted = stages & supported;
+    return restricted != 0 ? restricted : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+}
+
 #define CASE(FIRST, SECOND) \
     case FIRST: \
         return SECOND;
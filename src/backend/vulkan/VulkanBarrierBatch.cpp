@@ -0,0 +1,260 @@
+// Copyright RedFox Studio 2022
+
+#include "VulkanBarrierBatch.h"
+
+#include "UtilsVK.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Fox
+{
+
+enum class EOverlap
+{
+    NONE,
+    SAME_RANGE,
+    PARTIAL
+};
+
+inline bool
+RangesOverlap(uint64_t lhsBase, uint64_t lhsCount, uint64_t rhsBase, uint64_t rhsCount, uint64_t remaining)
+{
+    const uint64_t lhsEnd = lhsCount == remaining ? UINT64_MAX : lhsBase + lhsCount;
+    const uint64_t rhsEnd = rhsCount == remaining ? UINT64_MAX : rhsBase + rhsCount;
+    return lhsBase < rhsEnd && rhsBase < lhsEnd;
+}
+
+/*Release or acquire barrier, a merged transition would lose its queue families*/
+template<class T>
+inline bool
+TransfersOwnership(const T& barrier)
+{
+    return barrier.srcQueueFamilyIndex != barrier.dstQueueFamilyIndex;
+}
+
+template<class T>
+inline EOverlap
+ImageOverlap(const T& queued, const T& barrier)
+{
+    const auto& lhs = queued.subresourceRange;
+    const auto& rhs = barrier.subresourceRange;
+    if (queued.image != barrier.image || !RangesOverlap(lhs.baseMipLevel, lhs.levelCount, rhs.baseMipLevel, rhs.levelCount, VK_REMAINING_MIP_LEVELS) ||
+    !RangesOverlap(lhs.baseArrayLayer, lhs.layerCount, rhs.baseArrayLayer, rhs.layerCount, VK_REMAINING_ARRAY_LAYERS))
+        return EOverlap::NONE;
+    if (TransfersOwnership(queued) || TransfersOwnership(barrier))
+        return EOverlap::PARTIAL;
+
+    const bool sameRange = lhs.aspectMask == rhs.aspectMask && lhs.baseMipLevel == rhs.baseMipLevel && lhs.levelCount == rhs.levelCount && lhs.baseArrayLayer == rhs.baseArrayLayer &&
+    lhs.layerCount == rhs.layerCount;
+    return sameRange ? EOverlap::SAME_RANGE : EOverlap::PARTIAL;
+}
+
+template<class T>
+inline EOverlap
+BufferOverlap(const T& queued, const T& barrier)
+{
+    if (queued.buffer != barrier.buffer || !RangesOverlap(queued.offset, queued.size, barrier.offset, barrier.size, VK_WHOLE_SIZE))
+        return EOverlap::NONE;
+    if (TransfersOwnership(queued) || TransfersOwnership(barrier))
+        return EOverlap::PARTIAL;
+
+    return queued.offset == barrier.offset && queued.size == barrier.size ? EOverlap::SAME_RANGE : EOverlap::PARTIAL;
+}
+
+inline EOverlap
+Overlap(const VkImageMemoryBarrier& queued, const VkImageMemoryBarrier& barrier)
+{
+    return ImageOverlap(queued, barrier);
+}
+
+inline EOverlap
+Overlap(const VkImageMemoryBarrier2KHR& queued, const VkImageMemoryBarrier2KHR& barrier)
+{
+    return ImageOverlap(queued, barrier);
+}
+
+inline EOverlap
+Overlap(const VkBufferMemoryBarrier& queued, const VkBufferMemoryBarrier& barrier)
+{
+    return BufferOverlap(queued, barrier);
+}
+
+inline EOverlap
+Overlap(const VkBufferMemoryBarrier2KHR& queued, const VkBufferMemoryBarrier2KHR& barrier)
+{
+    return BufferOverlap(queued, barrier);
+}
+
+/*Single transition from the state before the queued barrier to the state after the new one, no command could use the
+resource in between*/
+template<class T>
+inline T
+Merge(const T& queued, const T& barrier)
+{
+    T merged             = barrier;
+    merged.srcAccessMask = queued.srcAccessMask;
+    if constexpr (std::is_same_v<T, VkImageMemoryBarrier> || std::is_same_v<T, VkImageMemoryBarrier2KHR>)
+        {
+            merged.oldLayout = queued.oldLayout;
+        }
+    if constexpr (std::is_same_v<T, VkImageMemoryBarrier2KHR> || std::is_same_v<T, VkBufferMemoryBarrier2KHR>)
+        {
+            merged.srcStageMask = queued.srcStageMask;
+        }
+    return merged;
+}
+
+template<class T>
+inline T
+RestrictStages(const T& barrier, EQueueType queueType)
+{
+    T restricted            = barrier;
+    restricted.srcStageMask = VkUtils::restrictPipelineStages2(barrier.srcStageMask, queueType);
+    restricted.dstStageMask = VkUtils::restrictPipelineStages2(barrier.dstStageMask, queueType);
+    return restricted;
+}
+
+bool
+RIVkBarrierBatch::Add(const VkImageMemoryBarrier& barrier)
+{
+    return _add(barrier, &DStagePair::ImageBarriers);
+}
+
+bool
+RIVkBarrierBatch::Add(const VkImageMemoryBarrier2KHR& barrier)
+{
+    return _add2(RestrictStages(barrier, _queueType), _imageBarriers2);
+}
+
+bool
+RIVkBarrierBatch::Add(const VkBufferMemoryBarrier& barrier)
+{
+    return _add(barrier, &DStagePair::BufferBarriers);
+}
+
+bool
+RIVkBarrierBatch::Add(const VkBufferMemoryBarrier2KHR& barrier)
+{
+    return _add2(RestrictStages(barrier, _queueType), _bufferBarriers2);
+}
+
+void
+RIVkBarrierBatch::Flush(VkCommandBuffer cmd)
+{
+    if (_barrierCount == 0)
+        return;
+
+    for (auto& pair : _stagePairs)
+        {
+            if (pair.ImageBarriers.size() > 0 || pair.BufferBarriers.size() > 0)
+                {
+                    vkCmdPipelineBarrier(cmd,
+                    pair.SrcStage,
+                    pair.DstStage,
+                    0,
+                    0,
+                    NULL,
+                    (uint32_t)pair.BufferBarriers.size(),
+                    pair.BufferBarriers.data(),
+                    (uint32_t)pair.ImageBarriers.size(),
+                    pair.ImageBarriers.data());
+                }
+        }
+
+    if (_imageBarriers2.size() > 0 || _bufferBarriers2.size() > 0)
+        {
+            VkDependencyInfoKHR dependencyInfo{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR };
+            dependencyInfo.bufferMemoryBarrierCount = (uint32_t)_bufferBarriers2.size();
+            dependencyInfo.pBufferMemoryBarriers    = _bufferBarriers2.data();
+            dependencyInfo.imageMemoryBarrierCount  = (uint32_t)_imageBarriers2.size();
+            dependencyInfo.pImageMemoryBarriers     = _imageBarriers2.data();
+            vkCmdPipelineBarrier2KHR(cmd, &dependencyInfo);
+        }
+    Clear();
+}
+
+void
+RIVkBarrierBatch::Clear()
+{
+    // Stage pairs are kept with their capacity, the same ones are used frame after frame
+    for (auto& pair : _stagePairs)
+        {
+            pair.ImageBarriers.clear();
+            pair.BufferBarriers.clear();
+        }
+    _imageBarriers2.clear();
+    _bufferBarriers2.clear();
+    _barrierCount = 0;
+}
+
+template<class T>
+bool
+RIVkBarrierBatch::_add(const T& barrier, std::vector<T> DStagePair::*barriers)
+{
+    const VkPipelineStageFlags dstStage = VkUtils::determinePipelineStageFlags(barrier.dstAccessMask, _queueType);
+
+    for (auto& pair : _stagePairs)
+        {
+            auto& queuedBarriers = pair.*barriers;
+            for (size_t i = 0; i < queuedBarriers.size(); i++)
+                {
+                    // Barriers in the same vkCmdPipelineBarrier aren't ordered, two transitions of a subresource can't be in it
+                    const auto overlap = Overlap(queuedBarriers[i], barrier);
+                    if (overlap == EOverlap::NONE)
+                        continue;
+                    if (overlap == EOverlap::PARTIAL)
+                        return false;
+
+                    // Moved to the stage pair of the merged transition
+                    const T                    merged   = Merge(queuedBarriers[i], barrier);
+                    const VkPipelineStageFlags srcStage = pair.SrcStage;
+                    queuedBarriers[i]                   = queuedBarriers.back();
+                    queuedBarriers.pop_back();
+
+                    (_getStagePair(srcStage, dstStage).*barriers).push_back(merged);
+                    return true;
+                }
+        }
+
+    const VkPipelineStageFlags srcStage = VkUtils::determinePipelineStageFlags(barrier.srcAccessMask, _queueType);
+    (_getStagePair(srcStage, dstStage).*barriers).push_back(barrier);
+    _barrierCount++;
+    return true;
+}
+
+template<class T>
+bool
+RIVkBarrierBatch::_add2(const T& barrier, std::vector<T>& barriers)
+{
+    for (auto& queued : barriers)
+        {
+            const auto overlap = Overlap(queued, barrier);
+            if (overlap == EOverlap::NONE)
+                continue;
+            if (overlap == EOverlap::PARTIAL)
+                return false;
+
+            queued = Merge(queued, barrier);
+            return true;
+        }
+
+    barriers.push_back(barrier);
+    _barrierCount++;
+    return true;
+}
+
+RIVkBarrierBatch::DStagePair&
+RIVkBarrierBatch::_getStagePair(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+{
+    auto found = std::find_if(_stagePairs.begin(), _stagePairs.end(), [srcStage, dstStage](const DStagePair& pair) { return pair.SrcStage == srcStage && pair.DstStage == dstStage; });
+    if (found == _stagePairs.end())
+        {
+            DStagePair pair;
+            pair.SrcStage = srcStage;
+            pair.DstStage = dstStage;
+            found         = _stagePairs.insert(_stagePairs.end(), std::move(pair));
+        }
+    return *found;
+}
+}
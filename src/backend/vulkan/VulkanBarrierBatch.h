@@ -0,0 +1,205 @@
+// Copyright RedFox Studio 2022
+
+#pragma once
+
+#include "IContext.h"
+#include "UtilsVK.h"
+
+#include <volk.h>
+
+#include <type_traits>
+#include <vector>
+
+namespace Fox
+{
+/*Image barrier moving the subresource range from currentState to newState. An image whose memory was used by another resource
+is transitioned from UNDEFINED waiting for the accesses of aliasedState, the last state of the previous resource*/
+inline VkImageMemoryBarrier
+MakeImageBarrier(VkImage     image,
+VkImageAspectFlags           aspect,
+EResourceState               currentState,
+EResourceState               newState,
+uint32_t                     mipLevel,
+uint32_t                     levelCount,
+uint32_t                     arrayLayer,
+uint32_t                     layerCount,
+EResourceState               aliasedState = EResourceState::UNDEFINED)
+{
+    check(aliasedState == EResourceState::UNDEFINED || currentState == EResourceState::UNDEFINED); // Aliased content is discarded
+
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    if (EResourceState::UNORDERED_ACCESS == currentState && EResourceState::UNORDERED_ACCESS == newState)
+        {
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.newLayout     = VK_IMAGE_LAYOUT_GENERAL;
+        }
+    else
+        {
+            barrier.srcAccessMask = VkUtils::resourceStateToAccessFlag(currentState == EResourceState::UNDEFINED ? aliasedState : currentState);
+            barrier.dstAccessMask = VkUtils::resourceStateToAccessFlag(newState);
+            barrier.oldLayout     = VkUtils::resourceStateToImageLayout(currentState);
+            barrier.newLayout     = VkUtils::resourceStateToImageLayout(newState);
+        }
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = image;
+    barrier.subresourceRange.aspectMask     = aspect;
+    barrier.subresourceRange.baseMipLevel   = mipLevel;
+    barrier.subresourceRange.levelCount     = levelCount;
+    barrier.subresourceRange.baseArrayLayer = arrayLayer;
+    barrier.subresourceRange.layerCount     = layerCount;
+    return barrier;
+}
+
+/*Synchronization2 version of the barrier, its stages are derived from the states instead of the access masks of the whole batch*/
+inline VkImageMemoryBarrier2KHR
+MakeImageBarrier2(VkImage    image,
+VkImageAspectFlags           aspect,
+EResourceState               currentState,
+EResourceState               newState,
+uint32_t                     mipLevel,
+uint32_t                     levelCount,
+uint32_t                     arrayLayer,
+uint32_t                     layerCount,
+EResourceState               aliasedState = EResourceState::UNDEFINED)
+{
+    const auto legacy = MakeImageBarrier(image, aspect, currentState, newState, mipLevel, levelCount, arrayLayer, layerCount, aliasedState);
+
+    VkImageMemoryBarrier2KHR barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR };
+    barrier.srcStageMask = VkUtils::resourceStateToPipelineStage2(currentState == EResourceState::UNDEFINED ? aliasedState : currentState);
+    barrier.dstStageMask = VkUtils::resourceStateToPipelineStage2(newState);
+    // Stage NONE can't have accesses, presentation is made visible by the semaphores
+    barrier.srcAccessMask       = barrier.srcStageMask == VK_PIPELINE_STAGE_2_NONE_KHR ? 0 : (VkAccessFlags2KHR)legacy.srcAccessMask;
+    barrier.dstAccessMask       = barrier.dstStageMask == VK_PIPELINE_STAGE_2_NONE_KHR ? 0 : (VkAccessFlags2KHR)legacy.dstAccessMask;
+    barrier.oldLayout           = legacy.oldLayout;
+    barrier.newLayout           = legacy.newLayout;
+    barrier.srcQueueFamilyIndex = legacy.srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = legacy.dstQueueFamilyIndex;
+    barrier.image               = legacy.image;
+    barrier.subresourceRange    = legacy.subresourceRange;
+    return barrier;
+}
+
+/*Barrier on the whole buffer*/
+inline VkBufferMemoryBarrier
+MakeBufferBarrier(VkBuffer buffer, EResourceState currentState, EResourceState newState)
+{
+    VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    if (EResourceState::UNORDERED_ACCESS == currentState && EResourceState::UNORDERED_ACCESS == newState)
+        {
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+        }
+    else
+        {
+            barrier.srcAccessMask = VkUtils::resourceStateToAccessFlag(currentState);
+            barrier.dstAccessMask = VkUtils::resourceStateToAccessFlag(newState);
+        }
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer              = buffer;
+    barrier.offset              = 0;
+    barrier.size                = VK_WHOLE_SIZE;
+    return barrier;
+}
+
+inline VkBufferMemoryBarrier2KHR
+MakeBufferBarrier2(VkBuffer buffer, EResourceState currentState, EResourceState newState)
+{
+    const auto legacy = MakeBufferBarrier(buffer, currentState, newState);
+
+    VkBufferMemoryBarrier2KHR barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR };
+    barrier.srcStageMask        = VkUtils::resourceStateToPipelineStage2(currentState);
+    barrier.dstStageMask        = VkUtils::resourceStateToPipelineStage2(newState);
+    barrier.srcAccessMask       = barrier.srcStageMask == VK_PIPELINE_STAGE_2_NONE_KHR ? 0 : (VkAccessFlags2KHR)legacy.srcAccessMask;
+    barrier.dstAccessMask       = barrier.dstStageMask == VK_PIPELINE_STAGE_2_NONE_KHR ? 0 : (VkAccessFlags2KHR)legacy.dstAccessMask;
+    barrier.srcQueueFamilyIndex = legacy.srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = legacy.dstQueueFamilyIndex;
+    barrier.buffer              = legacy.buffer;
+    barrier.offset              = legacy.offset;
+    barrier.size                = legacy.size;
+    return barrier;
+}
+
+/*Release or acquire half of a queue family ownership transfer, the stages and accesses of the other queue are ignored*/
+template<class T>
+inline void
+SetOwnershipTransfer(T& barrier, uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex, bool release)
+{
+    barrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+    if (release)
+        {
+            barrier.dstAccessMask = 0;
+        }
+    else
+        {
+            barrier.srcAccessMask = 0;
+        }
+    if constexpr (std::is_same_v<T, VkImageMemoryBarrier2KHR> || std::is_same_v<T, VkBufferMemoryBarrier2KHR>)
+        {
+            if (release)
+                {
+                    barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+                }
+            else
+                {
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+                }
+        }
+}
+
+/*Image and buffer barriers queued on a command buffer and recorded together at the next flush, one vkCmdPipelineBarrier per
+stage pair. Synchronization2 barriers carry their own stage masks and are all recorded by a single vkCmdPipelineBarrier2KHR.
+The memory is kept between flushes, queuing doesn't allocate once the batch has grown*/
+class RIVkBarrierBatch
+{
+  public:
+    struct DStagePair
+    {
+        VkPipelineStageFlags               SrcStage{};
+        VkPipelineStageFlags               DstStage{};
+        std::vector<VkImageMemoryBarrier>  ImageBarriers;
+        std::vector<VkBufferMemoryBarrier> BufferBarriers;
+    };
+
+    /*Queues the barrier with the stages of its access masks. A barrier on the same subresource range of a queued one is
+    merged into it, no command could use the resource in between. Returns false if it overlaps a queued barrier with a
+    different range or either of them transfers queue family ownership, the batch must be flushed before queuing it*/
+    bool Add(const VkImageMemoryBarrier& barrier);
+    /*Same as above for a synchronization2 barrier, the merged barrier keeps the source stage of the queued one. The stages
+    the queue doesn't support are dropped*/
+    bool Add(const VkImageMemoryBarrier2KHR& barrier);
+    /*Buffer barriers follow the same rules, their range is the subresource range*/
+    bool Add(const VkBufferMemoryBarrier& barrier);
+    bool Add(const VkBufferMemoryBarrier2KHR& barrier);
+    /*Records the queued barriers on the command buffer, it must be outside a render pass*/
+    void Flush(VkCommandBuffer cmd);
+    /*Drops the queued barriers, eg. when the command buffer is reset*/
+    void Clear();
+    /*Queue the command buffer is submitted to, the stages of the barriers must be supported by it*/
+    void SetQueueType(EQueueType queueType) { _queueType = queueType; };
+
+    bool                                          IsEmpty() const { return _barrierCount == 0; };
+    uint32_t                                      GetBarrierCount() const { return _barrierCount; };
+    const std::vector<DStagePair>&                GetStagePairs() const { return _stagePairs; };
+    const std::vector<VkImageMemoryBarrier2KHR>&  GetImageBarriers2() const { return _imageBarriers2; };
+    const std::vector<VkBufferMemoryBarrier2KHR>& GetBufferBarriers2() const { return _bufferBarriers2; };
+
+  private:
+    std::vector<DStagePair>                _stagePairs;
+    std::vector<VkImageMemoryBarrier2KHR>  _imageBarriers2;
+    std::vector<VkBufferMemoryBarrier2KHR> _bufferBarriers2;
+    uint32_t                               _barrierCount{};
+    EQueueType                             _queueType{ EQueueType::GRAPHICS };
+
+    template<class T>
+    bool _add(const T& barrier, std::vector<T> DStagePair::*barriers);
+    template<class T>
+    bool _add2(const T& barrier, std::vector<T>& barriers);
+
+    DStagePair& _getStagePair(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
+};
+}
@@ -7,103 +7,160 @@
 #include "UtilsVK.h"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <math.h>
 #include <string>
+#include <thread>
+#include <type_traits>
 
 namespace Fox
 {
 
-static constexpr uint8_t PENDING_DESTROY = 0xFF;
-static constexpr uint8_t FREE            = 0x00;
+static constexpr uint32_t PENDING_DESTROY = 0xFFFFFFFF; // Never a valid id, resource type bits are out of range
+static constexpr uint32_t FREE            = 0x00;
 
 static bool
-IsValidId(uint8_t id)
+IsValidId(uint32_t id)
 {
     return id != FREE && id != PENDING_DESTROY;
 };
 
-template<class T, EResourceType type, size_t maxSize>
+/*Validation performed by GetResource, selected at build time with the FOX_RESOURCE_VALIDATION cmake option*/
+enum class EResourceValidation
+{
+    FULL, // Null, type, bounds, liveness and generation checks
+    GENERATION, // Bounds check and a single id compare
+    RAW // Direct index, no checks
+};
+
+#if defined(FOX_RESOURCE_VALIDATION_FULL)
+static constexpr EResourceValidation RESOURCE_VALIDATION = EResourceValidation::FULL;
+#elif defined(FOX_RESOURCE_VALIDATION_GENERATION)
+static constexpr EResourceValidation RESOURCE_VALIDATION = EResourceValidation::GENERATION;
+#elif defined(FOX_RESOURCE_VALIDATION_RAW)
+static constexpr EResourceValidation RESOURCE_VALIDATION = EResourceValidation::RAW;
+#elif defined(_DEBUG)
+static constexpr EResourceValidation RESOURCE_VALIDATION = EResourceValidation::FULL;
+#else
+static constexpr EResourceValidation RESOURCE_VALIDATION = EResourceValidation::RAW;
+#endif
+
+template<class T, EResourceType type, EResourceValidation validation = RESOURCE_VALIDATION>
 inline T&
-GetResource(std::array<T, maxSize>& container, uint32_t id)
+GetResource(RIResourceTable<T>& container, uint32_t id)
 {
-    check(id != NULL); // Uninitialized ID
     const auto resourceId = ResourceId(id);
-    check(resourceId.First() == type); // Invalid resource id
-    check(resourceId.Value() < maxSize); // Must be less than array size
-    T& element = container.at(resourceId.Value());
-    check(IsValidId(element.Id)); // The object must be in valid state
-    check(element.Id == resourceId.Second()); // The object must have not been destroyed previously and reallocated
-    return element;
+    if constexpr (validation == EResourceValidation::FULL)
+        {
+            critical(id != NULL); // Uninitialized ID
+            critical(resourceId.First() == type); // Invalid resource id
+            critical(resourceId.Value() < container.size()); // Must be less than table size
+            T& element = container[resourceId.Value()];
+            critical(IsValidId(element.Id)); // The object must be in valid state
+            critical(element.Id == id); // The object must have not been destroyed previously and reallocated
+            return element;
+        }
+    else if constexpr (validation == EResourceValidation::GENERATION)
+        {
+            // The id contains type, generation and index so a single compare validates all of them
+            critical(resourceId.Value() < container.size() && container[resourceId.Value()].Id == id);
+            return container[resourceId.Value()];
+        }
+    else
+        {
+            return container[resourceId.Value()];
+        }
 };
 
-template<class T, EResourceType type, size_t maxSize>
+template<class T, EResourceType type, EResourceValidation validation = RESOURCE_VALIDATION>
 inline const T&
-GetResource(const std::array<T, maxSize>& container, uint32_t id)
+GetResource(const RIResourceTable<T>& container, uint32_t id)
 {
-    const auto resourceId = ResourceId(id);
-    check(resourceId.First() == type); // Invalid resource id
-    check(resourceId.Value() < maxSize); // Must be less than array size
-    const T& element = container.at(resourceId.Value());
-    check(IsValidId(element.Id)); // The object must be in valid state
-    check(element.Id == resourceId.Second()); // The object must have not been destroyed previously and reallocated
-    return element;
+    return GetResource<T, type, validation>(const_cast<RIResourceTable<T>&>(container), id);
 };
 
-template<class T, EResourceType type, size_t maxSize>
+template<class T, EResourceType type>
 inline T&
-GetResourceUnsafe(std::array<T, maxSize>& container, uint32_t id)
+GetResourceUnsafe(RIResourceTable<T>& container, uint32_t id)
 {
     const auto resourceId = ResourceId(id);
     check(resourceId.First() == type); // Invalid resource id
-    check(resourceId.Value() < maxSize); // Must be less than array size
+    check(resourceId.Value() < container.size()); // Must be less than table size
     T& element = container.at(resourceId.Value());
     return element;
 };
 
-/*generate a random number identitier to be used for resources*/
-static uint8_t
-GenIdentifier()
-{
-    // It can hash collide, but is not happening in our case because we're also checking the resource type enum
-    // This must be used only to non trivial checking if the resource has been reallocated should have a different id
-    auto hash = [](uint32_t a) {
-        a = (a ^ 61) ^ (a >> 16);
-        a = a + (a << 3);
-        a = a ^ (a >> 4);
-        a = a * 0x27d4eb2d;
-        a = a ^ (a >> 15);
-        a = (a ^ 61) ^ (a >> 16);
-        return a;
-    };
-    static size_t counter = 0;
-    const auto    value   = hash(counter++);
-    check(value != 0); // must not be 0
-    return (uint8_t)value;
+/*Takes a free slot and stamps it with a new id, the slot generation is increased at every reuse*/
+template<class T>
+inline size_t
+AllocResource(RIResourceTable<T>& container, EResourceType type)
+{
+    const size_t index   = container.Allocate();
+    T&           element = container.at(index);
+    check(element.Id == FREE); // Slot in the free list must not be in use
+    check(index <= ResourceId::MAX_INDEX); // Must fit in the resource id
+    element.Generation = ResourceId::NextGeneration(element.Generation);
+    element.Id         = *ResourceId(type, element.Generation, (uint16_t)index);
+    return index;
 }
 
-template<class T, size_t maxSize>
-inline size_t
-AllocResource(std::array<T, maxSize>& container)
+/*Marks the slot as free and gives it back to the table free list, a slot that used its last generation is retired until the table is full*/
+template<class T>
+inline void
+FreeResource(RIResourceTable<T>& container, size_t index)
 {
-    for (size_t i = 0; i < maxSize; i++)
+    T& element = container.at(index);
+    check(element.Id != FREE); // Double free
+    element.Id = FREE;
+    if (ResourceId::IsLastGeneration(element.Generation))
         {
-            T& element = container.at(i);
-            if (element.Id == NULL)
-                {
-                    // memset(&element, NULL, sizeof(T));//Only works with POD style
-                    while (element.Id == FREE || element.Id == PENDING_DESTROY)
-                        {
-                            element.Id = GenIdentifier();
-                        } // Messy but makes sure that id is never NULL
-                    check(element.Id != FREE);
-                    check(element.Id != PENDING_DESTROY);
-                    return i;
-                }
+            container.Retire(index);
+        }
+    else
+        {
+            container.Release(index);
+        }
+}
+
+inline void
+InitializeSubresourceStates(DSubresourceStates& states, uint32_t mipLevels, uint32_t arrayLayers, EResourceState state)
+{
+    states.MipLevels   = mipLevels;
+    states.ArrayLayers = arrayLayers;
+    states.States.assign(mipLevels * arrayLayers, state);
+}
+
+inline void
+SetSubresourceStates(DSubresourceStates& states, EResourceState state, bool subresource, uint32_t mipLevel, uint32_t arrayLayer)
+{
+    if (subresource)
+        {
+            states.States.at(arrayLayer * states.MipLevels + mipLevel) = state;
         }
+    else
+        {
+            std::fill(states.States.begin(), states.States.end(), state);
+        }
+}
 
-    throw std::runtime_error("Failed to allocate!");
-    return {};
+inline VkDescriptorType
+BindlessDescriptorType(EBindlessHeapBinding binding)
+{
+    switch (binding)
+        {
+            case EBindlessHeapBinding::IMAGES:
+                return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            case EBindlessHeapBinding::SAMPLERS:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case EBindlessHeapBinding::UNIFORM_BUFFERS:
+            case EBindlessHeapBinding::VERTEX_INDEX_BUFFERS:
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            default:
+                check(0);
+                break;
+        }
+    return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
 }
 
 DRenderPassAttachments
@@ -114,7 +171,7 @@ VulkanContext::_createGenericRenderPassAttachments(const DFramebufferAttachments
     const auto attachmentCount = DFramebufferAttachments::MAX_ATTACHMENTS - std::count(att.RenderTargets.begin(), att.RenderTargets.end(), NULL);
     for (size_t i = 0; i < attachmentCount; i++)
         {
-            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, att.RenderTargets[i]);
+            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, att.RenderTargets[i]);
 
             DRenderPassAttachment o(VkUtils::convertVkFormat(renderTargetRef.Image.Format),
             ESampleBit::COUNT_1_BIT,
@@ -134,7 +191,7 @@ VulkanContext::_createGenericRenderPassAttachments(const DFramebufferAttachments
 
     if (att.DepthStencil != 0)
         {
-            const auto& depthStencilRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, att.DepthStencil);
+            const auto& depthStencilRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, att.DepthStencil);
 
             DRenderPassAttachment depthStencilAttachment(VkUtils::convertVkFormat(depthStencilRef.Image.Format),
             ESampleBit::COUNT_1_BIT,
@@ -186,23 +243,28 @@ VulkanContext::_createGenericRenderPassAttachmentsFromPipelineAttachments(const
     return rp;
 }
 
-VulkanContext::VulkanContext(const DContextConfig* const config) : _warningOutput(config->warningFunction), _logOutput(config->logOutputFunction)
+VulkanContext::VulkanContext(const DContextConfig* const config)
+  : _warningOutput(config->warningFunction), _logOutput(config->logOutputFunction), _dynamicRendering(config->dynamicRendering), _automaticBarriers(config->automaticBarriers),
+    _synchronization2(config->synchronization2)
 {
+    _initializeResourcePools(config);
     _initializeVolk();
     _initializeInstance();
     _initializeDebugger();
     _initializeVersion();
     _initializeDevice();
     _initializeStagingBuffer(config->stagingBufferSize);
+    _initializeQueueTimelines();
+    _initializeBindlessHeap(config);
 
     // Initialize per frame pipeline layout map to descriptor pool manager
     _pipelineLayoutToDescriptorPool.resize(NUM_OF_FRAMES_IN_FLIGHT);
-    _deletionQueue.reserve(MAX_RESOURCES);
+    _deletionQueue.reserve(NUM_OF_FRAMES_IN_FLIGHT + 1);
 
-    _emptyUbo.Buffer = Device.CreateBufferHostVisible(4, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    _emptyUbo.Buffer = Device.CreateBufferHostVisible(4, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT); // Also the empty storage buffer
 
     _emptyImageId         = CreateImage(EFormat::R8G8B8A8_UNORM, 1, 1, 1);
-    _emptyImage           = &GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, _emptyImageId);
+    _emptyImage           = &GetResource<DImageVulkan, EResourceType::IMAGE>(_images, _emptyImageId);
     _emptySampler.Sampler = Device.CreateSampler(VK_FILTER_NEAREST, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, 0, 1, VK_SAMPLER_MIPMAP_MODE_NEAREST, false, 0.f);
 
     { // Transition to attachment optimal
@@ -216,15 +278,38 @@ VulkanContext::VulkanContext(const DContextConfig* const config) : _warningOutpu
         ResourceBarrier(cmd, 0, nullptr, 1, &barrier, 0, nullptr);
         EndCommandBuffer(cmd);
 
-        const auto fence = CreateFence(false);
-        QueueSubmit({}, {}, { cmd }, fence);
-        WaitForFence(fence, 0xFFFFFFFF);
-        DestroyFence(fence);
+        QueueSubmit({}, {}, { cmd }, NULL);
+        const DQueueTimelineVulkan& timeline = _queueTimelines[(size_t)EQueueType::GRAPHICS];
+        Device.WaitSemaphoreValue(timeline.Semaphore, timeline.SubmittedValue, UINT64_MAX);
         DestroyCommandBuffer(cmd);
         DestroyCommandPool(pool);
     }
 }
 
+void
+VulkanContext::_initializeResourcePools(const DContextConfig* const config)
+{
+    _swapchains.Initialize(config->swapchainCapacity.Initial, config->swapchainCapacity.Max);
+    _vertexBuffers.Initialize(config->vertexIndexBufferCapacity.Initial, config->vertexIndexBufferCapacity.Max);
+    _transferBuffers.Initialize(config->transferBufferCapacity.Initial, config->transferBufferCapacity.Max);
+    _uniformBuffers.Initialize(config->uniformBufferCapacity.Initial, config->uniformBufferCapacity.Max);
+    _indirectBuffers.Initialize(config->indirectBufferCapacity.Initial, config->indirectBufferCapacity.Max);
+    _framebuffers.Initialize(config->framebufferCapacity.Initial, config->framebufferCapacity.Max);
+    _shaders.Initialize(config->shaderCapacity.Initial, config->shaderCapacity.Max);
+    _vertexLayouts.Initialize(config->vertexLayoutCapacity.Initial, config->vertexLayoutCapacity.Max);
+    _images.Initialize(config->imageCapacity.Initial, config->imageCapacity.Max);
+    _pipelines.Initialize(config->pipelineCapacity.Initial, config->pipelineCapacity.Max);
+    _fences.Initialize(config->fenceCapacity.Initial, config->fenceCapacity.Max);
+    _samplers.Initialize(config->samplerCapacity.Initial, config->samplerCapacity.Max);
+    _semaphores.Initialize(config->semaphoreCapacity.Initial, config->semaphoreCapacity.Max);
+    _commandPools.Initialize(config->commandPoolCapacity.Initial, config->commandPoolCapacity.Max);
+    _commandBuffers.Initialize(config->commandBufferCapacity.Initial, config->commandBufferCapacity.Max);
+    _renderTargets.Initialize(config->renderTargetCapacity.Initial, config->renderTargetCapacity.Max);
+    _rootSignatures.Initialize(config->rootSignatureCapacity.Initial, config->rootSignatureCapacity.Max);
+    _descriptorSets.Initialize(config->descriptorSetCapacity.Initial, config->descriptorSetCapacity.Max);
+    _renderPassObjects.Initialize(config->renderPassCapacity.Initial, config->renderPassCapacity.Max);
+}
+
 void
 VulkanContext::_initializeVolk()
 {
@@ -330,13 +415,44 @@ VulkanContext::_initializeDevice()
     // Query physical device
     VkPhysicalDevice physicalDevice = _queryBestPhysicalDevice();
 
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    synchronization2Features.pNext = nullptr;
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.pNext = nullptr;
+
     VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
     descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
     descriptorIndexingFeatures.pNext = nullptr;
 
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures{};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineSemaphoreFeatures.pNext = &descriptorIndexingFeatures;
+
+    // Optional features are chained only if requested, the chain is rebuilt after checking their support
+    const auto chainOptionalFeatures = [&]() {
+        void** next = &descriptorIndexingFeatures.pNext;
+        *next       = nullptr;
+        if (_dynamicRendering)
+            {
+                *next = &dynamicRenderingFeatures;
+                next  = &dynamicRenderingFeatures.pNext;
+                *next = nullptr;
+            }
+        if (_synchronization2)
+            {
+                *next = &synchronization2Features;
+                next  = &synchronization2Features.pNext;
+                *next = nullptr;
+            }
+    };
+    chainOptionalFeatures();
+
     VkPhysicalDeviceFeatures2 pDeviceFeatures{};
     pDeviceFeatures.sType                                           = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-    pDeviceFeatures.pNext                                           = &descriptorIndexingFeatures;
+    pDeviceFeatures.pNext                                           = &timelineSemaphoreFeatures;
     pDeviceFeatures.features.samplerAnisotropy                      = VK_TRUE;
     pDeviceFeatures.features.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
     pDeviceFeatures.features.fillModeNonSolid                       = VK_TRUE;
@@ -353,10 +469,57 @@ VulkanContext::_initializeDevice()
     critical(descriptorIndexingFeatures.descriptorBindingUniformBufferUpdateAfterBind);
     critical(descriptorIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing);
     critical(descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind);
+    // The bindless heap is partially bound and destroyed resources are replaced while other frames are executing
+    critical(descriptorIndexingFeatures.descriptorBindingPartiallyBound);
+    critical(descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending);
+    // Submissions are tracked with timeline semaphores
+    critical(timelineSemaphoreFeatures.timelineSemaphore);
 
     // Check validation layers and extensions support for the device
     auto validDeviceValidationLayers = _getDeviceSupportedValidationLayers(physicalDevice, _validationLayers);
-    auto validDeviceExtensions       = _getDeviceSupportedExtensions(physicalDevice, _deviceExtensionNames);
+
+    auto deviceExtensionNames = _deviceExtensionNames;
+    if (_dynamicRendering)
+        {
+            deviceExtensionNames.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        }
+    if (_synchronization2)
+        {
+            deviceExtensionNames.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+        }
+    // Optional, only DrawIndexedIndirectCount needs it
+    deviceExtensionNames.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    auto validDeviceExtensions = _getDeviceSupportedExtensions(physicalDevice, deviceExtensionNames);
+    _drawIndirectCount         = std::any_of(validDeviceExtensions.begin(), validDeviceExtensions.end(), [](const char* name) { return strcmp(name, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0; });
+
+    if (_dynamicRendering)
+        {
+            const auto extensionIt = std::find_if(validDeviceExtensions.begin(), validDeviceExtensions.end(), [](const char* name) { return strcmp(name, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) == 0; });
+            if (extensionIt == validDeviceExtensions.end() || !dynamicRenderingFeatures.dynamicRendering)
+                {
+                    Warning("VK_KHR_dynamic_rendering is not supported, falling back to render passes");
+                    _dynamicRendering = false;
+                    if (extensionIt != validDeviceExtensions.end())
+                        {
+                            validDeviceExtensions.erase(extensionIt);
+                        }
+                }
+        }
+
+    if (_synchronization2)
+        {
+            const auto extensionIt = std::find_if(validDeviceExtensions.begin(), validDeviceExtensions.end(), [](const char* name) { return strcmp(name, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) == 0; });
+            if (extensionIt == validDeviceExtensions.end() || !synchronization2Features.synchronization2)
+                {
+                    Warning("VK_KHR_synchronization2 is not supported, falling back to vkCmdPipelineBarrier");
+                    _synchronization2 = false;
+                    if (extensionIt != validDeviceExtensions.end())
+                        {
+                            validDeviceExtensions.erase(extensionIt);
+                        }
+                }
+        }
+    chainOptionalFeatures();
 
     // Create device
     const auto result = Device.Create(Instance, (void*)&pDeviceFeatures, physicalDevice, validDeviceExtensions, nullptr, validDeviceValidationLayers);
@@ -387,17 +550,154 @@ VulkanContext::_deinitializeStagingBuffer()
     Device.DestroyBuffer(_stagingBuffer);
 }
 
+void
+VulkanContext::_initializeQueueTimelines()
+{
+    for (auto& timeline : _queueTimelines)
+        {
+            timeline.Semaphore = Device.CreateTimelineSemaphore(0);
+        }
+}
+
+void
+VulkanContext::_deinitializeQueueTimelines()
+{
+    for (auto& timeline : _queueTimelines)
+        {
+            Device.DestroyVkSemaphore(timeline.Semaphore);
+        }
+}
+
+void
+VulkanContext::_initializeBindlessHeap(const DContextConfig* const config)
+{
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(Device.PhysicalDevice, &properties);
+
+    // Every stage sees the whole heap, the per stage limits bound it as well. Samplers don't count as stage resources
+    const uint32_t resources      = indexingProperties.maxPerStageUpdateAfterBindResources;
+    const uint32_t sampledImages  = std::min({ indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages, resources / 2 });
+    const uint32_t samplers       = std::min(indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers, indexingProperties.maxDescriptorSetUpdateAfterBindSamplers);
+    const uint32_t storageBuffers = std::min({ indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers, indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers, resources / 2 }) / 2;
+
+    // Sized like the pools initially are instead of their max capacity, the driver allocates the whole array up front
+    const auto arraySize = [heapSize = config->bindlessHeapSize](const DResourcePoolCapacity& capacity, uint32_t deviceLimit) {
+        const uint32_t size = heapSize > 0 ? heapSize : capacity.Initial;
+        return std::min({ size, capacity.Max, deviceLimit });
+    };
+
+    auto& sizes                                               = _bindlessHeap.Sizes;
+    sizes[(size_t)EBindlessHeapBinding::IMAGES]               = arraySize(config->imageCapacity, sampledImages);
+    sizes[(size_t)EBindlessHeapBinding::SAMPLERS]             = arraySize(config->samplerCapacity, samplers);
+    sizes[(size_t)EBindlessHeapBinding::UNIFORM_BUFFERS]      = arraySize(config->uniformBufferCapacity, storageBuffers);
+    sizes[(size_t)EBindlessHeapBinding::VERTEX_INDEX_BUFFERS] = arraySize(config->vertexIndexBufferCapacity, storageBuffers);
+
+    std::array<VkDescriptorSetLayoutBinding, (size_t)EBindlessHeapBinding::MAX_COUNT> bindings{};
+    std::array<VkDescriptorBindingFlags, (size_t)EBindlessHeapBinding::MAX_COUNT>     bindingFlags{};
+    std::vector<VkDescriptorPoolSize>                                                  poolSizes;
+    for (uint32_t i = 0; i < (uint32_t)EBindlessHeapBinding::MAX_COUNT; i++)
+        {
+            critical(sizes[i] > 0); // The device has no room for the array
+
+            bindings[i].binding         = i;
+            bindings[i].descriptorType  = BindlessDescriptorType((EBindlessHeapBinding)i);
+            bindings[i].descriptorCount = sizes[i];
+            bindings[i].stageFlags      = VK_SHADER_STAGE_ALL;
+            bindingFlags[i]             = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+            poolSizes.push_back(VkDescriptorPoolSize{ bindings[i].descriptorType, sizes[i] });
+        }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount  = (uint32_t)bindingFlags.size();
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext        = &bindingFlagsInfo;
+    layoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = (uint32_t)bindings.size();
+    layoutInfo.pBindings    = bindings.data();
+
+    VkResult result = vkCreateDescriptorSetLayout(Device.Device, &layoutInfo, nullptr, &_bindlessHeap.Layout);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets       = 1;
+    poolInfo.poolSizeCount = (uint32_t)poolSizes.size();
+    poolInfo.pPoolSizes    = poolSizes.data();
+
+    result = vkCreateDescriptorPool(Device.Device, &poolInfo, nullptr, &_bindlessHeap.Pool);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = _bindlessHeap.Pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &_bindlessHeap.Layout;
+
+    result = vkAllocateDescriptorSets(Device.Device, &allocInfo, &_bindlessHeap.Set);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+}
+
+void
+VulkanContext::_deinitializeBindlessHeap()
+{
+    // The set is freed with its pool
+    vkDestroyDescriptorPool(Device.Device, _bindlessHeap.Pool, nullptr);
+    vkDestroyDescriptorSetLayout(Device.Device, _bindlessHeap.Layout, nullptr);
+    _bindlessHeap = {};
+}
+
+void
+VulkanContext::_writeBindlessDescriptor(EBindlessHeapBinding binding, uint32_t index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo)
+{
+    // Past the end of the array when the heap is smaller than the resource pool, GetBindlessIndex fails for it
+    if (index >= _bindlessHeap.Sizes[(size_t)binding])
+        return;
+
+    VkWriteDescriptorSet write{};
+    write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet          = _bindlessHeap.Set;
+    write.dstBinding      = (uint32_t)binding;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType  = BindlessDescriptorType(binding);
+    write.pImageInfo      = imageInfo;
+    write.pBufferInfo     = bufferInfo;
+    vkUpdateDescriptorSets(Device.Device, 1, &write, 0, nullptr);
+}
+
 VulkanContext::~VulkanContext()
 {
 
-    for (auto& fbo : _framebuffers)
+    for (size_t i = 0; i < _framebuffers.size(); i++)
         {
-            if (fbo.Id == FREE)
+            auto& fbo = _framebuffers.at(i);
+            // Pending ones are released with the deletion queue
+            if (!IsValidId(fbo.Id))
                 continue;
 
             Device._destroyFramebuffer(fbo.Framebuffer);
-            fbo.Id = FREE;
+            FreeResource(_framebuffers, i);
         }
+    _framebufferCache.clear();
 
 #if _DEBUG
     const auto validSwapchainsCount = std::count_if(_swapchains.begin(), _swapchains.end(), [](const DSwapchainVulkan& swapchain) { return IsValidId(swapchain.Id); });
@@ -417,8 +717,17 @@ VulkanContext::~VulkanContext()
 
     _deinitializeStagingBuffer();
 
+    // Managed command buffers of the last frames might still be executing
+    WaitDeviceIdle();
+    _destroyThreadCommandPools();
+
     FlushDeletedBuffers();
 
+    // Submissions still signal the timelines
+    WaitDeviceIdle();
+    _deinitializeQueueTimelines();
+    _deinitializeBindlessHeap();
+
     for (const auto renderPass : _renderPasses)
         {
             Device.DestroyRenderPass(renderPass);
@@ -438,7 +747,7 @@ VulkanContext::WaitDeviceIdle()
 SwapchainId
 VulkanContext::CreateSwapchain(const WindowData* windowData, EPresentMode& presentMode, EFormat& outFormat, uint32_t* width, uint32_t* height)
 {
-    const auto        index     = AllocResource<DSwapchainVulkan, MAX_RESOURCES>(_swapchains);
+    const auto        index     = AllocResource(_swapchains, EResourceType::SWAPCHAIN);
     DSwapchainVulkan& swapchain = _swapchains.at(index);
 
     _createSwapchain(swapchain, windowData, presentMode, outFormat);
@@ -450,7 +759,7 @@ VulkanContext::CreateSwapchain(const WindowData* windowData, EPresentMode& prese
             *height = swapchain.Capabilities.currentExtent.height;
         }
 
-    return *ResourceId(EResourceType::SWAPCHAIN, swapchain.Id, index);
+    return swapchain.Id;
 }
 
 void
@@ -507,12 +816,14 @@ VulkanContext::_createSwapchain(DSwapchainVulkan& swapchain, const WindowData* w
     // Create render targets
     for (size_t i = 0; i < swapchainImages.size(); i++)
         {
-            const auto index           = AllocResource<DRenderTargetVulkan, MAX_RESOURCES>(_renderTargets);
+            const auto index           = AllocResource(_renderTargets, EResourceType::RENDER_TARGET);
             auto&      renderTargetRef = _renderTargets.at(index);
 
-            const auto& imageRef        = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, swapchain.ImagesId[i]);
+            const auto& imageRef        = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, swapchain.ImagesId[i]);
             renderTargetRef.Image       = imageRef.Image;
             renderTargetRef.ImageAspect = imageRef.ImageAspect;
+            // Tracked on the render target, the swapchain image shares the VkImage but is never used directly
+            InitializeSubresourceStates(renderTargetRef.States, 1, 1, EResourceState::UNDEFINED);
 
             const auto result = Device.CreateImageView(imageRef.Image.Format, imageRef.Image.Image, imageRef.ImageAspect, 0, 1, &renderTargetRef.View);
             if (VKFAILED(result))
@@ -520,7 +831,7 @@ VulkanContext::_createSwapchain(DSwapchainVulkan& swapchain, const WindowData* w
                     throw std::runtime_error("Failed to create swapchain imageView " + std::string(VkUtils::VkErrorString(result)));
                 }
 
-            swapchain.RenderTargetsId[i] = *ResourceId(EResourceType::RENDER_TARGET, renderTargetRef.Id, index);
+            swapchain.RenderTargetsId[i] = renderTargetRef.Id;
         }
 }
 
@@ -531,7 +842,7 @@ VulkanContext::GetSwapchainRenderTargets(SwapchainId swapchainId)
 
     check(resource.First() == EResourceType::SWAPCHAIN);
 
-    DSwapchainVulkan& swapchain = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN, MAX_RESOURCES>(_swapchains, swapchainId);
+    DSwapchainVulkan& swapchain = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN>(_swapchains, swapchainId);
 
     std::vector<uint32_t> images;
     images.resize(swapchain.ImagesCount);
@@ -547,8 +858,8 @@ VulkanContext::GetSwapchainRenderTargets(SwapchainId swapchainId)
 bool
 VulkanContext::SwapchainAcquireNextImageIndex(SwapchainId swapchainId, uint64_t timeoutNanoseconds, uint32_t sempahoreid, uint32_t* outImageIndex)
 {
-    DSwapchainVulkan& swapchain    = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN, MAX_RESOURCES>(_swapchains, swapchainId);
-    DSemaphoreVulkan& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE, MAX_RESOURCES>(_semaphores, sempahoreid);
+    DSwapchainVulkan& swapchain    = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN>(_swapchains, swapchainId);
+    DSemaphoreVulkan& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE>(_semaphores, sempahoreid);
 
     const VkResult result = Device.AcquireNextImage(swapchain.Swapchain, timeoutNanoseconds, outImageIndex, semaphoreRef.Semaphore, VK_NULL_HANDLE);
     /*Spec: https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkQueueSubmit.html*/
@@ -598,7 +909,7 @@ uint32_t
 VulkanContext::_createImageFromVkImage(VkImage vkimage, VkFormat format, uint32_t width, uint32_t height)
 {
 
-    const auto    index    = AllocResource<DImageVulkan, MAX_RESOURCES>(_images);
+    const auto    index    = AllocResource(_images, EResourceType::IMAGE);
     DImageVulkan& image    = _images.at(index);
     image.Image.Image      = vkimage;
     image.Image.Allocation = nullptr;
@@ -607,6 +918,7 @@ VulkanContext::_createImageFromVkImage(VkImage vkimage, VkFormat format, uint32_
     image.Image.Height     = height;
     image.Image.MipLevels  = 1;
     image.Image.UsageFlags = NULL;
+    InitializeSubresourceStates(image.States, 1, 1, EResourceState::UNDEFINED);
 
     // Create renderTargetRef view
     image.ImageAspect = VkUtils::isColorFormat(format) ? VK_IMAGE_ASPECT_COLOR_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -618,7 +930,7 @@ VulkanContext::_createImageFromVkImage(VkImage vkimage, VkFormat format, uint32_
             }
     }
 
-    return *ResourceId(EResourceType::IMAGE, image.Id, index);
+    return image.Id;
 }
 
 void
@@ -628,56 +940,29 @@ VulkanContext::DestroySwapchain(SwapchainId swapchainId)
 
     check(resource.First() == EResourceType::SWAPCHAIN);
 
-    DSwapchainVulkan& swapchain = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN, MAX_RESOURCES>(_swapchains, swapchainId);
+    DSwapchainVulkan& swapchain = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN>(_swapchains, swapchainId);
 
     Device.DestroySwapchain(swapchain.Swapchain);
     Instance.DestroySurface(swapchain.Surface);
 
-    swapchain.Id = FREE;
-
     for (uint32_t i = 0; i < swapchain.ImagesCount; i++)
         {
-            auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, swapchain.ImagesId[i]);
+            auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, swapchain.ImagesId[i]);
             Device.DestroyImageView(imageRef.View);
-            imageRef.Id = FREE;
+            FreeResource(_images, ResourceId(swapchain.ImagesId[i]).Value());
 
             const auto renderTargetId{ swapchain.RenderTargetsId[i] };
-            auto&      renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, renderTargetId);
+            auto&      renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, renderTargetId);
 
             Device.DestroyImageView(renderTargetRef.View);
-            renderTargetRef.Id = FREE;
-
-            // Must destroy all framebuffers that reference this render target @TODO find a better algorithm without iterating over the array multiple times
-            const auto referenceCount = std::count_if(_framebuffers.begin(), _framebuffers.end(), [renderTargetId](const DFramebufferVulkan& fbo) {
-                for (size_t i = 0; i < DFramebufferAttachments::MAX_ATTACHMENTS; i++)
-                    {
-                        if (fbo.Attachments.RenderTargets[i] == renderTargetId)
-                            {
-                                return true;
-                            }
-                    }
-                return false;
-            });
-            for (uint32_t i = 0; i < referenceCount; i++)
-                {
-                    auto foundFbo = std::find_if(_framebuffers.begin(), _framebuffers.end(), [renderTargetId](const DFramebufferVulkan& fbo) {
-                        for (size_t i = 0; i < DFramebufferAttachments::MAX_ATTACHMENTS; i++)
-                            {
-                                if (fbo.Attachments.RenderTargets[i] == renderTargetId)
-                                    {
-                                        return true;
-                                    }
-                            }
-                        return false;
-                    });
+            FreeResource(_renderTargets, ResourceId(renderTargetId).Value());
 
-                    Device._destroyFramebuffer(foundFbo->Framebuffer);
-                    foundFbo->Id = FREE;
-                }
+            // Must destroy all framebuffers that reference this render target
+            _destroyFramebuffersWithAttachment(renderTargetId);
         }
     swapchain.ImagesCount = 0;
 
-    swapchain.Id = FREE;
+    FreeResource(_swapchains, resource.Value());
 }
 
 BufferId
@@ -689,23 +974,23 @@ VulkanContext::CreateBuffer(uint32_t size, EResourceType type, EMemoryUsage usag
     switch (type)
         {
             case EResourceType::UNIFORM_BUFFER:
-                usageFlags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-                index      = AllocResource<DBufferVulkan, MAX_RESOURCES>(_uniformBuffers);
+                usageFlags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+                index      = AllocResource(_uniformBuffers, EResourceType::UNIFORM_BUFFER);
                 buffer     = &_uniformBuffers.at(index);
                 break;
             case EResourceType::VERTEX_INDEX_BUFFER:
-                index      = AllocResource<DBufferVulkan, MAX_RESOURCES>(_vertexBuffers);
-                usageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+                index      = AllocResource(_vertexBuffers, EResourceType::VERTEX_INDEX_BUFFER);
+                usageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
                 buffer     = &_vertexBuffers.at(index);
                 break;
             case EResourceType::TRANSFER:
-                index      = AllocResource<DBufferVulkan, MAX_RESOURCES>(_transferBuffers);
+                index      = AllocResource(_transferBuffers, EResourceType::TRANSFER);
                 usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
                 buffer     = &_transferBuffers.at(index);
                 break;
             case EResourceType::INDIRECT_DRAW_COMMAND:
-                index      = AllocResource<DBufferVulkan, MAX_RESOURCES>(_indirectBuffers);
-                usageFlags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+                index      = AllocResource(_indirectBuffers, EResourceType::INDIRECT_DRAW_COMMAND);
+                usageFlags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
                 buffer     = &_indirectBuffers.at(index);
                 break;
             default:
@@ -737,7 +1022,13 @@ VulkanContext::CreateBuffer(uint32_t size, EResourceType type, EMemoryUsage usag
                 break;
         }
 
-    return *ResourceId(type, buffer->Id, index);
+    if (type == EResourceType::UNIFORM_BUFFER || type == EResourceType::VERTEX_INDEX_BUFFER)
+        {
+            const VkDescriptorBufferInfo bufferInfo{ buffer->Buffer.Buffer, 0, VK_WHOLE_SIZE };
+            _writeBindlessDescriptor(type == EResourceType::UNIFORM_BUFFER ? EBindlessHeapBinding::UNIFORM_BUFFERS : EBindlessHeapBinding::VERTEX_INDEX_BUFFERS, (uint32_t)index, nullptr, &bufferInfo);
+        }
+
+    return buffer->Id;
 }
 
 void*
@@ -804,35 +1095,49 @@ void
 VulkanContext::DestroyBuffer(BufferId buffer)
 {
 
-    const auto     resourceType = ResourceId(buffer).First();
-    const auto     index        = ResourceId(buffer).Value();
-    DBufferVulkan* bufferPtr{};
+    const auto                                     resourceType = ResourceId(buffer).First();
+    const auto                                     index        = ResourceId(buffer).Value();
+    RIResourceTable<DBufferVulkan>* table{};
 
     switch (resourceType)
         {
             case EResourceType::UNIFORM_BUFFER:
-                bufferPtr = &_uniformBuffers.at(index);
+                table = &_uniformBuffers;
                 break;
             case EResourceType::VERTEX_INDEX_BUFFER:
-                bufferPtr = &_vertexBuffers.at(index);
+                table = &_vertexBuffers;
                 break;
             case EResourceType::TRANSFER:
-                bufferPtr = &_transferBuffers.at(index);
+                table = &_transferBuffers;
+                break;
+            case EResourceType::INDIRECT_DRAW_COMMAND:
+                table = &_indirectBuffers;
                 break;
             default:
                 check(0); // Invalid type
                 break;
         }
+    DBufferVulkan* bufferPtr = &table->at(index);
     check(IsValidId(bufferPtr->Id));
-    bufferPtr->Id = FREE;
-    Device.DestroyBuffer(bufferPtr->Buffer);
+    bufferPtr->Id = PENDING_DESTROY;
+
+    // Submitted frames might still read it, also through its bindless heap slot
+    _deferDestruction([this, table, resourceType, index]() {
+        if (resourceType == EResourceType::UNIFORM_BUFFER || resourceType == EResourceType::VERTEX_INDEX_BUFFER)
+            {
+                const VkDescriptorBufferInfo bufferInfo{ _emptyUbo.Buffer.Buffer, 0, VK_WHOLE_SIZE };
+                _writeBindlessDescriptor(resourceType == EResourceType::UNIFORM_BUFFER ? EBindlessHeapBinding::UNIFORM_BUFFERS : EBindlessHeapBinding::VERTEX_INDEX_BUFFERS, (uint32_t)index, nullptr, &bufferInfo);
+            }
+        Device.DestroyBuffer(table->at(index).Buffer);
+        FreeResource(*table, index);
+    });
 }
 
 ImageId
 VulkanContext::CreateImage(EFormat format, uint32_t width, uint32_t height, uint32_t mipMapCount)
 {
 
-    const auto    index = AllocResource<DImageVulkan, MAX_RESOURCES>(_images);
+    const auto    index = AllocResource(_images, EResourceType::IMAGE);
     DImageVulkan& image = _images.at(index);
 
     const auto vkFormat = VkUtils::convertFormat(format);
@@ -847,6 +1152,7 @@ VulkanContext::CreateImage(EFormat format, uint32_t width, uint32_t height, uint
     VK_IMAGE_LAYOUT_UNDEFINED);
 
     image.ImageAspect = VkUtils::isColorFormat(vkFormat) ? VK_IMAGE_ASPECT_COLOR_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+    InitializeSubresourceStates(image.States, mipMapCount, 1, EResourceState::UNDEFINED);
 
     const VkResult result = Device.CreateImageView(vkFormat, image.Image.Image, image.ImageAspect, 0, mipMapCount, &image.View);
     if (VKFAILED(result))
@@ -857,13 +1163,16 @@ VulkanContext::CreateImage(EFormat format, uint32_t width, uint32_t height, uint
     // Create default sampler
     image.Sampler = Device.CreateSampler(VK_FILTER_NEAREST, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, 0, mipMapCount, VK_SAMPLER_MIPMAP_MODE_NEAREST, true, 16);
 
-    return *ResourceId(EResourceType::IMAGE, image.Id, index);
+    const VkDescriptorImageInfo imageInfo{ VK_NULL_HANDLE, image.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    _writeBindlessDescriptor(EBindlessHeapBinding::IMAGES, (uint32_t)index, &imageInfo, nullptr);
+
+    return image.Id;
 }
 
 EFormat
 VulkanContext::GetImageFormat(ImageId imageId) const
 {
-    const DImageVulkan& resource = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, imageId);
+    const DImageVulkan& resource = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, imageId);
 
     return VkUtils::convertVkFormat(resource.Image.Format);
 }
@@ -871,56 +1180,51 @@ VulkanContext::GetImageFormat(ImageId imageId) const
 void
 VulkanContext::DestroyImage(ImageId imageId)
 {
-    auto& resource = GetResourceUnsafe<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, imageId);
+    auto& resource = GetResourceUnsafe<DImageVulkan, EResourceType::IMAGE>(_images, imageId);
     check(IsValidId(resource.Id));
     resource.Id = PENDING_DESTROY;
 
     _deferDestruction([this, imageId]() {
-        auto& resource = GetResourceUnsafe<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, imageId);
+        auto& resource = GetResourceUnsafe<DImageVulkan, EResourceType::IMAGE>(_images, imageId);
+
+        const VkDescriptorImageInfo imageInfo{ VK_NULL_HANDLE, _emptyImage->View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+        _writeBindlessDescriptor(EBindlessHeapBinding::IMAGES, ResourceId(imageId).Value(), &imageInfo, nullptr);
 
         Device.DestroyImageView(resource.View);
         Device.DestroyImage(resource.Image);
         Device.DestroySampler(resource.Sampler);
 
-        resource.Id = FREE;
+        FreeResource(_images, ResourceId(imageId).Value());
     });
 }
 
 VertexInputLayoutId
 VulkanContext::CreateVertexLayout(const std::vector<VertexLayoutInfo>& info)
 {
-    const auto                index  = AllocResource<DVertexInputLayoutVulkan, MAX_RESOURCES>(_vertexLayouts);
-    DVertexInputLayoutVulkan& layout = _vertexLayouts.at(index);
-    layout.VertexInputAttributes.reserve(info.size());
-
-    unsigned int location = 0;
-    for (const auto& i : info)
-        {
-            VkVertexInputAttributeDescription attr{};
-            attr.location = location++; // uint32_t
-            attr.binding  = 0; // uint32_t
-            attr.format   = VkUtils::convertFormat(i.Format); // VkFormat
-            attr.offset   = i.ByteOffset; // uint32_t
+    std::vector<VkVertexInputAttributeDescription>                              attributes;
+    std::array<std::optional<VkVertexInputRate>, VertexLayoutInfo::MAX_STREAMS> streamInputRates;
+    // Advancing every n instances requires VK_EXT_vertex_attribute_divisor, per vertex and per instance attributes can't share a stream
+    critical(VkUtils::convertVertexLayout(info, attributes, streamInputRates));
 
-            // Emplace
-            layout.VertexInputAttributes.emplace_back(std::move(attr));
-        }
+    const auto                index  = AllocResource(_vertexLayouts, EResourceType::VERTEX_INPUT_LAYOUT);
+    DVertexInputLayoutVulkan& layout = _vertexLayouts.at(index);
+    layout.VertexInputAttributes     = std::move(attributes);
+    layout.StreamInputRates          = streamInputRates;
 
-    return *ResourceId(EResourceType::VERTEX_INPUT_LAYOUT, layout.Id, index);
+    return layout.Id;
 }
 
 ShaderId
 VulkanContext::CreateShader(const ShaderSource& source)
 {
-    check(source.ColorAttachments > 0);
+    check(source.ColorAttachments > 0 || source.SourceCode.ComputeShader.size() > 0);
 
-    const auto     index  = AllocResource<DShaderVulkan, MAX_RESOURCES>(_shaders);
+    const auto     index  = AllocResource(_shaders, EResourceType::SHADER);
     DShaderVulkan& shader = _shaders.at(index);
-    shader.Id             = GenIdentifier();
 
     _createShader(source, _shaders.at(index));
 
-    return *ResourceId(EResourceType::SHADER, shader.Id, index);
+    return shader.Id;
 }
 
 void
@@ -929,10 +1233,21 @@ VulkanContext::_createShader(const ShaderSource& source, DShaderVulkan& shader)
     constexpr uint32_t MAX_SETS_PER_POOL = 100; // Temporary, should not have a limit pool of pools
 
     shader.VertexLayout           = source.VertexLayout;
-    shader.VertexStride           = source.VertexStride;
+    shader.StreamStrides          = VkUtils::resolveStreamStrides(source);
     shader.ColorAttachments       = source.ColorAttachments;
     shader.DepthStencilAttachment = source.DepthStencilAttachment;
 
+    if (source.SourceCode.ComputeShader.size() > 0)
+        {
+            const VkResult result = VkUtils::createShaderModule(Device.Device, source.SourceCode.ComputeShader, &shader.ComputeShaderModule);
+            if (VKFAILED(result))
+                {
+                    throw std::runtime_error(VkUtils::VkErrorString(result));
+                }
+            shader.ShaderStageCreateInfo.push_back(VkUtils::createShaderStageInfo(VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT, shader.ComputeShaderModule));
+            return;
+        }
+
     // Create the shaders
     {
 
@@ -970,61 +1285,165 @@ VulkanContext::DestroyShader(const ShaderId shader)
 
         vkDestroyShaderModule(Device.Device, shaderVulkan.VertexShaderModule, nullptr);
         vkDestroyShaderModule(Device.Device, shaderVulkan.PixelShaderModule, nullptr);
-        _shaders.at(index).Id = FREE;
+        vkDestroyShaderModule(Device.Device, shaderVulkan.ComputeShaderModule, nullptr);
+        FreeResource(_shaders, index);
     });
 }
 
 uint32_t
 VulkanContext::CreateSampler(uint32_t minLod, uint32_t maxLod)
 {
-    const auto      index      = AllocResource<DSamplerVulkan, MAX_RESOURCES>(_samplers);
+    const auto      index      = AllocResource(_samplers, EResourceType::SAMPLER);
     DSamplerVulkan& samplerRef = _samplers.at(index);
 
     samplerRef.Sampler = Device.CreateSampler(VkFilter::VK_FILTER_NEAREST, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, minLod, maxLod, VK_SAMPLER_MIPMAP_MODE_LINEAR, true, 16);
 
-    return *ResourceId(EResourceType::SAMPLER, samplerRef.Id, index);
+    const VkDescriptorImageInfo samplerInfo{ samplerRef.Sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED };
+    _writeBindlessDescriptor(EBindlessHeapBinding::SAMPLERS, (uint32_t)index, &samplerInfo, nullptr);
+
+    return samplerRef.Id;
+}
+
+uint32_t
+VulkanContext::GetBindlessIndex(uint32_t resourceId) const
+{
+    // The index of the resource table slot is the index in the heap array, slots are reused only once the resource is destroyed
+    EBindlessHeapBinding binding{};
+    switch (ResourceId(resourceId).First())
+        {
+            case EResourceType::IMAGE:
+                GetResource<DImageVulkan, EResourceType::IMAGE>(_images, resourceId);
+                binding = EBindlessHeapBinding::IMAGES;
+                break;
+            case EResourceType::SAMPLER:
+                GetResource<DSamplerVulkan, EResourceType::SAMPLER>(_samplers, resourceId);
+                binding = EBindlessHeapBinding::SAMPLERS;
+                break;
+            case EResourceType::UNIFORM_BUFFER:
+                GetResource<DBufferVulkan, EResourceType::UNIFORM_BUFFER>(_uniformBuffers, resourceId);
+                binding = EBindlessHeapBinding::UNIFORM_BUFFERS;
+                break;
+            case EResourceType::VERTEX_INDEX_BUFFER:
+                GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER>(_vertexBuffers, resourceId);
+                binding = EBindlessHeapBinding::VERTEX_INDEX_BUFFERS;
+                break;
+            default:
+                critical(false); // Not a resource of the bindless heap
+                break;
+        }
+
+    const uint32_t index = ResourceId(resourceId).Value();
+    critical(index < _bindlessHeap.Sizes[(size_t)binding]); // The heap array is full, increase DContextConfig::bindlessHeapSize
+    return index;
 }
 
 uint32_t
 VulkanContext::CreatePipeline(const ShaderId shader, uint32_t rootSignatureId, const DPipelineAttachments& attachments, const PipelineFormat& format)
 {
-    const auto       index = AllocResource<DPipelineVulkan, MAX_RESOURCES>(_pipelines);
+    const auto       index = AllocResource(_pipelines, EResourceType::GRAPHICS_PIPELINE);
     DPipelineVulkan& pso   = _pipelines.at(index);
 
-    const auto&           shaderRef     = GetResource<DShaderVulkan, EResourceType::SHADER, MAX_RESOURCES>(_shaders, shader);
-    const DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE, MAX_RESOURCES>(_rootSignatures, rootSignatureId);
+    const auto&           shaderRef     = GetResource<DShaderVulkan, EResourceType::SHADER>(_shaders, shader);
+    const DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE>(_rootSignatures, rootSignatureId);
 
     pso.PipelineLayout = &rootSignature.PipelineLayout;
+    pso.BindlessHeap   = rootSignature.BindlessHeap;
+
+    auto& vertexLayout = GetResource<DVertexInputLayoutVulkan, EResourceType::VERTEX_INPUT_LAYOUT>(_vertexLayouts, shaderRef.VertexLayout);
+
+    if (_dynamicRendering)
+        {
+            VkFormat colorFormats[DFramebufferAttachments::MAX_ATTACHMENTS]{};
+
+            VkPipelineRenderingCreateInfoKHR renderingInfo{};
+            renderingInfo.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+            renderingInfo.pColorAttachmentFormats = colorFormats;
+            for (const auto attachmentFormat : attachments.RenderTargets)
+                {
+                    if (attachmentFormat == EFormat::INVALID)
+                        break;
+                    colorFormats[renderingInfo.colorAttachmentCount++] = VkUtils::convertFormat(attachmentFormat);
+                }
+            if (attachments.DepthStencil != EFormat::INVALID)
+                {
+                    const auto depthFormat              = VkUtils::convertFormat(attachments.DepthStencil);
+                    renderingInfo.depthAttachmentFormat = depthFormat;
+                    if (VkUtils::formatHasStencil(depthFormat))
+                        {
+                            renderingInfo.stencilAttachmentFormat = depthFormat;
+                        }
+                }
 
-    auto  rpAttachments = _createGenericRenderPassAttachmentsFromPipelineAttachments(attachments);
-    auto  renderPassVk  = _createRenderPass(rpAttachments);
-    auto& vertexLayout  = GetResource<DVertexInputLayoutVulkan, EResourceType::VERTEX_INPUT_LAYOUT, MAX_RESOURCES>(_vertexLayouts, shaderRef.VertexLayout);
-    pso.Pipeline        = _createPipeline(rootSignature.PipelineLayout, renderPassVk, shaderRef.ShaderStageCreateInfo, format, vertexLayout, shaderRef.VertexStride);
+            pso.Pipeline = _createPipeline(rootSignature.PipelineLayout, VK_NULL_HANDLE, shaderRef.ShaderStageCreateInfo, format, vertexLayout, shaderRef.StreamStrides, &renderingInfo);
+        }
+    else
+        {
+            auto rpAttachments = _createGenericRenderPassAttachmentsFromPipelineAttachments(attachments);
+            auto renderPassVk  = _createRenderPass(rpAttachments);
+            pso.Pipeline       = _createPipeline(rootSignature.PipelineLayout, renderPassVk, shaderRef.ShaderStageCreateInfo, format, vertexLayout, shaderRef.StreamStrides, nullptr);
+        }
+
+    return pso.Id;
+}
+
+uint32_t
+VulkanContext::CreateComputePipeline(const ShaderId shader, uint32_t rootSignatureId)
+{
+    const auto&           shaderRef     = GetResource<DShaderVulkan, EResourceType::SHADER>(_shaders, shader);
+    const DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE>(_rootSignatures, rootSignatureId);
+    check(shaderRef.ComputeShaderModule != nullptr); // Must be a compute shader
+
+    VkComputePipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineInfo.stage  = shaderRef.ShaderStageCreateInfo.front();
+    pipelineInfo.layout = rootSignature.PipelineLayout;
+
+    // Shares the table of the graphics pipelines, the id type tells them apart
+    const auto       index = AllocResource(_pipelines, EResourceType::COMPUTE_PIPELINE);
+    DPipelineVulkan& pso   = _pipelines.at(index);
+    pso.Pipeline           = Device.CreatePipeline(&pipelineInfo);
+    pso.PipelineLayout     = &rootSignature.PipelineLayout;
+    pso.BindlessHeap       = rootSignature.BindlessHeap;
 
-    return *ResourceId(EResourceType::GRAPHICS_PIPELINE, pso.Id, index);
+    return pso.Id;
 }
 
 void
 VulkanContext::DestroyPipeline(uint32_t pipelineId)
 {
-    auto& pipelineRef = GetResource<DPipelineVulkan, EResourceType::GRAPHICS_PIPELINE, MAX_RESOURCES>(_pipelines, pipelineId);
+    auto& pipelineRef = ResourceId(pipelineId).First() == EResourceType::COMPUTE_PIPELINE ?
+    GetResource<DPipelineVulkan, EResourceType::COMPUTE_PIPELINE>(_pipelines, pipelineId) :
+    GetResource<DPipelineVulkan, EResourceType::GRAPHICS_PIPELINE>(_pipelines, pipelineId);
 
     Device.DestroyPipeline(pipelineRef.Pipeline);
-    pipelineRef.Id = FREE;
+    FreeResource(_pipelines, ResourceId(pipelineId).Value());
 }
 
 uint32_t
 VulkanContext::CreateRootSignature(const ShaderLayout& layout)
 {
     check(layout.SetsLayout.size() < (uint32_t)EDescriptorFrequency::MAX_COUNT);
+    critical(!layout.BindlessHeap || layout.SetsLayout.count(ShaderLayout::BINDLESS_HEAP_SET) == 0); // The heap takes the set
 
-    const auto      index         = AllocResource<DRootSignature, MAX_RESOURCES>(_rootSignatures);
+    const auto      index         = AllocResource(_rootSignatures, EResourceType::ROOT_SIGNATURE);
     DRootSignature& rootSignature = _rootSignatures.at(index);
+    rootSignature.BindlessHeap    = layout.BindlessHeap;
 
     std::vector<VkDescriptorSetLayout>        descriptorSetLayout;
+    if (layout.BindlessHeap)
+        {
+            descriptorSetLayout.push_back(_bindlessHeap.Layout);
+        }
     std::map<uint32_t, VkDescriptorSetLayout> setIndexToSetLayout;
+    size_t                                    bindingCount{};
+    size_t                                    computeBindingCount{};
     for (const auto& setPair : layout.SetsLayout)
         {
+            for (const auto& bindingPair : setPair.second)
+                {
+                    bindingCount++;
+                    computeBindingCount += bindingPair.second.Stage == EShaderStage::COMPUTE ? 1 : 0;
+                }
+
             const auto descriptorSetBindings                  = VkUtils::convertDescriptorBindings(setPair.second);
             rootSignature.DescriptorSetLayouts[setPair.first] = Device.CreateDescriptorSetLayout(descriptorSetBindings);
             descriptorSetLayout.push_back(rootSignature.DescriptorSetLayouts[setPair.first]);
@@ -1035,8 +1454,18 @@ VulkanContext::CreateRootSignature(const ShaderLayout& layout)
             rootSignature.PoolSizes[setPair.first] = VkUtils::computeDescriptorSetsPoolSize(setBindings);
         }
 
+    for (const auto& range : layout.PushConstants)
+        {
+            bindingCount++;
+            computeBindingCount += range.Stage == EShaderStage::COMPUTE ? 1 : 0;
+        }
+    check(VkUtils::fitsPushConstantSize(layout.PushConstants, Device.DeviceProperties.limits.maxPushConstantsSize)); // Must fit in the device push constant size
+
+    critical(computeBindingCount == 0 || computeBindingCount == bindingCount); // Compute and graphics bindings can't be mixed
+    rootSignature.BindPoint = computeBindingCount > 0 ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+
     // Can return already cached pipeline layout if exists
-    rootSignature.PipelineLayout = Device.CreatePipelineLayout(descriptorSetLayout, {});
+    rootSignature.PipelineLayout = Device.CreatePipelineLayout(descriptorSetLayout, VkUtils::convertPushConstantRanges(layout.PushConstants));
 
     rootSignature.SetsBindings = layout.SetsLayout;
 
@@ -1062,91 +1491,19 @@ VulkanContext::CreateRootSignature(const ShaderLayout& layout)
                     }
 
                 // Update with empty resources
-                std::array<VkWriteDescriptorSet, 8196>   write;
-                std::array<VkDescriptorImageInfo, 8196>  imageInfo;
-                std::array<VkDescriptorBufferInfo, 8196> bufferInfo;
-                uint32_t                                 writeSetCount{};
-                uint32_t                                 imageInfoCount{};
-                uint32_t                                 bufferInfoCount{};
-
-                for (const auto index : rootSignature.SetsBindings[i])
-                    {
-                        check(index.second.Count < 8196);
-
-                        const uint32_t descriptorCount = std::max(1u, index.second.Count);
-
-                        VkWriteDescriptorSet* writeSet = &write[writeSetCount++];
-                        writeSet->sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                        writeSet->pNext                = NULL;
-                        writeSet->descriptorCount      = descriptorCount;
-
-                        const ShaderDescriptorBindings& bindingDesc = index.second;
-                        switch (bindingDesc.StorageType)
-                            {
-                                case EBindingType::STORAGE_BUFFER_OBJECT:
-                                    {
-                                        writeSet->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                                        check(0); // UNSUPPORTED YET
-                                    }
-                                    break;
-                                case EBindingType::UNIFORM_BUFFER_OBJECT:
-                                    {
-                                        writeSet->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                                        writeSet->pBufferInfo    = &bufferInfo[bufferInfoCount];
-                                        for (uint32_t j = 0; j < descriptorCount; j++)
-                                            {
-                                                VkDescriptorBufferInfo& buf = bufferInfo[bufferInfoCount++];
-                                                buf.buffer                  = _emptyUbo.Buffer.Buffer;
-                                                buf.offset                  = 0;
-                                                buf.range                   = VK_WHOLE_SIZE;
-                                            }
-                                    }
-                                    break;
-                                case EBindingType::TEXTURE:
-                                    {
-                                        writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-                                        writeSet->pImageInfo     = &imageInfo[imageInfoCount];
-
-                                        for (uint32_t i = 0; i < descriptorCount; i++)
-                                            {
-                                                VkDescriptorImageInfo& img = imageInfo[imageInfoCount++];
-                                                img.imageView              = _emptyImage->View;
-                                                img.imageLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                                                img.sampler                = NULL;
-                                            }
-                                    }
-                                    break;
-                                case EBindingType::SAMPLER:
-                                    {
-                                        writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-                                        writeSet->pImageInfo     = &imageInfo[imageInfoCount];
-
-                                        for (uint32_t i = 0; i < descriptorCount; i++)
-                                            {
-                                                VkDescriptorImageInfo& img = imageInfo[imageInfoCount++];
-                                                img.imageView              = 0;
-                                                img.imageLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
-                                                img.sampler                = _emptySampler.Sampler;
-                                            }
-                                    }
-                                    break;
-                            }
-
-                        writeSet->dstArrayElement = 0;
-                        writeSet->dstBinding      = index.first;
-                        writeSet->dstSet          = rootSignature.EmptySet[i];
-                    }
-                vkUpdateDescriptorSets(Device.Device, writeSetCount, write.data(), 0, nullptr);
+                _queueEmptyDescriptorWrites(rootSignature.EmptySet[i], rootSignature.SetsBindings[i]);
             }
     }
 
-    return *ResourceId(EResourceType::ROOT_SIGNATURE, rootSignature.Id, index);
+    return rootSignature.Id;
 }
 
 void
 VulkanContext::DestroyRootSignature(uint32_t rootSignatureId)
 {
-    DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE, MAX_RESOURCES>(_rootSignatures, rootSignatureId);
+    DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE>(_rootSignatures, rootSignatureId);
+    // The queued writes of its empty sets use the set layouts
+    FlushDescriptorWrites();
 
     // Check if the pipeline layout is not shader among other root signatures
     const auto usages = std::count_if(_rootSignatures.begin(), _rootSignatures.end(), [layout = rootSignature.PipelineLayout](const DRootSignature& root) {
@@ -1168,7 +1525,7 @@ VulkanContext::DestroyRootSignature(uint32_t rootSignatureId)
                 }
         }
 
-    rootSignature.Id = FREE;
+    FreeResource(_rootSignatures, ResourceId(rootSignatureId).Value());
     memset(rootSignature.DescriptorSetLayouts, NULL, sizeof(rootSignature.DescriptorSetLayouts));
     for (auto it = 0; it < (uint32_t)EDescriptorFrequency::MAX_COUNT; it++)
         {
@@ -1181,20 +1538,20 @@ VulkanContext::DestroyRootSignature(uint32_t rootSignatureId)
 uint32_t
 VulkanContext::CreateDescriptorSets(uint32_t rootSignatureId, EDescriptorFrequency frequency, uint32_t count)
 {
-    DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE, MAX_RESOURCES>(_rootSignatures, rootSignatureId);
+    DRootSignature& rootSignature = GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE>(_rootSignatures, rootSignatureId);
+    critical(!rootSignature.BindlessHeap || (uint32_t)frequency != ShaderLayout::BINDLESS_HEAP_SET); // The set is the bindless heap
 
-    const auto index            = AllocResource<DDescriptorSet, MAX_RESOURCES>(_descriptorSets);
+    const auto index            = AllocResource(_descriptorSets, EResourceType::DESCRIPTOR_SET);
     auto&      descriptorSetRef = _descriptorSets.at(index);
 
     descriptorSetRef.Bindings       = rootSignature.SetsBindings[(uint32_t)frequency];
-    descriptorSetRef.RootSignature  = &GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE, MAX_RESOURCES>(_rootSignatures, rootSignatureId);
+    descriptorSetRef.RootSignature  = &GetResource<DRootSignature, EResourceType::ROOT_SIGNATURE>(_rootSignatures, rootSignatureId);
     descriptorSetRef.DescriptorPool = Device.CreateDescriptorPool(rootSignature.PoolSizes[(uint32_t)frequency], count);
     descriptorSetRef.Sets.resize(count);
+    descriptorSetRef.SampledTextures.assign(count, {});
     descriptorSetRef.Frequency = frequency;
 
-    check(count < 8196);
-    std::array<VkDescriptorSetLayout, 8196> descriptorSetLayouts;
-    std::fill(descriptorSetLayouts.begin(), descriptorSetLayouts.begin() + count, rootSignature.DescriptorSetLayouts[(uint32_t)frequency]);
+    const std::vector<VkDescriptorSetLayout> descriptorSetLayouts(count, rootSignature.DescriptorSetLayouts[(uint32_t)frequency]);
     {
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -1213,139 +1570,64 @@ VulkanContext::CreateDescriptorSets(uint32_t rootSignatureId, EDescriptorFrequen
     const auto& setBinding = rootSignature.SetsBindings[(uint32_t)frequency];
     for (const auto set : descriptorSetRef.Sets)
         {
-
-            std::array<VkWriteDescriptorSet, 8196>   write;
-            std::array<VkDescriptorImageInfo, 8196>  imageInfo;
-            std::array<VkDescriptorBufferInfo, 8196> bufferInfo;
-            uint32_t                                 writeSetCount{};
-            uint32_t                                 imageInfoCount{};
-            uint32_t                                 bufferInfoCount{};
-
-            for (const auto index : setBinding)
-                {
-                    check(index.second.Count < 8196);
-
-                    const uint32_t descriptorCount = std::max(1u, index.second.Count);
-
-                    VkWriteDescriptorSet* writeSet = &write[writeSetCount++];
-                    writeSet->sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    writeSet->pNext                = NULL;
-                    writeSet->descriptorCount      = descriptorCount;
-
-                    const ShaderDescriptorBindings& bindingDesc = index.second;
-                    switch (bindingDesc.StorageType)
-                        {
-                            case EBindingType::STORAGE_BUFFER_OBJECT:
-                                {
-                                    writeSet->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                                    check(0); // UNSUPPORTED YET
-                                }
-                                break;
-                            case EBindingType::UNIFORM_BUFFER_OBJECT:
-                                {
-                                    writeSet->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                                    writeSet->pBufferInfo    = &bufferInfo[bufferInfoCount];
-                                    for (uint32_t j = 0; j < descriptorCount; j++)
-                                        {
-                                            VkDescriptorBufferInfo& buf = bufferInfo[bufferInfoCount++];
-                                            buf.buffer                  = _emptyUbo.Buffer.Buffer;
-                                            buf.offset                  = 0;
-                                            buf.range                   = VK_WHOLE_SIZE;
-                                        }
-                                }
-                                break;
-                            case EBindingType::TEXTURE:
-                                {
-                                    writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-                                    writeSet->pImageInfo     = &imageInfo[imageInfoCount];
-
-                                    for (uint32_t i = 0; i < descriptorCount; i++)
-                                        {
-                                            VkDescriptorImageInfo& img = imageInfo[imageInfoCount++];
-                                            img.imageView              = _emptyImage->View;
-                                            img.imageLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                                            img.sampler                = NULL;
-                                        }
-                                }
-                                break;
-                            case EBindingType::SAMPLER:
-                                {
-                                    writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-                                    writeSet->pImageInfo     = &imageInfo[imageInfoCount];
-
-                                    for (uint32_t i = 0; i < descriptorCount; i++)
-                                        {
-                                            VkDescriptorImageInfo& img = imageInfo[imageInfoCount++];
-                                            img.imageView              = 0;
-                                            img.imageLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
-                                            img.sampler                = _emptySampler.Sampler;
-                                        }
-                                }
-                                break;
-                        }
-
-                    writeSet->dstArrayElement = 0;
-                    writeSet->dstBinding      = index.first;
-                    writeSet->dstSet          = set;
-                }
-            vkUpdateDescriptorSets(Device.Device, writeSetCount, write.data(), 0, nullptr);
+            _queueEmptyDescriptorWrites(set, setBinding);
         }
 
-    return *ResourceId(EResourceType::DESCRIPTOR_SET, descriptorSetRef.Id, index);
+    return descriptorSetRef.Id;
 }
 
 void
 VulkanContext::DestroyDescriptorSet(uint32_t descriptorSetId)
 {
-    DDescriptorSet& descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET, MAX_RESOURCES>(_descriptorSets, descriptorSetId);
+    DDescriptorSet& descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET>(_descriptorSets, descriptorSetId);
+    // Queued writes might target its sets, they must be applied before the pool frees them
+    FlushDescriptorWrites();
     Device.DestroyDescriptorPool(descriptorSetRef.DescriptorPool);
 
     descriptorSetRef.Sets.clear();
+    descriptorSetRef.SampledTextures.clear();
 
-    descriptorSetRef.Id = FREE;
+    FreeResource(_descriptorSets, ResourceId(descriptorSetId).Value());
 }
 
 void
 VulkanContext::UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex, uint32_t paramCount, DescriptorData* params)
 {
-    const DDescriptorSet& descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET, MAX_RESOURCES>(_descriptorSets, descriptorSetId);
+    DDescriptorSet& descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET>(_descriptorSets, descriptorSetId);
+    const auto      set              = descriptorSetRef.Sets.at(setIndex);
 
-    check(paramCount < 8196);
-    std::array<VkWriteDescriptorSet, 8196>   write;
-    std::array<VkDescriptorImageInfo, 8196>  imageInfo;
-    std::array<VkDescriptorBufferInfo, 8196> bufferInfo;
-    uint32_t                                 writeSetCount{};
-    uint32_t                                 imageInfoCount{};
-    uint32_t                                 bufferInfoCount{};
+    // Applied with the other queued writes before the next set is bound
+    std::lock_guard<std::mutex> lock(_descriptorWritesMutex);
     for (uint32_t i = 0; i < paramCount; i++)
         {
             DescriptorData* param           = &params[i];
             const uint32_t  descriptorCount = std::max(1u, param->Count);
 
-            VkWriteDescriptorSet* writeSet = &write[writeSetCount++];
-            writeSet->sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeSet->pNext                = NULL;
-            writeSet->descriptorCount      = descriptorCount;
-
             const ShaderDescriptorBindings& bindingDesc = descriptorSetRef.Bindings.at(param->Index);
             switch (bindingDesc.StorageType)
                 {
                     case EBindingType::STORAGE_BUFFER_OBJECT:
                         {
-                            writeSet->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                            check(0); // UNSUPPORTED YET
+                            VkDescriptorBufferInfo* bufferInfo = _descriptorWrites.AddBufferWrite(set, param->Index, param->ArrayOffset, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, descriptorCount);
+
+                            // Any buffer but the staging ones, eg. the indirect commands written by a culling shader
+                            for (uint32_t j = 0; j < descriptorCount; j++)
+                                {
+                                    VkDescriptorBufferInfo& buf = bufferInfo[j];
+                                    buf.buffer                  = _getBuffer(param->Buffers[j]);
+                                    buf.offset                  = 0;
+                                    buf.range                   = VK_WHOLE_SIZE;
+                                }
                         }
                         break;
                     case EBindingType::UNIFORM_BUFFER_OBJECT:
                         {
-                            writeSet->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-
-                            writeSet->pBufferInfo = &bufferInfo[bufferInfoCount];
+                            VkDescriptorBufferInfo* bufferInfo = _descriptorWrites.AddBufferWrite(set, param->Index, param->ArrayOffset, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, descriptorCount);
 
                             for (uint32_t j = 0; j < descriptorCount; j++)
                                 {
-                                    VkDescriptorBufferInfo& buf    = bufferInfo[bufferInfoCount++];
-                                    const DBufferVulkan&    bufRef = GetResource<DBufferVulkan, EResourceType::UNIFORM_BUFFER, MAX_RESOURCES>(_uniformBuffers, param->Buffers[j]);
+                                    VkDescriptorBufferInfo& buf    = bufferInfo[j];
+                                    const DBufferVulkan&    bufRef = GetResource<DBufferVulkan, EResourceType::UNIFORM_BUFFER>(_uniformBuffers, param->Buffers[j]);
                                     buf.buffer                     = bufRef.Buffer.Buffer;
                                     buf.offset                     = 0;
                                     buf.range                      = VK_WHOLE_SIZE;
@@ -1354,24 +1636,23 @@ VulkanContext::UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex,
                         break;
                     case EBindingType::TEXTURE:
                         {
-                            writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-                            writeSet->pImageInfo     = &imageInfo[imageInfoCount];
+                            VkDescriptorImageInfo* imageInfo = _descriptorWrites.AddImageWrite(set, param->Index, param->ArrayOffset, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, descriptorCount);
 
                             for (uint32_t i = 0; i < descriptorCount; i++)
                                 {
-                                    VkDescriptorImageInfo& img  = imageInfo[imageInfoCount++];
+                                    VkDescriptorImageInfo& img  = imageInfo[i];
                                     const EResourceType    type = static_cast<EResourceType>(ResourceId(*param->Textures).First());
                                     switch (type)
                                         {
                                             case EResourceType::IMAGE:
                                                 {
-                                                    const auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, param->Textures[i]);
+                                                    const auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, param->Textures[i]);
                                                     img.imageView        = imageRef.View;
                                                 }
                                                 break;
                                             case EResourceType::RENDER_TARGET:
                                                 {
-                                                    const auto& rtRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, param->Textures[i]);
+                                                    const auto& rtRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, param->Textures[i]);
                                                     img.imageView     = rtRef.View;
                                                 }
                                                 break;
@@ -1382,18 +1663,20 @@ VulkanContext::UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex,
 
                                     img.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                                     img.sampler     = NULL;
+
+                                    const uint64_t slot                                 = ((uint64_t)param->Index << 32) | (param->ArrayOffset + i);
+                                    descriptorSetRef.SampledTextures.at(setIndex)[slot] = param->Textures[i];
                                 }
                         }
                         break;
                     case EBindingType::SAMPLER:
                         {
-                            writeSet->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-                            writeSet->pImageInfo     = &imageInfo[imageInfoCount];
+                            VkDescriptorImageInfo* imageInfo = _descriptorWrites.AddImageWrite(set, param->Index, param->ArrayOffset, VK_DESCRIPTOR_TYPE_SAMPLER, descriptorCount);
 
                             for (uint32_t i = 0; i < descriptorCount; i++)
                                 {
-                                    VkDescriptorImageInfo& img        = imageInfo[imageInfoCount++];
-                                    const DSamplerVulkan&  samplerRef = GetResource<DSamplerVulkan, EResourceType::SAMPLER, MAX_RESOURCES>(_samplers, param->Samplers[i]);
+                                    VkDescriptorImageInfo& img        = imageInfo[i];
+                                    const DSamplerVulkan&  samplerRef = GetResource<DSamplerVulkan, EResourceType::SAMPLER>(_samplers, param->Samplers[i]);
                                     img.imageView                     = 0;
                                     img.imageLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
                                     img.sampler                       = samplerRef.Sampler;
@@ -1401,22 +1684,67 @@ VulkanContext::UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex,
                         }
                         break;
                 }
-
-            writeSet->dstArrayElement = param->ArrayOffset;
-            writeSet->dstBinding      = param->Index;
-            writeSet->dstSet          = descriptorSetRef.Sets.at(setIndex);
         }
-
-    vkUpdateDescriptorSets(Device.Device, writeSetCount, write.data(), 0, nullptr);
+    _hasPendingDescriptorWrites.store(true, std::memory_order_release);
 }
 
-uint32_t
-VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
+void
+VulkanContext::FlushDescriptorWrites()
 {
-    const auto          index          = AllocResource<DFramebufferVulkan, MAX_RESOURCES>(_framebuffers);
-    DFramebufferVulkan& framebufferRef = _framebuffers.at(index);
-
-    const auto rpAttachments = _createGenericRenderPassAttachments(attachments);
+    // Updates must happen before the bind that uses them so they are visible here without locking
+    if (!_hasPendingDescriptorWrites.load(std::memory_order_acquire))
+        {
+            return;
+        }
+    std::lock_guard<std::mutex> lock(_descriptorWritesMutex);
+    _descriptorWrites.Flush(Device.Device);
+    _hasPendingDescriptorWrites.store(false, std::memory_order_release);
+}
+
+void
+VulkanContext::_queueEmptyDescriptorWrites(VkDescriptorSet set, const std::map<uint32_t, ShaderDescriptorBindings>& bindings)
+{
+    std::lock_guard<std::mutex> lock(_descriptorWritesMutex);
+    for (const auto& [binding, bindingDesc] : bindings)
+        {
+            const uint32_t descriptorCount = std::max(1u, bindingDesc.Count);
+            switch (bindingDesc.StorageType)
+                {
+                    case EBindingType::STORAGE_BUFFER_OBJECT:
+                    case EBindingType::UNIFORM_BUFFER_OBJECT:
+                        {
+                            const bool              storage    = bindingDesc.StorageType == EBindingType::STORAGE_BUFFER_OBJECT;
+                            VkDescriptorBufferInfo* bufferInfo = _descriptorWrites.AddBufferWrite(set, binding, 0, storage ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, descriptorCount);
+                            std::fill_n(bufferInfo, descriptorCount, VkDescriptorBufferInfo{ _emptyUbo.Buffer.Buffer, 0, VK_WHOLE_SIZE });
+                        }
+                        break;
+                    case EBindingType::TEXTURE:
+                        {
+                            VkDescriptorImageInfo* imageInfo = _descriptorWrites.AddImageWrite(set, binding, 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, descriptorCount);
+                            std::fill_n(imageInfo, descriptorCount, VkDescriptorImageInfo{ VK_NULL_HANDLE, _emptyImage->View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+                        }
+                        break;
+                    case EBindingType::SAMPLER:
+                        {
+                            VkDescriptorImageInfo* imageInfo = _descriptorWrites.AddImageWrite(set, binding, 0, VK_DESCRIPTOR_TYPE_SAMPLER, descriptorCount);
+                            std::fill_n(imageInfo, descriptorCount, VkDescriptorImageInfo{ _emptySampler.Sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED });
+                        }
+                        break;
+                    default:
+                        check(0); // Unsupported binding type
+                        break;
+                }
+        }
+    _hasPendingDescriptorWrites.store(true, std::memory_order_release);
+}
+
+uint32_t
+VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
+{
+    const auto          index          = AllocResource(_framebuffers, EResourceType::FRAMEBUFFER);
+    DFramebufferVulkan& framebufferRef = _framebuffers.at(index);
+
+    const auto rpAttachments = _createGenericRenderPassAttachments(attachments);
     const auto vkRenderPass  = _createRenderPass(rpAttachments);
 
     // Extrapolate all the renderTargetRef views
@@ -1429,7 +1757,7 @@ VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
 
     {
         // First attachment must always exists
-        const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, attachments.RenderTargets[0]);
+        const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.RenderTargets[0]);
         framebufferRef.Width        = renderTargetRef.Image.Width;
         framebufferRef.Height       = renderTargetRef.Image.Height;
     }
@@ -1437,7 +1765,7 @@ VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
     for (size_t i = 0; i < attachmentCount - depthAttachmentCount; i++)
         {
             check(attachments.RenderTargets[i] != NULL);
-            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, attachments.RenderTargets[i]);
+            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.RenderTargets[i]);
             imageViewsAttachments[i]    = renderTargetRef.View;
 
             check(renderTargetRef.Image.Width == framebufferRef.Width); // All images must have the same width
@@ -1447,7 +1775,7 @@ VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
 
     if (depthAttachmentCount)
         {
-            const auto& renderTargetRef  = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, attachments.DepthStencil);
+            const auto& renderTargetRef  = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.DepthStencil);
             imageViewsAttachments.back() = renderTargetRef.View;
 
             check(renderTargetRef.Image.Width == framebufferRef.Width); // All images must have the same width
@@ -1458,62 +1786,107 @@ VulkanContext::_createFramebuffer(const DFramebufferAttachments& attachments)
     framebufferRef.Framebuffer = Device._createFramebuffer(imageViewsAttachments, framebufferRef.Width, framebufferRef.Height, vkRenderPass);
     framebufferRef.Attachments = attachments;
 
-    return *ResourceId(EResourceType::FRAMEBUFFER, framebufferRef.Id, index);
+    _framebufferCache.emplace(attachments, framebufferRef.Id);
+
+    return framebufferRef.Id;
 }
 
 void
 VulkanContext::_destroyFramebuffer(uint32_t framebufferId)
 {
-    auto& framebufferRef = GetResource<DFramebufferVulkan, EResourceType::FRAMEBUFFER, MAX_RESOURCES>(_framebuffers, framebufferId);
+    auto& framebufferRef = GetResource<DFramebufferVulkan, EResourceType::FRAMEBUFFER>(_framebuffers, framebufferId);
+    framebufferRef.Id    = PENDING_DESTROY;
+    _framebufferCache.erase(framebufferRef.Attachments);
+
+    // Submitted render passes might still be using it
+    _deferDestruction([this, framebufferId]() {
+        std::lock_guard<std::recursive_mutex> lock(_renderPassMutex);
+        auto&                                 framebufferRef = GetResourceUnsafe<DFramebufferVulkan, EResourceType::FRAMEBUFFER>(_framebuffers, framebufferId);
+
+        Device._destroyFramebuffer(framebufferRef.Framebuffer);
+        FreeResource(_framebuffers, ResourceId(framebufferId).Value());
+    });
+}
+
+void
+VulkanContext::_destroyFramebuffersWithAttachment(uint32_t renderTargetId)
+{
+    std::lock_guard<std::recursive_mutex> lock(_renderPassMutex);
 
-    Device._destroyFramebuffer(framebufferRef.Framebuffer);
+    std::vector<uint32_t> framebuffers;
+    for (const auto& pair : _framebufferCache)
+        {
+            const DFramebufferAttachments& attachments = pair.first;
+            const bool                     referenced  = attachments.DepthStencil == renderTargetId || std::find(attachments.RenderTargets.begin(), attachments.RenderTargets.end(), renderTargetId) != attachments.RenderTargets.end();
+            if (referenced)
+                {
+                    framebuffers.push_back(pair.second);
+                }
+        }
 
-    framebufferRef.Id = FREE;
+    for (const auto framebufferId : framebuffers)
+        {
+            _destroyFramebuffer(framebufferId);
+        }
 }
 
 uint32_t
-VulkanContext::CreateCommandPool()
+VulkanContext::CreateCommandPool(EQueueType queueType)
 {
-    const auto index          = AllocResource<DCommandPoolVulkan, MAX_RESOURCES>(_commandPools);
+    const auto index          = AllocResource(_commandPools, EResourceType::COMMAND_POOL);
     auto&      commandPoolRef = _commandPools.at(index);
 
-    commandPoolRef.Pool = Device.CreateCommandPool2(Device.GetQueueFamilyIndex());
+    {
+        std::lock_guard<std::mutex> lock(_commandPoolMutex);
+        commandPoolRef.Pool = Device.CreateCommandPool2(_getQueueFamilyIndex(queueType));
+    }
+    commandPoolRef.QueueType = queueType;
 
-    return *ResourceId(EResourceType::COMMAND_POOL, commandPoolRef.Id, index);
+    return commandPoolRef.Id;
 }
 
 void
 VulkanContext::DestroyCommandPool(uint32_t commandPoolId)
 {
-    auto& commandPoolRef = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL, MAX_RESOURCES>(_commandPools, commandPoolId);
+    auto& commandPoolRef = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL>(_commandPools, commandPoolId);
 
-    Device.DestroyCommandPool2(commandPoolRef.Pool);
+    {
+        std::lock_guard<std::mutex> lock(_commandPoolMutex);
+        Device.DestroyCommandPool2(commandPoolRef.Pool);
+    }
 
     commandPoolRef.Pool = nullptr;
-    commandPoolRef.Id   = FREE;
+    FreeResource(_commandPools, ResourceId(commandPoolId).Value());
 }
 
 void
 VulkanContext::ResetCommandPool(uint32_t commandPoolId)
 {
-    auto& commandPoolRef = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL, MAX_RESOURCES>(_commandPools, commandPoolId);
+    auto& commandPoolRef = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL>(_commandPools, commandPoolId);
     Device.ResetCommandPool2(commandPoolRef.Pool);
 }
 
 uint32_t
 VulkanContext::CreateCommandBuffer(uint32_t commandPoolId)
 {
-    const auto index            = AllocResource<DCommandBufferVulkan, MAX_RESOURCES>(_commandBuffers);
+    const auto index            = AllocResource(_commandBuffers, EResourceType::COMMAND_BUFFER);
     auto&      commandBufferRef = _commandBuffers.at(index);
 
     // Reset internals
     {
-        commandBufferRef.Cmd              = nullptr;
-        commandBufferRef.ActiveRenderPass = nullptr;
-        commandBufferRef.IsRecording      = false;
+        commandBufferRef.Cmd            = nullptr;
+        commandBufferRef.IsInRenderPass = false;
+        commandBufferRef.IsRecording    = false;
+        commandBufferRef.Barriers.Clear();
+        commandBufferRef.SplitTransitions.clear();
+        commandBufferRef.UsedEvents     = 0;
+        commandBufferRef.BoundState     = {};
+        commandBufferRef.RedundantState = {};
     }
 
-    auto& commandPoolRef = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL, MAX_RESOURCES>(_commandPools, commandPoolId);
+    auto& commandPoolRef       = GetResource<DCommandPoolVulkan, EResourceType::COMMAND_POOL>(_commandPools, commandPoolId);
+    commandBufferRef.QueueType = commandPoolRef.QueueType;
+    commandBufferRef.Barriers.SetQueueType(commandPoolRef.QueueType);
 
     VkCommandBufferAllocateInfo info{};
     info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -1529,23 +1902,112 @@ VulkanContext::CreateCommandBuffer(uint32_t commandPoolId)
             throw std::runtime_error(VkUtils::VkErrorString(result));
         }
 
-    return *ResourceId(EResourceType::COMMAND_BUFFER, commandBufferRef.Id, index);
+    return commandBufferRef.Id;
 }
 
 void
 VulkanContext::DestroyCommandBuffer(uint32_t commandBufferId)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(!commandBufferRef.IsRecording); // Must not be in recording state
-    commandBufferRef.Id = FREE;
+
+    // Events might still be used by the last submission of the command buffer
+    for (const auto event : commandBufferRef.Events)
+        {
+            _deferDestruction([this, event]() { vkDestroyEvent(Device.Device, event, nullptr); });
+        }
+    commandBufferRef.Events.clear();
+    commandBufferRef.UsedEvents = 0;
+
+    FreeResource(_commandBuffers, ResourceId(commandBufferId).Value());
+}
+
+uint32_t
+VulkanContext::AcquireCommandBuffer(EQueueType queueType)
+{
+    ThreadCommandPools* threadPools{};
+    {
+        std::lock_guard<std::mutex> lock(_threadCommandPoolsMutex);
+        threadPools = &_threadCommandPools[std::this_thread::get_id()];
+    }
+
+    const size_t               frameIndex = _frameCount % NUM_OF_FRAMES_IN_FLIGHT;
+    DManagedCommandPoolVulkan& pool       = (*threadPools)[frameIndex][(size_t)queueType];
+    if (!IsValidId(pool.Pool))
+        {
+            pool.Pool  = CreateCommandPool(queueType);
+            pool.Frame = _frameCount;
+        }
+    else if (pool.Frame != _frameCount)
+        {
+            // Last used by this frame in flight or an older one, the values stamped when it last ended cover both
+            const TimelineValues& values = _frameRetireValues[frameIndex];
+            for (size_t i = 0; i < _queueTimelines.size(); i++)
+                {
+                    Device.WaitSemaphoreValue(_queueTimelines[i].Semaphore, values[i], UINT64_MAX);
+                }
+            ResetCommandPool(pool.Pool);
+            pool.Acquired = 0;
+            pool.Frame    = _frameCount;
+        }
+
+    if (pool.Acquired == pool.CommandBuffers.size())
+        {
+            pool.CommandBuffers.push_back(CreateCommandBuffer(pool.Pool));
+        }
+    return pool.CommandBuffers[pool.Acquired++];
+}
+
+void
+VulkanContext::BeginFrame()
+{
+    std::transform(_queueTimelines.begin(), _queueTimelines.end(), _frameRetireValues[_frameCount % NUM_OF_FRAMES_IN_FLIGHT].begin(), [](const DQueueTimelineVulkan& timeline) {
+        return timeline.SubmittedValue;
+    });
+    _frameCount++;
+
+    // The sets updated during the last frame are applied at once
+    FlushDescriptorWrites();
+}
+
+void
+VulkanContext::_destroyThreadCommandPools()
+{
+    for (auto& pair : _threadCommandPools)
+        {
+            for (auto& frame : pair.second)
+                {
+                    for (auto& pool : frame)
+                        {
+                            if (!IsValidId(pool.Pool))
+                                continue;
+
+                            for (const auto cmd : pool.CommandBuffers)
+                                {
+                                    DestroyCommandBuffer(cmd);
+                                }
+                            DestroyCommandPool(pool.Pool);
+                        }
+                }
+        }
+    _threadCommandPools.clear();
 }
 
 void
 VulkanContext::BeginCommandBuffer(uint32_t commandBufferId)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(!commandBufferRef.IsRecording); // Must not be in recording state
-    commandBufferRef.IsRecording = true;
+    commandBufferRef.IsRecording    = true;
+    commandBufferRef.BoundState     = {};
+    commandBufferRef.RedundantState = {};
+
+    // The previous recording has completed, events used by its split barriers can be signaled again
+    for (uint32_t i = 0; i < commandBufferRef.UsedEvents; i++)
+        {
+            vkResetEvent(Device.Device, commandBufferRef.Events[i]);
+        }
+    commandBufferRef.UsedEvents = 0;
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1554,239 +2016,1194 @@ VulkanContext::BeginCommandBuffer(uint32_t commandBufferId)
 }
 
 void
-VulkanContext::EndCommandBuffer(uint32_t commandBufferId)
+VulkanContext::EndCommandBuffer(uint32_t commandBufferId)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+
+    check(commandBufferRef.IsRecording); // Must be in recording state
+    commandBufferRef.IsRecording = false;
+
+    // If previous active render pass end it
+    _endRenderPass(commandBufferRef);
+    _endSplitTransitions(commandBufferRef);
+    _flushBarriers(commandBufferRef);
+
+    vkEndCommandBuffer(commandBufferRef.Cmd);
+}
+
+void
+VulkanContext::_compileRenderPass(const DFramebufferAttachments& colorAttachments, const DLoadOpPass& loadOP, DRenderPassVulkan& renderPassRef)
+{
+    renderPassRef.Attachments = colorAttachments;
+
+    if (_dynamicRendering)
+        {
+            _compileDynamicRendering(colorAttachments, loadOP, renderPassRef);
+            return;
+        }
+
+    std::lock_guard<std::recursive_mutex> lock(_renderPassMutex);
+
+    // Find existing framebuffer
+    const auto framebufferIt = _framebufferCache.find(colorAttachments);
+    if (framebufferIt != _framebufferCache.end())
+        {
+            renderPassRef.FramebufferId = framebufferIt->second;
+        }
+    else
+        {
+            // Create framebuffer from colorAttachments
+            renderPassRef.FramebufferId = _createFramebuffer(colorAttachments);
+        }
+    const auto& framebufferRef = GetResource<DFramebufferVulkan, EResourceType::FRAMEBUFFER>(_framebuffers, renderPassRef.FramebufferId);
+
+    // Create right render pass
+    auto renderPassAttachments = _createGenericRenderPassAttachments(colorAttachments);
+    check(renderPassAttachments.Attachments.size() <= DRenderPassVulkan::MAX_CLEAR_VALUES);
+
+    // Clear values are indexed by attachment index
+    uint32_t clearValueCount{};
+
+    // Process color colorAttachments
+    for (size_t i = 0; i < renderPassAttachments.Attachments.size(); i++)
+        {
+            VkClearValue& clearValue = renderPassRef.ClearValues[i];
+
+            auto& slot = renderPassAttachments.Attachments.at(i);
+            if (VkUtils::isColorFormat(VkUtils::convertFormat(slot.Format)))
+                {
+                    // Color
+                    slot.LoadOP  = loadOP.LoadColor[i];
+                    slot.StoreOP = loadOP.StoreActionsColor[i];
+
+                    slot.InitialLayout = ERenderPassLayout::AsAttachment;
+                    slot.FinalLayout   = ERenderPassLayout::AsAttachment;
+
+                    if (loadOP.LoadColor[i] == ERenderPassLoad::Clear)
+                        {
+                            slot.InitialLayout = ERenderPassLayout::Undefined;
+
+                            clearValue.color.float32[0] = loadOP.ClearColor[i].color.float32[0];
+                            clearValue.color.float32[1] = loadOP.ClearColor[i].color.float32[1];
+                            clearValue.color.float32[2] = loadOP.ClearColor[i].color.float32[2];
+                            clearValue.color.float32[3] = loadOP.ClearColor[i].color.float32[3];
+                            clearValueCount             = (uint32_t)i + 1;
+                        }
+                }
+            else
+                {
+                    // depth stencil
+                    slot.LoadOP  = loadOP.LoadDepth;
+                    slot.StoreOP = loadOP.StoreDepth;
+
+                    slot.InitialLayout = ERenderPassLayout::AsAttachment;
+                    slot.FinalLayout   = ERenderPassLayout::AsAttachment;
+
+                    if (loadOP.LoadDepth == ERenderPassLoad::Clear)
+                        {
+                            slot.InitialLayout              = ERenderPassLayout::Undefined;
+                            clearValue.depthStencil.depth   = loadOP.ClearDepthStencil.depth;
+                            clearValue.depthStencil.stencil = loadOP.ClearDepthStencil.stencil;
+                            clearValueCount                 = (uint32_t)i + 1;
+                        }
+                }
+        }
+
+    renderPassRef.RenderPass = _createRenderPass(renderPassAttachments);
+
+    VkRenderPassBeginInfo& renderPassInfo = renderPassRef.BeginInfo;
+    renderPassInfo.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass             = renderPassRef.RenderPass;
+    renderPassInfo.framebuffer            = framebufferRef.Framebuffer;
+    renderPassInfo.renderArea.offset      = { 0, 0 };
+    renderPassInfo.renderArea.extent      = { framebufferRef.Width, framebufferRef.Height };
+    renderPassInfo.clearValueCount        = clearValueCount;
+    renderPassInfo.pClearValues           = renderPassRef.ClearValues;
+}
+
+void
+VulkanContext::_compileDynamicRendering(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP, DRenderPassVulkan& renderPassRef)
+{
+    renderPassRef.ClearBarrierCount = 0;
+
+    uint32_t width{}, height{};
+
+    // With render passes an attachment cleared from undefined layout is transitioned by the render pass itself
+    const auto addClearBarrier = [&renderPassRef](const DRenderTargetVulkan& renderTargetRef, VkImageLayout layout, VkAccessFlags accessMask) {
+        VkImageMemoryBarrier& barrier           = renderPassRef.ClearBarriers[renderPassRef.ClearBarrierCount++];
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = accessMask;
+        barrier.dstAccessMask                   = accessMask;
+        barrier.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout                       = layout;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = renderTargetRef.Image.Image;
+        barrier.subresourceRange.aspectMask     = renderTargetRef.ImageAspect;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+    };
+
+    uint32_t colorAttachmentCount{};
+    for (; colorAttachmentCount < DFramebufferAttachments::MAX_ATTACHMENTS; colorAttachmentCount++)
+        {
+            const auto i = colorAttachmentCount;
+            if (attachments.RenderTargets[i] == NULL)
+                break;
+
+            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.RenderTargets[i]);
+            check(renderTargetRef.Image.MipLevels == 1); // Must have only 1 layer
+            width  = renderTargetRef.Image.Width;
+            height = renderTargetRef.Image.Height;
+
+            VkRenderingAttachmentInfoKHR& attachment = renderPassRef.ColorAttachments[i];
+            attachment                               = {};
+            attachment.sType                         = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+            attachment.imageView                     = renderTargetRef.View;
+            attachment.imageLayout                   = VkUtils::convertRenderPassLayout(ERenderPassLayout::AsAttachment, true);
+            attachment.loadOp                        = VkUtils::convertAttachmentLoadOp(loadOP.LoadColor[i]);
+            attachment.storeOp                       = VkUtils::convertAttachmentStoreOp(loadOP.StoreActionsColor[i]);
+
+            if (loadOP.LoadColor[i] == ERenderPassLoad::Clear)
+                {
+                    attachment.clearValue.color.float32[0] = loadOP.ClearColor[i].color.float32[0];
+                    attachment.clearValue.color.float32[1] = loadOP.ClearColor[i].color.float32[1];
+                    attachment.clearValue.color.float32[2] = loadOP.ClearColor[i].color.float32[2];
+                    attachment.clearValue.color.float32[3] = loadOP.ClearColor[i].color.float32[3];
+                    addClearBarrier(renderTargetRef, attachment.imageLayout, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+                }
+        }
+
+    bool hasDepth{}, hasStencil{};
+    if (attachments.DepthStencil != NULL)
+        {
+            const auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.DepthStencil);
+            width                       = renderTargetRef.Image.Width;
+            height                      = renderTargetRef.Image.Height;
+            hasDepth                    = true;
+            hasStencil                  = VkUtils::formatHasStencil(renderTargetRef.Image.Format);
+
+            VkRenderingAttachmentInfoKHR& depth   = renderPassRef.DepthAttachment;
+            depth                                 = {};
+            depth.sType                           = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+            depth.imageView                       = renderTargetRef.View;
+            depth.imageLayout                     = VkUtils::convertRenderPassLayout(ERenderPassLayout::AsAttachment, false);
+            depth.loadOp                          = VkUtils::convertAttachmentLoadOp(loadOP.LoadDepth);
+            depth.storeOp                         = VkUtils::convertAttachmentStoreOp(loadOP.StoreDepth);
+            depth.clearValue.depthStencil.depth   = loadOP.ClearDepthStencil.depth;
+            depth.clearValue.depthStencil.stencil = loadOP.ClearDepthStencil.stencil;
+
+            VkRenderingAttachmentInfoKHR& stencil = renderPassRef.StencilAttachment;
+            stencil                               = depth;
+            stencil.loadOp                        = VkUtils::convertAttachmentLoadOp(loadOP.LoadStencil);
+            stencil.storeOp                       = VkUtils::convertAttachmentStoreOp(loadOP.StoreStencil);
+
+            if (loadOP.LoadDepth == ERenderPassLoad::Clear)
+                {
+                    addClearBarrier(renderTargetRef, depth.imageLayout, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+                }
+        }
+    check(colorAttachmentCount > 0 || hasDepth); // Must have at least one attachment
+
+    VkRenderingInfoKHR& renderingInfo  = renderPassRef.RenderingInfo;
+    renderingInfo                      = {};
+    renderingInfo.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset    = { 0, 0 };
+    renderingInfo.renderArea.extent    = { width, height };
+    renderingInfo.layerCount           = 1;
+    renderingInfo.colorAttachmentCount = colorAttachmentCount;
+    renderingInfo.pColorAttachments    = renderPassRef.ColorAttachments;
+    renderingInfo.pDepthAttachment     = hasDepth ? &renderPassRef.DepthAttachment : nullptr;
+    renderingInfo.pStencilAttachment   = hasStencil ? &renderPassRef.StencilAttachment : nullptr;
+}
+
+void
+VulkanContext::_beginRenderPass(uint32_t commandBufferId, const DRenderPassVulkan& renderPassRef)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+    // If previous active render pass end it
+    _endRenderPass(commandBufferRef);
+
+    if (_automaticBarriers)
+        {
+            _transitionAttachments(commandBufferId, renderPassRef.Attachments);
+        }
+
+    if (_dynamicRendering)
+        {
+            // Recorded after the queued barriers, they may transition the same attachments
+            _flushBarriers(commandBufferRef);
+            if (renderPassRef.ClearBarrierCount > 0)
+                {
+                    constexpr VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                    vkCmdPipelineBarrier(commandBufferRef.Cmd, stageMask, stageMask, 0, 0, NULL, 0, NULL, renderPassRef.ClearBarrierCount, renderPassRef.ClearBarriers);
+                }
+            vkCmdBeginRenderingKHR(commandBufferRef.Cmd, &renderPassRef.RenderingInfo);
+        }
+    else
+        {
+            _flushBarriers(commandBufferRef);
+            vkCmdBeginRenderPass(commandBufferRef.Cmd, &renderPassRef.BeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+    commandBufferRef.IsInRenderPass = true;
+}
+
+void
+VulkanContext::_endRenderPass(DCommandBufferVulkan& commandBufferRef)
+{
+    if (commandBufferRef.IsInRenderPass)
+        {
+            if (_dynamicRendering)
+                {
+                    vkCmdEndRenderingKHR(commandBufferRef.Cmd);
+                }
+            else
+                {
+                    vkCmdEndRenderPass(commandBufferRef.Cmd);
+                }
+            commandBufferRef.IsInRenderPass = false;
+        }
+}
+
+void
+VulkanContext::_queueImageBarrier(DCommandBufferVulkan& commandBufferRef, VkImage image, VkImageAspectFlags aspect, EResourceState currentState, EResourceState newState, uint32_t mipLevel, uint32_t levelCount, uint32_t arrayLayer, uint32_t layerCount, EResourceState aliasedState)
+{
+    // A barrier overlapping a queued transition of the same image is refused, the queued ones must be recorded first.
+    // Always added to an empty batch
+    if (_synchronization2)
+        {
+            const auto barrier = MakeImageBarrier2(image, aspect, currentState, newState, mipLevel, levelCount, arrayLayer, layerCount, aliasedState);
+            if (!commandBufferRef.Barriers.Add(barrier))
+                {
+                    _flushBarriers(commandBufferRef);
+                    commandBufferRef.Barriers.Add(barrier);
+                }
+        }
+    else
+        {
+            const auto barrier = MakeImageBarrier(image, aspect, currentState, newState, mipLevel, levelCount, arrayLayer, layerCount, aliasedState);
+            if (!commandBufferRef.Barriers.Add(barrier))
+                {
+                    _flushBarriers(commandBufferRef);
+                    commandBufferRef.Barriers.Add(barrier);
+                }
+        }
+}
+
+void
+VulkanContext::_queueBufferBarrier(DCommandBufferVulkan& commandBufferRef, VkBuffer buffer, EResourceState currentState, EResourceState newState)
+{
+    if (_synchronization2)
+        {
+            const auto barrier = MakeBufferBarrier2(buffer, currentState, newState);
+            if (!commandBufferRef.Barriers.Add(barrier))
+                {
+                    _flushBarriers(commandBufferRef);
+                    commandBufferRef.Barriers.Add(barrier);
+                }
+        }
+    else
+        {
+            const auto barrier = MakeBufferBarrier(buffer, currentState, newState);
+            if (!commandBufferRef.Barriers.Add(barrier))
+                {
+                    _flushBarriers(commandBufferRef);
+                    commandBufferRef.Barriers.Add(barrier);
+                }
+        }
+}
+
+void
+VulkanContext::_resourceTransition(DCommandBufferVulkan& commandBufferRef, const DTransitionVulkan& transition, bool beginOnly, bool endOnly)
+{
+    const auto sameResource = [&transition](const DSplitTransitionVulkan& split) {
+        const auto& begun = split.Transition;
+        return begun.Image == transition.Image && begun.Buffer == transition.Buffer && begun.MipLevel == transition.MipLevel && begun.LevelCount == transition.LevelCount &&
+        begun.ArrayLayer == transition.ArrayLayer && begun.LayerCount == transition.LayerCount;
+    };
+
+    if (transition.SrcQueueFamilyIndex != transition.DstQueueFamilyIndex)
+        {
+            // Another queue can't wait on the event, recorded as a full barrier
+            _queueOwnershipTransfer(commandBufferRef, transition);
+            return;
+        }
+
+    if (beginOnly)
+        {
+            // Signaled right after the commands recorded so far, the transition runs while the next ones execute
+            DSplitTransitionVulkan split;
+            split.Transition = transition;
+            if (commandBufferRef.UsedEvents == commandBufferRef.Events.size())
+                {
+                    VkEventCreateInfo info{ VK_STRUCTURE_TYPE_EVENT_CREATE_INFO };
+                    VkEvent           event{};
+                    const VkResult    result = vkCreateEvent(Device.Device, &info, nullptr, &event);
+                    if (VKFAILED(result))
+                        {
+                            throw std::runtime_error(VkUtils::VkErrorString(result));
+                        }
+                    commandBufferRef.Events.push_back(event);
+                }
+            split.Event = commandBufferRef.Events[commandBufferRef.UsedEvents++];
+
+            _recordSplitTransition(commandBufferRef, split, false);
+            commandBufferRef.SplitTransitions.push_back(split);
+            return;
+        }
+
+    if (endOnly)
+        {
+            auto found = std::find_if(commandBufferRef.SplitTransitions.begin(), commandBufferRef.SplitTransitions.end(), sameResource);
+            if (found != commandBufferRef.SplitTransitions.end())
+                {
+                    _recordSplitTransition(commandBufferRef, *found, true);
+                    commandBufferRef.SplitTransitions.erase(found);
+                    return;
+                }
+            Warning("EndOnly barrier without a matching BeginOnly barrier, recorded as a full barrier");
+        }
+
+    if (transition.Image != nullptr)
+        {
+            _queueImageBarrier(commandBufferRef,
+            transition.Image,
+            transition.Aspect,
+            transition.CurrentState,
+            transition.NewState,
+            transition.MipLevel,
+            transition.LevelCount,
+            transition.ArrayLayer,
+            transition.LayerCount,
+            transition.AliasedState);
+        }
+    else
+        {
+            _queueBufferBarrier(commandBufferRef, transition.Buffer, transition.CurrentState, transition.NewState);
+        }
+}
+
+void
+VulkanContext::_recordSplitTransition(DCommandBufferVulkan& commandBufferRef, const DSplitTransitionVulkan& split, bool wait)
+{
+    // Queued barriers come before in recording order, events can't be set or waited inside a render pass
+    _flushBarriers(commandBufferRef);
+    _endRenderPass(commandBufferRef);
+
+    const auto& transition = split.Transition;
+    if (_synchronization2)
+        {
+            // Set and wait must be recorded with the same dependency info
+            VkImageMemoryBarrier2KHR  imageBarrier{};
+            VkBufferMemoryBarrier2KHR bufferBarrier{};
+            VkDependencyInfoKHR       dependencyInfo{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR };
+            if (transition.Image != nullptr)
+                {
+                    imageBarrier = MakeImageBarrier2(
+                    transition.Image, transition.Aspect, transition.CurrentState, transition.NewState, transition.MipLevel, transition.LevelCount, transition.ArrayLayer, transition.LayerCount, transition.AliasedState);
+                    imageBarrier.srcStageMask              = VkUtils::restrictPipelineStages2(imageBarrier.srcStageMask, commandBufferRef.QueueType);
+                    imageBarrier.dstStageMask              = VkUtils::restrictPipelineStages2(imageBarrier.dstStageMask, commandBufferRef.QueueType);
+                    dependencyInfo.imageMemoryBarrierCount = 1;
+                    dependencyInfo.pImageMemoryBarriers    = &imageBarrier;
+                }
+            else
+                {
+                    bufferBarrier                           = MakeBufferBarrier2(transition.Buffer, transition.CurrentState, transition.NewState);
+                    bufferBarrier.srcStageMask              = VkUtils::restrictPipelineStages2(bufferBarrier.srcStageMask, commandBufferRef.QueueType);
+                    bufferBarrier.dstStageMask              = VkUtils::restrictPipelineStages2(bufferBarrier.dstStageMask, commandBufferRef.QueueType);
+                    dependencyInfo.bufferMemoryBarrierCount = 1;
+                    dependencyInfo.pBufferMemoryBarriers    = &bufferBarrier;
+                }
+
+            if (wait)
+                {
+                    vkCmdWaitEvents2KHR(commandBufferRef.Cmd, 1, &split.Event, &dependencyInfo);
+                }
+            else
+                {
+                    vkCmdSetEvent2KHR(commandBufferRef.Cmd, split.Event, &dependencyInfo);
+                }
+        }
+    else
+        {
+            VkImageMemoryBarrier  imageBarrier{};
+            VkBufferMemoryBarrier bufferBarrier{};
+            VkAccessFlags         srcAccessFlags{};
+            VkAccessFlags         dstAccessFlags{};
+            if (transition.Image != nullptr)
+                {
+                    imageBarrier = MakeImageBarrier(
+                    transition.Image, transition.Aspect, transition.CurrentState, transition.NewState, transition.MipLevel, transition.LevelCount, transition.ArrayLayer, transition.LayerCount, transition.AliasedState);
+                    srcAccessFlags = imageBarrier.srcAccessMask;
+                    dstAccessFlags = imageBarrier.dstAccessMask;
+                }
+            else
+                {
+                    bufferBarrier  = MakeBufferBarrier(transition.Buffer, transition.CurrentState, transition.NewState);
+                    srcAccessFlags = bufferBarrier.srcAccessMask;
+                    dstAccessFlags = bufferBarrier.dstAccessMask;
+                }
+
+            const VkPipelineStageFlags srcStageMask = VkUtils::determinePipelineStageFlags(srcAccessFlags, commandBufferRef.QueueType);
+            const VkPipelineStageFlags dstStageMask = VkUtils::determinePipelineStageFlags(dstAccessFlags, commandBufferRef.QueueType);
+            if (wait)
+                {
+                    const bool isImage = transition.Image != nullptr;
+                    vkCmdWaitEvents(commandBufferRef.Cmd, 1, &split.Event, srcStageMask, dstStageMask, 0, NULL, isImage ? 0 : 1, &bufferBarrier, isImage ? 1 : 0, &imageBarrier);
+                }
+            else
+                {
+                    vkCmdSetEvent(commandBufferRef.Cmd, split.Event, srcStageMask);
+                }
+        }
+}
+
+void
+VulkanContext::_endSplitTransitions(DCommandBufferVulkan& commandBufferRef)
+{
+    if (commandBufferRef.SplitTransitions.size() > 0)
+        {
+            Warning("BeginOnly barriers without a matching EndOnly barrier, ended with the command buffer");
+        }
+    for (const auto& split : commandBufferRef.SplitTransitions)
+        {
+            _recordSplitTransition(commandBufferRef, split, true);
+        }
+    commandBufferRef.SplitTransitions.clear();
+}
+
+bool
+VulkanContext::_setOwnershipTransfer(const DCommandBufferVulkan& commandBufferRef, DTransitionVulkan& transition, bool acquire, bool release, EQueueType queueType)
+{
+    if (!acquire && !release)
+        return true;
+
+    check(acquire != release); // Either half of the transfer
+    const uint32_t queueFamilyIndex      = _getQueueFamilyIndex(commandBufferRef.QueueType);
+    const uint32_t otherQueueFamilyIndex = _getQueueFamilyIndex(queueType);
+    if (queueFamilyIndex == otherQueueFamilyIndex)
+        {
+            // Both queues are of the same family, the release barrier makes the whole transition and the acquire is dropped
+            return release;
+        }
+
+    transition.SrcQueueFamilyIndex = release ? queueFamilyIndex : otherQueueFamilyIndex;
+    transition.DstQueueFamilyIndex = release ? otherQueueFamilyIndex : queueFamilyIndex;
+    return true;
+}
+
+void
+VulkanContext::_queueOwnershipTransfer(DCommandBufferVulkan& commandBufferRef, const DTransitionVulkan& transition)
+{
+    const bool release = transition.SrcQueueFamilyIndex == _getQueueFamilyIndex(commandBufferRef.QueueType);
+    const auto queue   = [this, &commandBufferRef](const auto& barrier) {
+        // Never merged with another transition of the resource, always added to an empty batch
+        if (!commandBufferRef.Barriers.Add(barrier))
+            {
+                _flushBarriers(commandBufferRef);
+                commandBufferRef.Barriers.Add(barrier);
+            }
+    };
+
+    if (transition.Image != nullptr)
+        {
+            if (_synchronization2)
+                {
+                    auto barrier = MakeImageBarrier2(
+                    transition.Image, transition.Aspect, transition.CurrentState, transition.NewState, transition.MipLevel, transition.LevelCount, transition.ArrayLayer, transition.LayerCount, transition.AliasedState);
+                    SetOwnershipTransfer(barrier, transition.SrcQueueFamilyIndex, transition.DstQueueFamilyIndex, release);
+                    queue(barrier);
+                }
+            else
+                {
+                    auto barrier = MakeImageBarrier(
+                    transition.Image, transition.Aspect, transition.CurrentState, transition.NewState, transition.MipLevel, transition.LevelCount, transition.ArrayLayer, transition.LayerCount, transition.AliasedState);
+                    SetOwnershipTransfer(barrier, transition.SrcQueueFamilyIndex, transition.DstQueueFamilyIndex, release);
+                    queue(barrier);
+                }
+        }
+    else
+        {
+            if (_synchronization2)
+                {
+                    auto barrier = MakeBufferBarrier2(transition.Buffer, transition.CurrentState, transition.NewState);
+                    SetOwnershipTransfer(barrier, transition.SrcQueueFamilyIndex, transition.DstQueueFamilyIndex, release);
+                    queue(barrier);
+                }
+            else
+                {
+                    auto barrier = MakeBufferBarrier(transition.Buffer, transition.CurrentState, transition.NewState);
+                    SetOwnershipTransfer(barrier, transition.SrcQueueFamilyIndex, transition.DstQueueFamilyIndex, release);
+                    queue(barrier);
+                }
+        }
+}
+
+uint32_t
+VulkanContext::_getQueueFamilyIndex(EQueueType queueType) const
+{
+    switch (queueType)
+        {
+            case EQueueType::TRANSFER:
+                return Device.GetTransferQueueFamilyIndex();
+            case EQueueType::COMPUTE:
+                return Device.GetComputeQueueFamilyIndex();
+            default:
+                return Device.GetQueueFamilyIndex();
+        }
+}
+
+VkQueue
+VulkanContext::_getQueue(EQueueType queueType) const
+{
+    switch (queueType)
+        {
+            case EQueueType::TRANSFER:
+                return Device.TransferQueue;
+            case EQueueType::COMPUTE:
+                return Device.ComputeQueue;
+            default:
+                return Device.MainQueue;
+        }
+}
+
+VkBuffer
+VulkanContext::_getBuffer(uint32_t bufferId)
+{
+    switch (ResourceId(bufferId).First())
+        {
+            case EResourceType::VERTEX_INDEX_BUFFER:
+                return GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER>(_vertexBuffers, bufferId).Buffer.Buffer;
+            case EResourceType::UNIFORM_BUFFER:
+                return GetResource<DBufferVulkan, EResourceType::UNIFORM_BUFFER>(_uniformBuffers, bufferId).Buffer.Buffer;
+            case EResourceType::TRANSFER:
+                return GetResource<DBufferVulkan, EResourceType::TRANSFER>(_transferBuffers, bufferId).Buffer.Buffer;
+            case EResourceType::INDIRECT_DRAW_COMMAND:
+                return GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND>(_indirectBuffers, bufferId).Buffer.Buffer;
+            default:
+                critical(false); // Not a buffer id
+        }
+    return nullptr;
+}
+
+void
+VulkanContext::_flushBarriers(DCommandBufferVulkan& commandBufferRef)
+{
+    if (commandBufferRef.Barriers.IsEmpty())
+        return;
+
+    // Barriers can't be recorded inside a render pass
+    _endRenderPass(commandBufferRef);
+    commandBufferRef.Barriers.Flush(commandBufferRef.Cmd);
+}
+
+/*Queues the barriers moving the subresources to newState and updates their tracked state, subresources already in newState
+are skipped and their state isn't written. Unordered access to unordered access is kept, it orders the writes*/
+void
+VulkanContext::_transitionSubresources(DCommandBufferVulkan& commandBufferRef,
+VkImage                                                       image,
+VkImageAspectFlags                                            aspect,
+DSubresourceStates&                                           states,
+EResourceState                                                newState,
+bool                                                          subresource,
+uint32_t                                                      mipLevel,
+uint32_t                                                      arrayLayer,
+EResourceState                                                aliasedState)
+{
+    const auto needsBarrier = [newState](EResourceState currentState) { return currentState != newState || newState == EResourceState::UNORDERED_ACCESS; };
+
+    // Memory used by another resource, the previous content is discarded after the accesses of the other resource
+    if (aliasedState != EResourceState::UNDEFINED)
+        {
+            const uint32_t levelCount = subresource ? 1 : VK_REMAINING_MIP_LEVELS;
+            const uint32_t layerCount = subresource ? 1 : VK_REMAINING_ARRAY_LAYERS;
+            _queueImageBarrier(commandBufferRef, image, aspect, EResourceState::UNDEFINED, newState, subresource ? mipLevel : 0, levelCount, subresource ? arrayLayer : 0, layerCount, aliasedState);
+            SetSubresourceStates(states, newState, subresource, mipLevel, arrayLayer);
+            return;
+        }
+
+    // Whole resource in the same state, a single barrier covers all the subresources
+    const auto firstState = states.States.at(0);
+    if (!subresource && std::all_of(states.States.begin(), states.States.end(), [firstState](EResourceState state) { return state == firstState; }))
+        {
+            if (needsBarrier(firstState))
+                {
+                    _queueImageBarrier(commandBufferRef, image, aspect, firstState, newState, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+                }
+            // Only read if already in the state, several threads can bind a resource transitioned before recording
+            if (firstState != newState)
+                {
+                    std::fill(states.States.begin(), states.States.end(), newState);
+                }
+            return;
+        }
+
+    for (uint32_t layer = 0; layer < states.ArrayLayers; layer++)
+        {
+            for (uint32_t mip = 0; mip < states.MipLevels; mip++)
+                {
+                    if (subresource && (layer != arrayLayer || mip != mipLevel))
+                        continue;
+
+                    auto& state = states.States[layer * states.MipLevels + mip];
+                    if (needsBarrier(state))
+                        {
+                            _queueImageBarrier(commandBufferRef, image, aspect, state, newState, mip, 1, layer, 1);
+                        }
+                    if (state != newState)
+                        {
+                            state = newState;
+                        }
+                }
+        }
+}
+
+void
+VulkanContext::_trackedResourceBarrier(uint32_t commandBufferId, uint32_t bufferBarrierCount, const BufferBarrier* bufferBarriers, uint32_t textureBarrierCount, const TextureBarrier* textureBarriers, uint32_t renderTargetBarrierCount, const RenderTargetBarrier* renderTargetBarriers)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+
+    // Buffer states aren't tracked, the state passed by the caller is used
+    for (uint32_t i = 0; i < bufferBarrierCount; i++)
+        {
+            const auto& barrier = bufferBarriers[i];
+            if (barrier.Acquire || barrier.Release)
+                {
+                    _bufferTransition(commandBufferRef, barrier);
+                    continue;
+                }
+            _queueBufferBarrier(commandBufferRef, _getBuffer(barrier.BufferId), barrier.CurrentState, barrier.NewState);
+        }
+
+    // The current state passed by the caller is ignored, the tracked one is used instead. Split barriers aren't supported,
+    // transitions are always recorded as full barriers. The two halves of an ownership transfer are recorded on different
+    // command buffers and must have the same states, they're recorded with the states passed by the caller
+    for (uint32_t i = 0; i < textureBarrierCount; i++)
+        {
+            const auto& barrier = textureBarriers[i];
+            if (barrier.Acquire || barrier.Release)
+                {
+                    _textureTransition(commandBufferRef, barrier);
+                    continue;
+                }
+
+            auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, barrier.ImageId);
+            _transitionSubresources(
+            commandBufferRef, imageRef.Image.Image, imageRef.ImageAspect, imageRef.States, barrier.NewState, barrier.mSubresourceBarrier, barrier.mMipLevel, barrier.mArrayLayer, barrier.AliasedState);
+        }
+    for (uint32_t i = 0; i < renderTargetBarrierCount; i++)
+        {
+            const auto& barrier = renderTargetBarriers[i];
+            if (barrier.mAcquire || barrier.mRelease)
+                {
+                    _renderTargetTransition(commandBufferRef, barrier);
+                    continue;
+                }
+
+            auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, barrier.RenderTarget);
+            _transitionSubresources(commandBufferRef,
+            renderTargetRef.Image.Image,
+            renderTargetRef.ImageAspect,
+            renderTargetRef.States,
+            barrier.mNewState,
+            barrier.mSubresourceBarrier,
+            barrier.mMipLevel,
+            barrier.mArrayLayer,
+            barrier.mAliasedState);
+        }
+}
+
+void
+VulkanContext::_transitionAttachments(uint32_t commandBufferId, const DFramebufferAttachments& attachments)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+
+    for (const auto renderTargetId : attachments.RenderTargets)
+        {
+            if (renderTargetId == 0)
+                break;
+
+            auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, renderTargetId);
+            _transitionSubresources(commandBufferRef, renderTargetRef.Image.Image, renderTargetRef.ImageAspect, renderTargetRef.States, EResourceState::RENDER_TARGET, false, 0, 0);
+        }
+    if (attachments.DepthStencil != 0)
+        {
+            auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, attachments.DepthStencil);
+            _transitionSubresources(commandBufferRef, renderTargetRef.Image.Image, renderTargetRef.ImageAspect, renderTargetRef.States, EResourceState::DEPTH_WRITE, false, 0, 0);
+        }
+}
+
+void
+VulkanContext::_transitionSampledTextures(uint32_t commandBufferId, const DDescriptorSet& descriptorSetRef, uint32_t setIndex)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+
+    for (const auto& slot : descriptorSetRef.SampledTextures.at(setIndex))
+        {
+            const auto textureId = slot.second;
+
+            DSubresourceStates* states{};
+            VkImage             image{};
+            VkImageAspectFlags  aspect{};
+            if (static_cast<EResourceType>(ResourceId(textureId).First()) == EResourceType::RENDER_TARGET)
+                {
+                    auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, textureId);
+                    states                = &renderTargetRef.States;
+                    image                 = renderTargetRef.Image.Image;
+                    aspect                = renderTargetRef.ImageAspect;
+                }
+            else
+                {
+                    auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, textureId);
+                    states         = &imageRef.States;
+                    image          = imageRef.Image.Image;
+                    aspect         = imageRef.ImageAspect;
+                }
+
+            // Barriers can't be flushed inside the render pass, the textures must have been transitioned before it began
+            if (commandBufferRef.IsInRenderPass)
+                {
+                    const bool ready = std::all_of(states->States.begin(), states->States.end(), [](EResourceState state) { return state == EResourceState::SHADER_RESOURCE; });
+                    if (!ready)
+                        {
+                            Warning("Descriptor set bound inside a render pass samples a texture not in SHADER_RESOURCE state, bind it before the render targets");
+                        }
+                    continue;
+                }
+
+            // Queued, flushed when the render pass sampling them begins
+            _transitionSubresources(commandBufferRef, image, aspect, *states, EResourceState::SHADER_RESOURCE, false, 0, 0);
+        }
+}
+
+void
+VulkanContext::BindRenderTargets(uint32_t commandBufferId, const DFramebufferAttachments& colorAttachments, const DLoadOpPass& loadOP)
+{
+    DRenderPassVulkan renderPass;
+    _compileRenderPass(colorAttachments, loadOP, renderPass);
+    _beginRenderPass(commandBufferId, renderPass);
+}
+
+uint32_t
+VulkanContext::CreateRenderPass(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP)
+{
+    const auto index         = AllocResource(_renderPassObjects, EResourceType::RENDER_PASS);
+    auto&      renderPassRef = _renderPassObjects.at(index);
+
+    _compileRenderPass(attachments, loadOP, renderPassRef);
+
+    return renderPassRef.Id;
+}
+
+void
+VulkanContext::DestroyRenderPass(uint32_t renderPassId)
+{
+    auto& renderPassRef = GetResource<DRenderPassVulkan, EResourceType::RENDER_PASS>(_renderPassObjects, renderPassId);
+    // VkRenderPass and framebuffer are cached and shared, they're destroyed with the context or with their render targets
+    renderPassRef.RenderPass    = nullptr;
+    renderPassRef.FramebufferId = {};
+    FreeResource(_renderPassObjects, ResourceId(renderPassId).Value());
+}
+
+void
+VulkanContext::BindRenderPass(uint32_t commandBufferId, uint32_t renderPassId)
+{
+    const auto& renderPassRef = GetResource<DRenderPassVulkan, EResourceType::RENDER_PASS>(_renderPassObjects, renderPassId);
+    check(IsRenderPassAlive(renderPassId)); // Render targets must outlive the render pass
+
+    _beginRenderPass(commandBufferId, renderPassRef);
+}
+
+const DImageVulkan&
+VulkanContext::GetImage(ImageId imageId) const
+{
+    return GetResource<DImageVulkan, EResourceType::IMAGE>(_images, imageId);
+}
+
+const DRenderTargetVulkan&
+VulkanContext::GetRenderTarget(uint32_t renderTargetId) const
+{
+    return GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, renderTargetId);
+}
+
+const DRenderPassVulkan&
+VulkanContext::GetRenderPass(uint32_t renderPassId) const
+{
+    return GetResource<DRenderPassVulkan, EResourceType::RENDER_PASS>(_renderPassObjects, renderPassId);
+}
+
+bool
+VulkanContext::IsRenderPassAlive(uint32_t renderPassId) const
+{
+    const auto& renderPassRef = GetRenderPass(renderPassId);
+    if (_dynamicRendering)
+        {
+            const auto isAlive = [this](uint32_t renderTargetId) { return renderTargetId == NULL || _renderTargets.at(ResourceId(renderTargetId).Value()).Id == renderTargetId; };
+            return std::all_of(renderPassRef.Attachments.RenderTargets.begin(), renderPassRef.Attachments.RenderTargets.end(), isAlive) && isAlive(renderPassRef.Attachments.DepthStencil);
+        }
+
+    // The framebuffer is destroyed with any of its render targets
+    return _framebuffers.at(ResourceId(renderPassRef.FramebufferId).Value()).Id == renderPassRef.FramebufferId;
+}
+
+void
+VulkanContext::SetViewport(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float znear, float zfar)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
+
+    // Invert viewport on Y
+    VkViewport viewport{ static_cast<float>(x), static_cast<float>(y) + static_cast<float>(height), static_cast<float>(width), -static_cast<float>(height), znear, zfar };
+
+    const auto& bound = commandBufferRef.BoundState.Viewport;
+    if (bound && bound->x == viewport.x && bound->y == viewport.y && bound->width == viewport.width && bound->height == viewport.height && bound->minDepth == viewport.minDepth &&
+    bound->maxDepth == viewport.maxDepth)
+        {
+            commandBufferRef.RedundantState.Viewports++;
+            return;
+        }
+    commandBufferRef.BoundState.Viewport = viewport;
+
+    vkCmdSetViewport(commandBufferRef.Cmd, 0, 1, &viewport);
+}
+
+void
+VulkanContext::SetScissor(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
+
+    VkRect2D rect{ x, y, width, height };
+
+    const auto& bound = commandBufferRef.BoundState.Scissor;
+    if (bound && bound->offset.x == rect.offset.x && bound->offset.y == rect.offset.y && bound->extent.width == rect.extent.width && bound->extent.height == rect.extent.height)
+        {
+            commandBufferRef.RedundantState.Scissors++;
+            return;
+        }
+    commandBufferRef.BoundState.Scissor = rect;
+
+    vkCmdSetScissor(commandBufferRef.Cmd, 0, 1, &rect);
+}
+
+void
+VulkanContext::BindPipeline(uint32_t commandBufferId, uint32_t pipeline)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+
+    if (ResourceId(pipeline).First() == EResourceType::COMPUTE_PIPELINE)
+        {
+            // Outside of the render passes, the compute bind point doesn't disturb the graphics one
+            auto& pipelineRef = GetResource<DPipelineVulkan, EResourceType::COMPUTE_PIPELINE>(_pipelines, pipeline);
+            _bindPipeline(commandBufferRef, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineRef);
+            return;
+        }
+
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
+
+    auto& pipelineRef = GetResource<DPipelineVulkan, EResourceType::GRAPHICS_PIPELINE>(_pipelines, pipeline);
+
+    _bindPipeline(commandBufferRef, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineRef);
+}
+
+void
+VulkanContext::_bindPipeline(DCommandBufferVulkan& commandBufferRef, VkPipelineBindPoint bindPoint, const DPipelineVulkan& pipelineRef)
+{
+    // Checked even if the pipeline is already bound, a set bound with another layout might have disturbed the heap
+    if (pipelineRef.BindlessHeap)
+        {
+            const VkPipelineLayout      layout   = *pipelineRef.PipelineLayout;
+            DBoundDescriptorSetsVulkan& boundSet = commandBufferRef.BoundState.DescriptorSets[bindPoint];
+            if (boundSet.Layout != layout)
+                {
+                    boundSet        = {};
+                    boundSet.Layout = layout;
+                }
+            if (boundSet.Sets[ShaderLayout::BINDLESS_HEAP_SET] != _bindlessHeap.Set)
+                {
+                    boundSet.Sets[ShaderLayout::BINDLESS_HEAP_SET] = _bindlessHeap.Set;
+                    vkCmdBindDescriptorSets(commandBufferRef.Cmd, bindPoint, layout, ShaderLayout::BINDLESS_HEAP_SET, 1, &_bindlessHeap.Set, 0, nullptr);
+                }
+        }
+
+    if (commandBufferRef.BoundState.Pipelines[bindPoint] == pipelineRef.Pipeline)
+        {
+            commandBufferRef.RedundantState.Pipelines++;
+            return;
+        }
+    commandBufferRef.BoundState.Pipelines[bindPoint]       = pipelineRef.Pipeline;
+    commandBufferRef.BoundState.PipelineLayouts[bindPoint] = *pipelineRef.PipelineLayout;
+
+    vkCmdBindPipeline(commandBufferRef.Cmd, bindPoint, pipelineRef.Pipeline);
+}
+
+DRedundantStateCounters
+VulkanContext::GetRedundantStateCounters(uint32_t commandBufferId) const
+{
+    const auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    return commandBufferRef.RedundantState;
+}
+
+void
+VulkanContext::BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset)
+{
+    BindVertexBuffers(commandBufferId, VertexLayoutInfo::VERTEX_STREAM, { &bufferId, 1 }, { &offset, 1 });
+}
+
+void
+VulkanContext::BindInstanceBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    BindVertexBuffers(commandBufferId, VertexLayoutInfo::INSTANCE_STREAM, { &bufferId, 1 }, { &offset, 1 });
+}
 
+void
+VulkanContext::BindVertexBuffers(uint32_t commandBufferId, uint32_t firstStream, std::span<const uint32_t> bufferIds, std::span<const uint64_t> offsets)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    commandBufferRef.IsRecording = false;
-
-    // If previous active render pass end it
-    if (commandBufferRef.ActiveRenderPass)
-        {
-            vkCmdEndRenderPass(commandBufferRef.Cmd);
-            commandBufferRef.ActiveRenderPass = nullptr;
-        }
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
+    check(bufferIds.size() == offsets.size());
+    check(bufferIds.size() > 0 && firstStream + bufferIds.size() <= VertexLayoutInfo::MAX_STREAMS);
 
-    vkEndCommandBuffer(commandBufferRef.Cmd);
+    _bindVertexBuffers(commandBufferRef, firstStream, bufferIds, offsets);
 }
 
 void
-VulkanContext::BindRenderTargets(uint32_t commandBufferId, const DFramebufferAttachments& colorAttachments, const DLoadOpPass& loadOP)
+VulkanContext::_bindVertexBuffers(DCommandBufferVulkan& commandBufferRef, uint32_t firstStream, std::span<const uint32_t> bufferIds, std::span<const uint64_t> offsets)
 {
-
-    // Find existing framebuffer
-    auto framebufferIt = std::find_if(_framebuffers.begin(), _framebuffers.end(), [colorAttachments](const DFramebufferVulkan& fbo) {
-        if (fbo.Id == FREE || fbo.Id == PENDING_DESTROY)
-            return false;
-
-        return DFramebufferAttachmentEqualFn{}(fbo.Attachments, colorAttachments);
-    });
-
-    DFramebufferVulkan* framebufferPtr{};
-    if (framebufferIt != _framebuffers.end())
+    std::array<VkBuffer, VertexLayoutInfo::MAX_STREAMS>     buffers{};
+    std::array<VkDeviceSize, VertexLayoutInfo::MAX_STREAMS> bufferOffsets{};
+    bool                                                    redundant = true;
+    for (size_t i = 0; i < bufferIds.size(); i++)
         {
-            framebufferPtr = &(*framebufferIt);
+            const auto& vertexBufRef = GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER>(_vertexBuffers, bufferIds[i]);
+            buffers[i]               = vertexBufRef.Buffer.Buffer;
+            bufferOffsets[i]         = offsets[i];
+
+            const auto& bound = commandBufferRef.BoundState.VertexBuffers[firstStream + i];
+            redundant &= bound.Buffer == buffers[i] && bound.Offset == bufferOffsets[i];
         }
-    else
+
+    if (redundant)
         {
-            // Create framebuffer from colorAttachments
-            const auto framebufferId = _createFramebuffer(colorAttachments);
-            framebufferPtr           = &GetResource<DFramebufferVulkan, EResourceType::FRAMEBUFFER, MAX_RESOURCES>(_framebuffers, framebufferId);
+            commandBufferRef.RedundantState.VertexBuffers++;
+            return;
         }
 
-    // Create right render pass
-    auto renderPassAttachments = _createGenericRenderPassAttachments(colorAttachments);
-
-    VkClearValue clearValues[DFramebufferAttachments::MAX_ATTACHMENTS];
-    uint32_t     clearValueIndex{};
-
-    // Process color colorAttachments
-    for (size_t i = 0; i < renderPassAttachments.Attachments.size(); i++)
+    // The streams are bound together, it's a single command even if some of them didn't change
+    for (size_t i = 0; i < bufferIds.size(); i++)
         {
+            commandBufferRef.BoundState.VertexBuffers[firstStream + i] = { buffers[i], bufferOffsets[i] };
+        }
+    vkCmdBindVertexBuffers(commandBufferRef.Cmd, firstStream, (uint32_t)bufferIds.size(), buffers.data(), bufferOffsets.data());
+}
 
-            auto& slot = renderPassAttachments.Attachments.at(i);
-            if (VkUtils::isColorFormat(VkUtils::convertFormat(slot.Format)))
-                {
-                    // Color
-                    renderPassAttachments.Attachments.at(i).LoadOP  = loadOP.LoadColor[i];
-                    renderPassAttachments.Attachments.at(i).StoreOP = loadOP.StoreActionsColor[i];
-
-                    renderPassAttachments.Attachments.at(i).InitialLayout = ERenderPassLayout::AsAttachment;
-                    renderPassAttachments.Attachments.at(i).FinalLayout   = ERenderPassLayout::AsAttachment;
-
-                    if (loadOP.LoadColor[i] == ERenderPassLoad::Clear)
-                        {
-                            renderPassAttachments.Attachments.at(i).InitialLayout = ERenderPassLayout::Undefined;
+void
+VulkanContext::BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset, EIndexType indexType)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-                            clearValues[clearValueIndex].color.float32[0] = loadOP.ClearColor[i].color.float32[0];
-                            clearValues[clearValueIndex].color.float32[1] = loadOP.ClearColor[i].color.float32[1];
-                            clearValues[clearValueIndex].color.float32[2] = loadOP.ClearColor[i].color.float32[2];
-                            clearValues[clearValueIndex].color.float32[3] = loadOP.ClearColor[i].color.float32[3];
-                            clearValueIndex++;
-                        }
-                }
-            else
-                {
-                    // depth stencil
-                    renderPassAttachments.Attachments.at(i).LoadOP  = loadOP.LoadDepth;
-                    renderPassAttachments.Attachments.at(i).StoreOP = loadOP.StoreDepth;
+    auto& indexBufRef = GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER>(_vertexBuffers, bufferId);
 
-                    renderPassAttachments.Attachments.at(i).InitialLayout = ERenderPassLayout::AsAttachment;
-                    renderPassAttachments.Attachments.at(i).FinalLayout   = ERenderPassLayout::AsAttachment;
+    const VkIndexType indexTypeVk = VkUtils::convertIndexType(indexType);
+    check(VkUtils::isIndexOffsetAligned(offset, indexType)); // Must be aligned to the index size
 
-                    if (loadOP.LoadDepth == ERenderPassLoad::Clear)
-                        {
-                            renderPassAttachments.Attachments.at(i).InitialLayout = ERenderPassLayout::Undefined;
-                            clearValues[clearValueIndex].depthStencil.depth       = loadOP.ClearDepthStencil.depth;
-                            clearValues[clearValueIndex].depthStencil.stencil     = loadOP.ClearDepthStencil.stencil;
-                            clearValueIndex++;
-                        }
-                }
+    auto& bound = commandBufferRef.BoundState;
+    if (bound.IndexBuffer.Buffer == indexBufRef.Buffer.Buffer && bound.IndexBuffer.Offset == offset && bound.IndexType == indexTypeVk)
+        {
+            commandBufferRef.RedundantState.IndexBuffers++;
+            return;
         }
+    bound.IndexBuffer = { indexBufRef.Buffer.Buffer, offset };
+    bound.IndexType   = indexTypeVk;
 
-    VkRenderPass renderPass = _createRenderPass(renderPassAttachments);
-
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass        = renderPass;
-    renderPassInfo.framebuffer       = framebufferPtr->Framebuffer;
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = { framebufferPtr->Width, framebufferPtr->Height };
-    renderPassInfo.clearValueCount   = clearValueIndex;
-    renderPassInfo.pClearValues      = clearValues;
+    vkCmdBindIndexBuffer(commandBufferRef.Cmd, indexBufRef.Buffer.Buffer, offset, indexTypeVk);
+}
 
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+void
+VulkanContext::Draw(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count)
+{
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    // If previous active render pass end it
-    if (commandBufferRef.ActiveRenderPass)
-        {
-            vkCmdEndRenderPass(commandBufferRef.Cmd);
-            commandBufferRef.ActiveRenderPass = nullptr;
-        }
-
-    vkCmdBeginRenderPass(commandBufferRef.Cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-    commandBufferRef.ActiveRenderPass = renderPass;
+    vkCmdDraw(commandBufferRef.Cmd, count, 1, firstVertex, 0);
 }
 
 void
-VulkanContext::SetViewport(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float znear, float zfar)
+VulkanContext::DrawInstanced(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count, uint32_t firstInstance, uint32_t instanceCount)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-    // Invert viewport on Y
-    VkViewport viewport{ static_cast<float>(x), static_cast<float>(y) + static_cast<float>(height), static_cast<float>(width), -static_cast<float>(height), znear, zfar };
-
-    vkCmdSetViewport(commandBufferRef.Cmd, 0, 1, &viewport);
+    vkCmdDraw(commandBufferRef.Cmd, count, instanceCount, firstVertex, firstInstance);
 }
 
 void
-VulkanContext::SetScissor(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+VulkanContext::DrawIndexed(uint32_t commandBufferId, uint32_t index_count, uint32_t first_index, uint32_t first_vertex)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-    VkRect2D rect{ x, y, width, height };
-    vkCmdSetScissor(commandBufferRef.Cmd, 0, 1, &rect);
+    vkCmdDrawIndexed(commandBufferRef.Cmd, index_count, 1, first_index, first_vertex, 0);
 }
 
 void
-VulkanContext::BindPipeline(uint32_t commandBufferId, uint32_t pipeline)
+VulkanContext::DrawIndexedInstanced(uint32_t commandBufferId, uint32_t indexCount, uint32_t firstIndex, uint32_t firstVertex, uint32_t firstInstance, uint32_t instanceCount)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-    auto& pipelineRef = GetResource<DPipelineVulkan, EResourceType::GRAPHICS_PIPELINE, MAX_RESOURCES>(_pipelines, pipeline);
-
-    vkCmdBindPipeline(commandBufferRef.Cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineRef.Pipeline);
+    vkCmdDrawIndexed(commandBufferRef.Cmd, indexCount, instanceCount, firstIndex, firstVertex, firstInstance);
 }
 
 void
-VulkanContext::BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId)
+VulkanContext::DrawIndexedIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t drawCount, uint32_t stride)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
 
-    auto& vertexBufRef = GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER, MAX_RESOURCES>(_vertexBuffers, bufferId);
+    auto& indirectBufferRef = GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND>(_indirectBuffers, buffer);
 
-    VkDeviceSize offset{};
-    vkCmdBindVertexBuffers(commandBufferRef.Cmd, 0, 1, &vertexBufRef.Buffer.Buffer, &offset);
+    VkDeviceSize deviceOffset{ offset };
+    vkCmdDrawIndexedIndirect(commandBufferRef.Cmd, indirectBufferRef.Buffer.Buffer, deviceOffset, drawCount, stride);
 }
 
 void
-VulkanContext::BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId)
+VulkanContext::DrawIndexedIndirectCount(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t countBuffer, uint32_t countOffset, uint32_t maxDrawCount, uint32_t stride)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    critical(_drawIndirectCount); // The device doesn't support VK_KHR_draw_indirect_count
+
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(commandBufferRef.IsInRenderPass); // Must be in a render pass
+    check(countOffset % 4 == 0); // Must be multiple of 4
 
-    auto& indexBufRef = GetResource<DBufferVulkan, EResourceType::VERTEX_INDEX_BUFFER, MAX_RESOURCES>(_vertexBuffers, bufferId);
+    auto& indirectBufferRef = GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND>(_indirectBuffers, buffer);
+    auto& countBufferRef    = GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND>(_indirectBuffers, countBuffer);
 
-    VkDeviceSize offset{};
-    vkCmdBindIndexBuffer(commandBufferRef.Cmd, indexBufRef.Buffer.Buffer, offset, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexedIndirectCountKHR(commandBufferRef.Cmd, indirectBufferRef.Buffer.Buffer, offset, countBufferRef.Buffer.Buffer, countOffset, maxDrawCount, stride);
 }
 
 void
-VulkanContext::Draw(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count)
+VulkanContext::Dispatch(uint32_t commandBufferId, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
 
-    vkCmdDraw(commandBufferRef.Cmd, count, 1, firstVertex, 0);
+    // The barriers queued before are waited on by the dispatch
+    _flushBarriers(commandBufferRef);
+    check(!commandBufferRef.IsInRenderPass); // Must not be in a render pass
+
+    vkCmdDispatch(commandBufferRef.Cmd, groupCountX, groupCountY, groupCountZ);
 }
 
 void
-VulkanContext::DrawIndexed(uint32_t commandBufferId, uint32_t index_count, uint32_t first_index, uint32_t first_vertex)
+VulkanContext::DispatchIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
 
-    vkCmdDrawIndexed(commandBufferRef.Cmd, index_count, 1, first_index, first_vertex, 0);
+    _flushBarriers(commandBufferRef);
+    check(!commandBufferRef.IsInRenderPass); // Must not be in a render pass
+
+    auto& indirectBufferRef = GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND>(_indirectBuffers, buffer);
+
+    VkDeviceSize deviceOffset{ offset };
+    vkCmdDispatchIndirect(commandBufferRef.Cmd, indirectBufferRef.Buffer.Buffer, deviceOffset);
 }
 
 void
-VulkanContext::DrawIndexedIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t drawCount, uint32_t stride)
+VulkanContext::PushConstants(uint32_t commandBufferId, EShaderStage stage, uint32_t offset, uint32_t size, const void* data)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
+    check(offset % 4 == 0 && size % 4 == 0); // Must be multiple of 4
 
-    auto& indirectBufferRef = GetResource<DBufferVulkan, EResourceType::INDIRECT_DRAW_COMMAND, MAX_RESOURCES>(_indirectBuffers, buffer);
+    // Written with the layout of the bound pipeline, it must have a range with the stage covering the bytes
+    const VkPipelineLayout layout = GetBoundPipelineLayout(commandBufferId, stage);
+    check(layout != VK_NULL_HANDLE); // A pipeline must be bound
 
-    VkDeviceSize deviceOffset{ offset };
-    vkCmdDrawIndexedIndirect(commandBufferRef.Cmd, indirectBufferRef.Buffer.Buffer, deviceOffset, drawCount, stride);
+    vkCmdPushConstants(commandBufferRef.Cmd, layout, VkUtils::convertShaderStage(stage), offset, size, data);
+}
+
+VkPipelineLayout
+VulkanContext::GetBoundPipelineLayout(uint32_t commandBufferId, EShaderStage stage) const
+{
+    const auto&               commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    const VkPipelineBindPoint bindPoint        = stage == EShaderStage::COMPUTE ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+    return commandBufferRef.BoundState.PipelineLayouts[bindPoint];
 }
 
 void
 VulkanContext::BindDescriptorSet(uint32_t commandBufferId, uint32_t setIndex, uint32_t descriptorSetId)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(commandBufferRef.ActiveRenderPass); // Must be in a render pass
 
-    const DDescriptorSet& descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET, MAX_RESOURCES>(_descriptorSets, descriptorSetId);
+    // Sets can't be updated once bound, the writes queued so far are applied first
+    FlushDescriptorWrites();
+
+    const DDescriptorSet&     descriptorSetRef = GetResource<DDescriptorSet, EResourceType::DESCRIPTOR_SET>(_descriptorSets, descriptorSetId);
+    const VkPipelineBindPoint bindPoint        = descriptorSetRef.RootSignature->BindPoint;
+    // Must be in a render pass, or before it to transition its textures. Compute sets are bound before the dispatch
+    check(commandBufferRef.IsInRenderPass || _automaticBarriers || bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    // Textures might have been written since the set was bound, they are transitioned even if binding it is skipped
+    if (_automaticBarriers)
+        {
+            _transitionSampledTextures(commandBufferId, descriptorSetRef, setIndex);
+        }
+
+    const VkPipelineLayout      layout   = descriptorSetRef.RootSignature->PipelineLayout;
+    const VkDescriptorSet       set      = descriptorSetRef.Sets[setIndex];
+    DBoundDescriptorSetsVulkan& boundSet = commandBufferRef.BoundState.DescriptorSets[bindPoint];
+    if (boundSet.Layout == layout && boundSet.Sets[(size_t)descriptorSetRef.Frequency] == set)
+        {
+            commandBufferRef.RedundantState.DescriptorSets++;
+            return;
+        }
+    // Sets bound with a different layout might be disturbed
+    if (boundSet.Layout != layout)
+        {
+            boundSet        = {};
+            boundSet.Layout = layout;
+        }
+    boundSet.Sets[(size_t)descriptorSetRef.Frequency] = set;
 
-    vkCmdBindDescriptorSets(
-    commandBufferRef.Cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, descriptorSetRef.RootSignature->PipelineLayout, (uint32_t)descriptorSetRef.Frequency, 1, &descriptorSetRef.Sets[setIndex], 0, nullptr);
+    vkCmdBindDescriptorSets(commandBufferRef.Cmd, bindPoint, layout, (uint32_t)descriptorSetRef.Frequency, 1, &set, 0, nullptr);
 }
 
 void
 VulkanContext::CopyImage(uint32_t commandId, uint32_t imageId, uint32_t width, uint32_t height, uint32_t mipMapIndex, uint32_t stagingBufferId, uint32_t stagingBufferOffset)
 {
-    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandId);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandId);
     check(commandBufferRef.IsRecording); // Must be in recording state
-    check(!commandBufferRef.ActiveRenderPass); // Must be in a render pass
 
-    auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, imageId);
-    auto& buffRef  = GetResource<DBufferVulkan, EResourceType::TRANSFER, MAX_RESOURCES>(_transferBuffers, stagingBufferId);
+    auto& imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, imageId);
+    auto& buffRef  = GetResource<DBufferVulkan, EResourceType::TRANSFER>(_transferBuffers, stagingBufferId);
+
+    if (_automaticBarriers)
+        {
+            _transitionSubresources(commandBufferRef, imageRef.Image.Image, imageRef.ImageAspect, imageRef.States, EResourceState::COPY_DEST, true, mipMapIndex, 0);
+        }
+    // Ends the render pass the queued barriers were issued in
+    _flushBarriers(commandBufferRef);
+    check(!commandBufferRef.IsInRenderPass); // Must not be in a render pass
 
     VkBufferImageCopy region{};
     {
@@ -1809,64 +3226,135 @@ VulkanContext::CopyImage(uint32_t commandId, uint32_t imageId, uint32_t width, u
 void
 VulkanContext::QueueSubmit(const std::vector<uint32_t>& waitSemaphore, const std::vector<uint32_t>& finishSemaphore, const std::vector<uint32_t>& cmdIds, uint32_t fenceId)
 {
-    std::vector<VkCommandBuffer> commandBuffers;
+    QueueSubmit(waitSemaphore, {}, finishSemaphore, {}, cmdIds, fenceId);
+}
+
+void
+VulkanContext::QueueSubmit(const std::vector<uint32_t>& waitSemaphore,
+const std::vector<DTimelineValue>&                   waitTimeline,
+const std::vector<uint32_t>&                         finishSemaphore,
+const std::vector<DTimelineValue>&                   signalTimeline,
+const std::vector<uint32_t>&                         cmdIds)
+{
+    QueueSubmit(std::span<const uint32_t>(waitSemaphore),
+    std::span<const DTimelineValue>(waitTimeline),
+    std::span<const uint32_t>(finishSemaphore),
+    std::span<const DTimelineValue>(signalTimeline),
+    std::span<const uint32_t>(cmdIds),
+    NULL);
+}
+
+void
+VulkanContext::QueueSubmit(std::span<const uint32_t> waitSemaphore,
+std::span<const DTimelineValue>                   waitTimeline,
+std::span<const uint32_t>                         finishSemaphore,
+std::span<const DTimelineValue>                   signalTimeline,
+std::span<const uint32_t>                         cmdIds,
+uint32_t                                          fenceId)
+{
+    auto& scratch = _submitScratch;
+    scratch.CommandBuffers.clear();
+    scratch.WaitSemaphores.clear();
+    scratch.WaitValues.clear();
+    scratch.WaitStages.clear();
+    scratch.SignalSemaphores.clear();
+    scratch.SignalValues.clear();
+
+    EQueueType queueType{};
     for (auto cmdId : cmdIds)
         {
-            auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, cmdId);
-            commandBuffers.push_back(commandBufferRef.Cmd);
+            auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, cmdId);
+            check(scratch.CommandBuffers.size() == 0 || commandBufferRef.QueueType == queueType); // Submitted to a single queue
+            scratch.CommandBuffers.push_back(commandBufferRef.Cmd);
+            queueType = commandBufferRef.QueueType;
         }
 
-    std::vector<VkSemaphore>          waitSemaphores;
-    std::vector<VkPipelineStageFlags> waitStages;
+    // The values of the binary semaphores are ignored
     for (auto semaphoreId : waitSemaphore)
         {
-            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE, MAX_RESOURCES>(_semaphores, semaphoreId);
-            waitSemaphores.push_back(semaphoreRef.Semaphore);
-
-            waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE>(_semaphores, semaphoreId);
+            scratch.WaitSemaphores.push_back(semaphoreRef.Semaphore);
+            scratch.WaitValues.push_back(0);
         }
+    for (const auto& wait : waitTimeline)
+        {
+            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, wait.Semaphore);
+            scratch.WaitSemaphores.push_back(semaphoreRef.Semaphore);
+            scratch.WaitValues.push_back(wait.Value);
+        }
+    scratch.WaitStages.resize(scratch.WaitSemaphores.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
-    std::vector<VkSemaphore> finishSemaphores;
     for (auto semaphoreId : finishSemaphore)
         {
-            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE, MAX_RESOURCES>(_semaphores, semaphoreId);
-            finishSemaphores.push_back(semaphoreRef.Semaphore);
+            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE>(_semaphores, semaphoreId);
+            scratch.SignalSemaphores.push_back(semaphoreRef.Semaphore);
+            scratch.SignalValues.push_back(0);
+        }
+    for (const auto& signal : signalTimeline)
+        {
+            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, signal.Semaphore);
+            scratch.SignalSemaphores.push_back(semaphoreRef.Semaphore);
+            scratch.SignalValues.push_back(signal.Value);
         }
 
-    DFenceVulkan* fenceRef{};
+    // Tracks the completion of the submission
+    DQueueTimelineVulkan& timeline = _queueTimelines[(size_t)queueType];
+    scratch.SignalSemaphores.push_back(timeline.Semaphore);
+    scratch.SignalValues.push_back(timeline.SubmittedValue + 1);
+
+    VkFence fence{ VK_NULL_HANDLE };
     if (fenceId != NULL)
         {
-            fenceRef = &GetResource<DFenceVulkan, EResourceType::FENCE, MAX_RESOURCES>(_fences, fenceId);
+            fence = GetResource<DFenceVulkan, EResourceType::FENCE>(_fences, fenceId).Fence;
         }
 
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo{};
+    timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.waitSemaphoreValueCount   = (uint32_t)scratch.WaitValues.size();
+    timelineInfo.pWaitSemaphoreValues      = scratch.WaitValues.data();
+    timelineInfo.signalSemaphoreValueCount = (uint32_t)scratch.SignalValues.size();
+    timelineInfo.pSignalSemaphoreValues    = scratch.SignalValues.data();
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount   = (uint32_t)waitSemaphores.size();
-    submitInfo.pWaitSemaphores      = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask    = waitStages.data();
-    submitInfo.commandBufferCount   = (uint32_t)commandBuffers.size();
-    submitInfo.pCommandBuffers      = commandBuffers.data();
-    submitInfo.signalSemaphoreCount = (uint32_t)finishSemaphores.size();
-    submitInfo.pSignalSemaphores    = finishSemaphores.data();
-
-    const VkResult result = vkQueueSubmit(Device.MainQueue, 1, &submitInfo, fenceRef != nullptr ? fenceRef->Fence : VK_NULL_HANDLE);
+    submitInfo.pNext                = &timelineInfo;
+    submitInfo.waitSemaphoreCount   = (uint32_t)scratch.WaitSemaphores.size();
+    submitInfo.pWaitSemaphores      = scratch.WaitSemaphores.data();
+    submitInfo.pWaitDstStageMask    = scratch.WaitStages.data();
+    submitInfo.commandBufferCount   = (uint32_t)scratch.CommandBuffers.size();
+    submitInfo.pCommandBuffers      = scratch.CommandBuffers.data();
+    submitInfo.signalSemaphoreCount = (uint32_t)scratch.SignalSemaphores.size();
+    submitInfo.pSignalSemaphores    = scratch.SignalSemaphores.data();
+
+    const VkResult result = vkQueueSubmit(_getQueue(queueType), 1, &submitInfo, fence);
     if (VKFAILED(result))
         {
             throw std::runtime_error(VkUtils::VkErrorString(result));
         }
+    timeline.SubmittedValue++;
+
+    // Releases the resources of the completed submissions
+    _performDeletionQueue();
 }
 
 void
 VulkanContext::QueuePresent(uint32_t swapchainId, uint32_t imageIndex, const std::vector<uint32_t>& waitSemaphore)
 {
-    std::vector<VkSemaphore> waitSemaphores;
+    QueuePresent(swapchainId, imageIndex, std::span<const uint32_t>(waitSemaphore));
+}
+
+void
+VulkanContext::QueuePresent(uint32_t swapchainId, uint32_t imageIndex, std::span<const uint32_t> waitSemaphore)
+{
+    auto& waitSemaphores = _submitScratch.WaitSemaphores;
+    waitSemaphores.clear();
     for (auto semaphoreId : waitSemaphore)
         {
-            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE, MAX_RESOURCES>(_semaphores, semaphoreId);
+            auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE>(_semaphores, semaphoreId);
             waitSemaphores.push_back(semaphoreRef.Semaphore);
         }
 
-    auto& swapchainRef = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN, MAX_RESOURCES>(_swapchains, swapchainId);
+    auto& swapchainRef = GetResource<DSwapchainVulkan, EResourceType::SWAPCHAIN>(_swapchains, swapchainId);
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -1907,28 +3395,33 @@ VulkanContext::QueuePresent(uint32_t swapchainId, uint32_t imageIndex, const std
 uint32_t
 VulkanContext::CreateFence(bool signaled)
 {
-    const auto index    = AllocResource<DFenceVulkan, MAX_RESOURCES>(_fences);
+    const auto index    = AllocResource(_fences, EResourceType::FENCE);
     auto&      fenceRef = _fences.at(index);
     fenceRef.Fence      = Device.CreateFence(signaled);
     fenceRef.IsSignaled = signaled;
 
-    return *ResourceId(EResourceType::FENCE, fenceRef.Id, index);
+    return fenceRef.Id;
 }
 
 void
 VulkanContext::DestroyFence(uint32_t fenceId)
 {
-    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE, MAX_RESOURCES>(_fences, fenceId);
+    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE>(_fences, fenceId);
 
     Device.DestroyFence(fenceRef.Fence);
 
-    fenceRef.Id = FREE;
+    FreeResource(_fences, ResourceId(fenceId).Value());
 }
 
 bool
 VulkanContext::IsFenceSignaled(uint32_t fenceId)
 {
-    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE, MAX_RESOURCES>(_fences, fenceId);
+    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE>(_fences, fenceId);
+    if (!fenceRef.IsSignaled)
+        {
+            // Polls the fence without waiting
+            fenceRef.IsSignaled = vkGetFenceStatus(Device.Device, fenceRef.Fence) == VK_SUCCESS;
+        }
     return fenceRef.IsSignaled;
 }
 
@@ -1936,7 +3429,7 @@ void
 VulkanContext::WaitForFence(uint32_t fenceId, uint64_t timeoutNanoseconds)
 {
 
-    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE, MAX_RESOURCES>(_fences, fenceId);
+    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE>(_fences, fenceId);
 
     const VkResult result = vkWaitForFences(Device.Device, 1, &fenceRef.Fence, VK_TRUE /*Wait all*/, timeoutNanoseconds);
     if (VKFAILED(result))
@@ -1950,7 +3443,7 @@ VulkanContext::WaitForFence(uint32_t fenceId, uint64_t timeoutNanoseconds)
 void
 VulkanContext::ResetFence(uint32_t fenceId)
 {
-    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE, MAX_RESOURCES>(_fences, fenceId);
+    auto& fenceRef = GetResource<DFenceVulkan, EResourceType::FENCE>(_fences, fenceId);
 
     vkResetFences(Device.Device, 1, &fenceRef.Fence);
 
@@ -1960,20 +3453,60 @@ VulkanContext::ResetFence(uint32_t fenceId)
 uint32_t
 VulkanContext::CreateGpuSemaphore()
 {
-    const auto index        = AllocResource<DSemaphoreVulkan, MAX_RESOURCES>(_semaphores);
+    const auto index        = AllocResource(_semaphores, EResourceType::SEMAPHORE);
     auto&      semaphoreRef = _semaphores.at(index);
 
     semaphoreRef.Semaphore = Device.CreateVkSemaphore();
-    return *ResourceId(EResourceType::SEMAPHORE, semaphoreRef.Id, index);
+    return semaphoreRef.Id;
 }
 
 void
 VulkanContext::DestroyGpuSemaphore(uint32_t semaphoreId)
 {
-    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE, MAX_RESOURCES>(_semaphores, semaphoreId);
+    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::SEMAPHORE>(_semaphores, semaphoreId);
+    Device.DestroyVkSemaphore(semaphoreRef.Semaphore);
+
+    FreeResource(_semaphores, ResourceId(semaphoreId).Value());
+}
+
+uint32_t
+VulkanContext::CreateTimelineSemaphore(uint64_t initialValue)
+{
+    const auto index        = AllocResource(_semaphores, EResourceType::TIMELINE_SEMAPHORE);
+    auto&      semaphoreRef = _semaphores.at(index);
+
+    semaphoreRef.Semaphore = Device.CreateTimelineSemaphore(initialValue);
+    return semaphoreRef.Id;
+}
+
+void
+VulkanContext::DestroyTimelineSemaphore(uint32_t semaphoreId)
+{
+    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, semaphoreId);
     Device.DestroyVkSemaphore(semaphoreRef.Semaphore);
 
-    semaphoreRef.Id = FREE;
+    FreeResource(_semaphores, ResourceId(semaphoreId).Value());
+}
+
+uint64_t
+VulkanContext::GetTimelineSemaphoreValue(uint32_t semaphoreId)
+{
+    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, semaphoreId);
+    return Device.GetSemaphoreCounterValue(semaphoreRef.Semaphore);
+}
+
+bool
+VulkanContext::WaitTimelineSemaphore(uint32_t semaphoreId, uint64_t value, uint64_t timeoutNanoseconds)
+{
+    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, semaphoreId);
+    return Device.WaitSemaphoreValue(semaphoreRef.Semaphore, value, timeoutNanoseconds);
+}
+
+void
+VulkanContext::SignalTimelineSemaphore(uint32_t semaphoreId, uint64_t value)
+{
+    auto& semaphoreRef = GetResource<DSemaphoreVulkan, EResourceType::TIMELINE_SEMAPHORE>(_semaphores, semaphoreId);
+    Device.SignalSemaphoreValue(semaphoreRef.Semaphore, value);
 }
 
 uint32_t
@@ -2061,9 +3594,10 @@ VulkanContext::CreateRenderTarget(EFormat format, ESampleBit samples, bool isDep
                 break;
         }
 
-    const auto index           = AllocResource<DRenderTargetVulkan, MAX_RESOURCES>(_renderTargets);
+    const auto index           = AllocResource(_renderTargets, EResourceType::RENDER_TARGET);
     auto&      renderTargetRef = _renderTargets.at(index);
     renderTargetRef.Image      = Device.CreateImageDeviceLocal(width, height, mipMapCount, vkFormat, usageFlags, VK_IMAGE_TILING_OPTIMAL, initialLayout);
+    InitializeSubresourceStates(renderTargetRef.States, mipMapCount, 1, initialState);
 
     renderTargetRef.ImageAspect = VkUtils::isColorFormat(vkFormat) ? VK_IMAGE_ASPECT_COLOR_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
     if (VkUtils::formatHasStencil(vkFormat))
@@ -2079,198 +3613,267 @@ VulkanContext::CreateRenderTarget(EFormat format, ESampleBit samples, bool isDep
             }
     }
 
-    return *ResourceId(EResourceType::RENDER_TARGET, renderTargetRef.Id, index);
+    return renderTargetRef.Id;
 }
 
 void
 VulkanContext::DestroyRenderTarget(uint32_t renderTargetId)
 {
-    auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, renderTargetId);
+    auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, renderTargetId);
+    renderTargetRef.Id    = PENDING_DESTROY;
 
-    Device.DestroyImageView(renderTargetRef.View);
-    Device.DestroyImage(renderTargetRef.Image);
+    // Evicted from the cache now, the framebuffers themselves are released with the render target
+    _destroyFramebuffersWithAttachment(renderTargetId);
 
-    renderTargetRef.Id   = FREE;
-    renderTargetRef.View = nullptr;
+    _deferDestruction([this, renderTargetId]() {
+        auto& renderTargetRef = GetResourceUnsafe<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, renderTargetId);
+
+        Device.DestroyImageView(renderTargetRef.View);
+        Device.DestroyImage(renderTargetRef.Image);
+
+        // Aliased render targets of earlier frames might still be in use, the memory goes with the last of them
+        if (renderTargetRef.AliasingMemory)
+            {
+                auto& refCount = _aliasingMemoryRefCount.at(renderTargetRef.AliasingMemory);
+                if (--refCount == 0)
+                    {
+                        Device.FreeAliasingMemory(renderTargetRef.AliasingMemory);
+                        _aliasingMemoryRefCount.erase(renderTargetRef.AliasingMemory);
+                    }
+            }
+
+        renderTargetRef.View           = nullptr;
+        renderTargetRef.AliasingMemory = nullptr;
+        FreeResource(_renderTargets, ResourceId(renderTargetId).Value());
+    });
 }
 
 void
-VulkanContext::ResourceBarrier(uint32_t commandBufferId,
-uint32_t                                buffer_barrier_count,
-BufferBarrier*                          p_buffer_barriers,
-uint32_t                                texture_barrier_count,
-TextureBarrier*                         p_texture_barriers,
-uint32_t                                rt_barrier_count,
-RenderTargetBarrier*                    p_rt_barriers)
+VulkanContext::CreateTransientRenderTargets(uint32_t count, const DTransientRenderTargetDesc* descs, uint32_t* outRenderTargetIds)
 {
+    struct DAliasingBlock
+    {
+        VkMemoryRequirements Requirements{};
+        VmaAllocation        Memory{};
+    };
 
-    std::vector<VkImageMemoryBarrier> imageBarriers;
-    imageBarriers.resize(rt_barrier_count + texture_barrier_count);
-    uint32_t imageBarrierCount{};
+    const bool lazilyAllocated = Device.HasLazilyAllocatedMemory();
 
-    VkAccessFlags srcAccessFlags = 0;
-    VkAccessFlags dstAccessFlags = 0;
+    // Render targets of an alias group usually share a single block, a new one is needed only if their memory types are incompatible
+    std::unordered_map<uint32_t, std::vector<DAliasingBlock>> aliasGroups;
+    std::vector<size_t>                                       blockIndex(count);
 
-    for (uint32_t i = 0; i < texture_barrier_count; ++i)
+    for (uint32_t i = 0; i < count; i++)
         {
-            TextureBarrier*       pTrans        = &p_texture_barriers[i];
-            const DImageVulkan&   imageRef      = GetResource<DImageVulkan, EResourceType::IMAGE, MAX_RESOURCES>(_images, pTrans->ImageId);
-            VkImageMemoryBarrier* pImageBarrier = NULL;
+            const auto&    desc     = descs[i];
+            const VkFormat vkFormat = VkUtils::convertFormat(desc.Format);
+
+            VkImageUsageFlags usageFlags = desc.IsDepth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            // Transient attachments can't be sampled
+            usageFlags |= desc.AttachmentOnly ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : VK_IMAGE_USAGE_SAMPLED_BIT;
+
+            const auto index           = AllocResource(_renderTargets, EResourceType::RENDER_TARGET);
+            auto&      renderTargetRef = _renderTargets.at(index);
+            outRenderTargetIds[i]      = renderTargetRef.Id;
+            InitializeSubresourceStates(renderTargetRef.States, 1, 1, EResourceState::UNDEFINED);
 
-            if (EResourceState::UNORDERED_ACCESS == pTrans->CurrentState && EResourceState::UNORDERED_ACCESS == pTrans->NewState)
+            renderTargetRef.ImageAspect = VkUtils::isColorFormat(vkFormat) ? VK_IMAGE_ASPECT_COLOR_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+            if (VkUtils::formatHasStencil(vkFormat))
                 {
-                    pImageBarrier        = &imageBarriers[imageBarrierCount++]; //-V522
-                    pImageBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; //-V522
-                    pImageBarrier->pNext = NULL;
+                    renderTargetRef.ImageAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+                }
+
+            if (desc.AttachmentOnly && lazilyAllocated)
+                {
+                    renderTargetRef.Image = Device.CreateImageLazilyAllocated(desc.Width, desc.Height, vkFormat, usageFlags);
+                    continue;
+                }
 
-                    pImageBarrier->srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-                    pImageBarrier->dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-                    pImageBarrier->oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
-                    pImageBarrier->newLayout     = VK_IMAGE_LAYOUT_GENERAL;
+            renderTargetRef.Image   = Device.CreateImageWithoutMemory(desc.Width, desc.Height, 1, vkFormat, usageFlags);
+            const auto requirements = Device.GetImageMemoryRequirements(renderTargetRef.Image);
+
+            auto& blocks = aliasGroups[desc.AliasGroup];
+            auto  it     = std::find_if(blocks.begin(), blocks.end(), [&requirements](const DAliasingBlock& block) { return (block.Requirements.memoryTypeBits & requirements.memoryTypeBits) != 0; });
+            if (it == blocks.end())
+                {
+                    DAliasingBlock block;
+                    block.Requirements = requirements;
+                    blocks.emplace_back(std::move(block));
+                    it = blocks.end() - 1;
                 }
             else
                 {
-                    pImageBarrier        = &imageBarriers[imageBarrierCount++];
-                    pImageBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    pImageBarrier->pNext = NULL;
-
-                    pImageBarrier->srcAccessMask = VkUtils::resourceStateToAccessFlag(pTrans->CurrentState);
-                    pImageBarrier->dstAccessMask = VkUtils::resourceStateToAccessFlag(pTrans->NewState);
-                    pImageBarrier->oldLayout     = VkUtils::resourceStateToImageLayout(pTrans->CurrentState);
-                    pImageBarrier->newLayout     = VkUtils::resourceStateToImageLayout(pTrans->NewState);
-                }
-
-            if (pImageBarrier)
-                {
-                    pImageBarrier->image                           = imageRef.Image.Image;
-                    pImageBarrier->subresourceRange.aspectMask     = (VkImageAspectFlags)imageRef.ImageAspect;
-                    pImageBarrier->subresourceRange.baseMipLevel   = pTrans->mSubresourceBarrier ? pTrans->mMipLevel : 0;
-                    pImageBarrier->subresourceRange.levelCount     = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_MIP_LEVELS;
-                    pImageBarrier->subresourceRange.baseArrayLayer = pTrans->mSubresourceBarrier ? pTrans->mArrayLayer : 0;
-                    pImageBarrier->subresourceRange.layerCount     = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_ARRAY_LAYERS;
-
-                    // if (pTrans->mAcquire && pTrans->mCurrentState != RESOURCE_STATE_UNDEFINED)
-                    //     {
-                    //         pImageBarrier->srcQueueFamilyIndex = pCmd->pRenderer->mVulkan.mQueueFamilyIndices[pTrans->mQueueType];
-                    //         pImageBarrier->dstQueueFamilyIndex = pCmd->pQueue->mVulkan.mVkQueueFamilyIndex;
-                    //     }
-                    // else if (pTrans->mRelease && pTrans->mCurrentState != RESOURCE_STATE_UNDEFINED)
-                    //     {
-                    //         pImageBarrier->srcQueueFamilyIndex = pCmd->pQueue->mVulkan.mVkQueueFamilyIndex;
-                    //         pImageBarrier->dstQueueFamilyIndex = pCmd->pRenderer->mVulkan.mQueueFamilyIndices[pTrans->mQueueType];
-                    //     }
-                    // else
-                    {
-                        pImageBarrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                        pImageBarrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    }
+                    // Alignments are powers of two, the largest satisfies all of them
+                    it->Requirements.size      = std::max(it->Requirements.size, requirements.size);
+                    it->Requirements.alignment = std::max(it->Requirements.alignment, requirements.alignment);
+                    it->Requirements.memoryTypeBits &= requirements.memoryTypeBits;
+                }
+            blockIndex[i] = (size_t)std::distance(blocks.begin(), it);
+        }
+
+    for (auto& group : aliasGroups)
+        {
+            for (auto& block : group.second)
+                {
+                    block.Memory = Device.AllocateAliasingMemory(block.Requirements);
+                }
+        }
+
+    // Views can be created only after the memory is bound
+    for (uint32_t i = 0; i < count; i++)
+        {
+            auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, outRenderTargetIds[i]);
+            if (renderTargetRef.Image.Allocation == nullptr)
+                {
+                    renderTargetRef.AliasingMemory = aliasGroups.at(descs[i].AliasGroup)[blockIndex[i]].Memory;
+                    Device.BindImageMemory(renderTargetRef.Image, renderTargetRef.AliasingMemory);
+                    _aliasingMemoryRefCount[renderTargetRef.AliasingMemory]++;
+                }
 
-                    srcAccessFlags |= pImageBarrier->srcAccessMask;
-                    dstAccessFlags |= pImageBarrier->dstAccessMask;
+            const VkResult result = Device.CreateImageView(renderTargetRef.Image.Format, renderTargetRef.Image.Image, renderTargetRef.ImageAspect, 0, 1, &renderTargetRef.View);
+            if (VKFAILED(result))
+                {
+                    throw std::runtime_error("Failed to create image view");
                 }
         }
+}
+
+void
+VulkanContext::ResourceBarrier(uint32_t commandBufferId,
+uint32_t                                buffer_barrier_count,
+BufferBarrier*                          p_buffer_barriers,
+uint32_t                                texture_barrier_count,
+TextureBarrier*                         p_texture_barriers,
+uint32_t                                rt_barrier_count,
+RenderTargetBarrier*                    p_rt_barriers)
+{
+    ResourceBarrier(commandBufferId,
+    std::span<const BufferBarrier>(p_buffer_barriers, buffer_barrier_count),
+    std::span<const TextureBarrier>(p_texture_barriers, texture_barrier_count),
+    std::span<const RenderTargetBarrier>(p_rt_barriers, rt_barrier_count));
+}
 
-    for (uint32_t i = 0; i < rt_barrier_count; ++i)
+void
+VulkanContext::ResourceBarrier(uint32_t commandBufferId, std::span<const BufferBarrier> bufferBarriers, std::span<const TextureBarrier> textureBarriers, std::span<const RenderTargetBarrier> renderTargetBarriers)
+{
+    if (_automaticBarriers)
         {
-            RenderTargetBarrier* pTrans = &p_rt_barriers[i];
+            _trackedResourceBarrier(
+            commandBufferId, (uint32_t)bufferBarriers.size(), bufferBarriers.data(), (uint32_t)textureBarriers.size(), textureBarriers.data(), (uint32_t)renderTargetBarriers.size(), renderTargetBarriers.data());
+            return;
+        }
 
-            auto& renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET, MAX_RESOURCES>(_renderTargets, pTrans->RenderTarget);
+    auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER>(_commandBuffers, commandBufferId);
+    check(commandBufferRef.IsRecording); // Must be in recording state
 
-            VkImageMemoryBarrier* pImageBarrier = &imageBarriers[imageBarrierCount++];
+    // Queued on the command buffer, the render pass is ended only when they're flushed. Split barriers are recorded
+    // right away, their event is set after the commands before BeginOnly and waited before the ones after EndOnly.
+    // Release and Acquire barriers are the halves of a queue family ownership transfer, recorded on each queue
+    for (const auto& barrier : bufferBarriers)
+        {
+            _bufferTransition(commandBufferRef, barrier);
+        }
+    for (const auto& barrier : textureBarriers)
+        {
+            _textureTransition(commandBufferRef, barrier);
+        }
+    for (const auto& barrier : renderTargetBarriers)
+        {
+            _renderTargetTransition(commandBufferRef, barrier);
+        }
+}
 
-            if (EResourceState::UNORDERED_ACCESS == pTrans->mCurrentState && EResourceState::UNORDERED_ACCESS == pTrans->mNewState)
-                {
-                    pImageBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    pImageBarrier->pNext = NULL;
+void
+VulkanContext::_bufferTransition(DCommandBufferVulkan& commandBufferRef, const BufferBarrier& barrier)
+{
+    const BufferBarrier* pTrans = &barrier;
 
-                    pImageBarrier->srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-                    pImageBarrier->dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-                    pImageBarrier->oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
-                    pImageBarrier->newLayout     = VK_IMAGE_LAYOUT_GENERAL;
-                }
-            else
-                {
-                    pImageBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    pImageBarrier->pNext = NULL;
-
-                    pImageBarrier->srcAccessMask = VkUtils::resourceStateToAccessFlag(pTrans->mCurrentState);
-                    pImageBarrier->dstAccessMask = VkUtils::resourceStateToAccessFlag(pTrans->mNewState);
-                    pImageBarrier->oldLayout     = VkUtils::resourceStateToImageLayout(pTrans->mCurrentState);
-                    pImageBarrier->newLayout     = VkUtils::resourceStateToImageLayout(pTrans->mNewState);
-                }
-
-            if (pImageBarrier)
-                {
-                    pImageBarrier->image                           = renderTargetRef.Image.Image;
-                    pImageBarrier->subresourceRange.aspectMask     = (VkImageAspectFlags)renderTargetRef.ImageAspect;
-                    pImageBarrier->subresourceRange.baseMipLevel   = pTrans->mSubresourceBarrier ? pTrans->mMipLevel : 0;
-                    pImageBarrier->subresourceRange.levelCount     = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_MIP_LEVELS;
-                    pImageBarrier->subresourceRange.baseArrayLayer = pTrans->mSubresourceBarrier ? pTrans->mArrayLayer : 0;
-                    pImageBarrier->subresourceRange.layerCount     = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_ARRAY_LAYERS;
-
-                    // if (pTrans->mAcquire && pTrans->mCurrentState != EResourceState::UNDEFINED)
-                    //     {
-                    //         pImageBarrier->srcQueueFamilyIndex = pCmd->pRenderer->mVulkan.mQueueFamilyIndices[pTrans->mQueueType];
-                    //         pImageBarrier->dstQueueFamilyIndex = pCmd->pQueue->mVulkan.mVkQueueFamilyIndex;
-                    //     }
-                    // else if (pTrans->mRelease && pTrans->mCurrentState != EResourceState::UNDEFINED)
-                    //     {
-                    //         pImageBarrier->srcQueueFamilyIndex = pCmd->pQueue->mVulkan.mVkQueueFamilyIndex;
-                    //         pImageBarrier->dstQueueFamilyIndex = pCmd->pRenderer->mVulkan.mQueueFamilyIndices[pTrans->mQueueType];
-                    //     }
-                    // else
-                    {
-                        pImageBarrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                        pImageBarrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    }
+    DTransitionVulkan transition;
+    transition.Buffer       = _getBuffer(pTrans->BufferId);
+    transition.CurrentState = pTrans->CurrentState;
+    transition.NewState     = pTrans->NewState;
+    if (_setOwnershipTransfer(commandBufferRef, transition, pTrans->Acquire, pTrans->Release, (EQueueType)pTrans->QueueType))
+        {
+            _resourceTransition(commandBufferRef, transition, pTrans->BeginOnly, pTrans->EndOnly);
+        }
+}
 
-                    srcAccessFlags |= pImageBarrier->srcAccessMask;
-                    dstAccessFlags |= pImageBarrier->dstAccessMask;
-                }
+void
+VulkanContext::_textureTransition(DCommandBufferVulkan& commandBufferRef, const TextureBarrier& barrier)
+{
+    const TextureBarrier* pTrans   = &barrier;
+    DImageVulkan&         imageRef = GetResource<DImageVulkan, EResourceType::IMAGE>(_images, pTrans->ImageId);
+
+    DTransitionVulkan transition;
+    transition.Image        = imageRef.Image.Image;
+    transition.Aspect       = imageRef.ImageAspect;
+    transition.CurrentState = pTrans->CurrentState;
+    transition.NewState     = pTrans->NewState;
+    transition.MipLevel     = pTrans->mSubresourceBarrier ? pTrans->mMipLevel : 0;
+    transition.LevelCount   = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_MIP_LEVELS;
+    transition.ArrayLayer   = pTrans->mSubresourceBarrier ? pTrans->mArrayLayer : 0;
+    transition.LayerCount   = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_ARRAY_LAYERS;
+    transition.AliasedState = pTrans->AliasedState;
+    if (_setOwnershipTransfer(commandBufferRef, transition, pTrans->Acquire, pTrans->Release, (EQueueType)pTrans->QueueType))
+        {
+            _resourceTransition(commandBufferRef, transition, pTrans->BeginOnly, pTrans->EndOnly);
         }
 
-    VkPipelineStageFlags srcStageMask = VkUtils::determinePipelineStageFlags(srcAccessFlags, EQueueType::GRAPHICS);
-    VkPipelineStageFlags dstStageMask = VkUtils::determinePipelineStageFlags(dstAccessFlags, EQueueType::GRAPHICS);
+    // Tracked in both modes, the context always knows the current state of a resource
+    SetSubresourceStates(imageRef.States, pTrans->NewState, pTrans->mSubresourceBarrier, pTrans->mMipLevel, pTrans->mArrayLayer);
+}
 
-    {
-        auto& commandBufferRef = GetResource<DCommandBufferVulkan, EResourceType::COMMAND_BUFFER, MAX_RESOURCES>(_commandBuffers, commandBufferId);
-        check(commandBufferRef.IsRecording); // Must be in recording state
-        // If previous active render pass end it
-        if (commandBufferRef.ActiveRenderPass)
-            {
-                vkCmdEndRenderPass(commandBufferRef.Cmd);
-                commandBufferRef.ActiveRenderPass = nullptr;
-            }
+void
+VulkanContext::_renderTargetTransition(DCommandBufferVulkan& commandBufferRef, const RenderTargetBarrier& barrier)
+{
+    const RenderTargetBarrier* pTrans          = &barrier;
+    auto&                      renderTargetRef = GetResource<DRenderTargetVulkan, EResourceType::RENDER_TARGET>(_renderTargets, pTrans->RenderTarget);
+
+    DTransitionVulkan transition;
+    transition.Image        = renderTargetRef.Image.Image;
+    transition.Aspect       = renderTargetRef.ImageAspect;
+    transition.CurrentState = pTrans->mCurrentState;
+    transition.NewState     = pTrans->mNewState;
+    transition.MipLevel     = pTrans->mSubresourceBarrier ? pTrans->mMipLevel : 0;
+    transition.LevelCount   = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_MIP_LEVELS;
+    transition.ArrayLayer   = pTrans->mSubresourceBarrier ? pTrans->mArrayLayer : 0;
+    transition.LayerCount   = pTrans->mSubresourceBarrier ? 1 : VK_REMAINING_ARRAY_LAYERS;
+    transition.AliasedState = pTrans->mAliasedState;
+    if (_setOwnershipTransfer(commandBufferRef, transition, pTrans->mAcquire, pTrans->mRelease, (EQueueType)pTrans->mQueueType))
+        {
+            _resourceTransition(commandBufferRef, transition, pTrans->mBeginOnly, pTrans->mEndOnly);
+        }
 
-        vkCmdPipelineBarrier(commandBufferRef.Cmd, srcStageMask, dstStageMask, 0, 0, NULL, 0, NULL, (uint32_t)imageBarriers.size(), imageBarriers.data());
-    }
+    SetSubresourceStates(renderTargetRef.States, pTrans->mNewState, pTrans->mSubresourceBarrier, pTrans->mMipLevel, pTrans->mArrayLayer);
 }
 
 void
 VulkanContext::_deferDestruction(DeleteFn&& fn)
 {
-    const auto index               = _frameIndex + NUM_OF_FRAMES_IN_FLIGHT;
-    auto       foundSameFrameIndex = std::find_if(_deletionQueue.begin(), _deletionQueue.end(), [index](const FramesWaitToDeletionList& pair) { return pair.first == index; });
+    TimelineValues values;
+    std::transform(_queueTimelines.begin(), _queueTimelines.end(), values.begin(), [](const DQueueTimelineVulkan& timeline) { return timeline.SubmittedValue; });
 
-    if (foundSameFrameIndex == _deletionQueue.end())
+    // Values only grow, the resources destroyed between the same submissions share the last list
+    if (_deletionQueue.size() == 0 || _deletionQueue.back().first != values)
         {
             std::vector<DeleteFn> lst{ std::move(fn) };
-            auto                  pair = std::make_pair(index, std::move(lst));
+            auto                  pair = std::make_pair(values, std::move(lst));
             _deletionQueue.emplace_back(std::move(pair));
         }
     else
         {
-            foundSameFrameIndex->second.emplace_back(std::move(fn));
+            _deletionQueue.back().second.emplace_back(std::move(fn));
         }
 }
 
 VkPipeline
-VulkanContext::_createPipeline(VkPipelineLayout     pipelineLayout,
-VkRenderPass                                        renderPass,
-const std::vector<VkPipelineShaderStageCreateInfo>& shaderStages,
-const PipelineFormat&                               format,
-const DVertexInputLayoutVulkan&                     vertexLayout,
-uint32_t                                            stride)
+VulkanContext::_createPipeline(VkPipelineLayout            pipelineLayout,
+VkRenderPass                                               renderPass,
+const std::vector<VkPipelineShaderStageCreateInfo>&        shaderStages,
+const PipelineFormat&                                      format,
+const DVertexInputLayoutVulkan&                            vertexLayout,
+const std::array<uint32_t, VertexLayoutInfo::MAX_STREAMS>& streamStrides,
+const VkPipelineRenderingCreateInfoKHR*                    renderingInfo)
 {
     // Create pipeline
     VkPipeline graphicsPipeline{};
@@ -2278,12 +3881,9 @@ uint32_t                                            stride)
         // Binding
         const auto vertexInputAttributes = vertexLayout.VertexInputAttributes;
 
-        VkVertexInputBindingDescription inputBinding{};
-        inputBinding.binding   = 0;
-        inputBinding.stride    = stride;
-        inputBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        const auto inputBindings = VkUtils::convertVertexInputBindings(vertexLayout.StreamInputRates, streamStrides);
         // Attributes
-        RIVulkanPipelineBuilder pipe(shaderStages, { inputBinding }, vertexInputAttributes, pipelineLayout, renderPass);
+        RIVulkanPipelineBuilder pipe(shaderStages, inputBindings, vertexInputAttributes, pipelineLayout, renderPass);
         pipe.AddViewport({});
         pipe.AddScissor({});
         pipe.SetDynamicState({ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR });
@@ -2355,6 +3955,9 @@ uint32_t                                            stride)
                     break;
             }
 
+        // With dynamic rendering the pipeline is created against the attachment formats instead of a render pass
+        pipe.PipelineCreateInfo.pNext = renderingInfo;
+
         graphicsPipeline = Device.CreatePipeline(&pipe.PipelineCreateInfo);
     }
 
@@ -2366,7 +3969,12 @@ VulkanContext::FlushDeletedBuffers()
 {
     if (_deletionQueue.size() > 0)
         {
-            WaitDeviceIdle();
+            // Waits only for the submissions the last destroyed resources could be used by
+            const TimelineValues values = _deletionQueue.back().first;
+            for (size_t i = 0; i < _queueTimelines.size(); i++)
+                {
+                    Device.WaitSemaphoreValue(_queueTimelines[i].Semaphore, values[i], UINT64_MAX);
+                }
             while (_deletionQueue.size() > 0)
                 {
                     _performDeletionQueue();
@@ -2404,21 +4012,43 @@ VulkanContext::Log(const std::string& error)
         }
 }
 
+void
+VulkanContext::_updateCompletedValues()
+{
+    for (auto& timeline : _queueTimelines)
+        {
+            if (timeline.CompletedValue < timeline.SubmittedValue)
+                {
+                    timeline.CompletedValue = Device.GetSemaphoreCounterValue(timeline.Semaphore);
+                }
+        }
+}
+
 void
 VulkanContext::_performDeletionQueue()
 {
-    // Free resource if N frames have passed
-    std::for_each(_deletionQueue.begin(), _deletionQueue.end(), [this](FramesWaitToDeletionList& pair) {
-        if (pair.first == 0)
+    _updateCompletedValues();
+
+    // Lists are in submission order, the first one not completed is followed by not completed ones
+    const auto completedEnd = std::find_if(_deletionQueue.begin(), _deletionQueue.end(), [this](const TimelineWaitToDeletionList& pair) {
+        for (size_t i = 0; i < _queueTimelines.size(); i++)
             {
-                std::for_each(pair.second.begin(), pair.second.end(), [](const DeleteFn& fn) { fn(); });
+                if (pair.first[i] > _queueTimelines[i].CompletedValue)
+                    return true;
             }
+        return false;
     });
-    // Remove from queue all deleted fn
-    _deletionQueue.erase(std::remove_if(_deletionQueue.begin(), _deletionQueue.end(), [](const FramesWaitToDeletionList& pair) { return pair.first == 0; }), _deletionQueue.end());
+    if (completedEnd == _deletionQueue.begin())
+        return;
+
+    // Moved out of the queue first, a destruction can defer other ones
+    std::vector<TimelineWaitToDeletionList> completed(std::make_move_iterator(_deletionQueue.begin()), std::make_move_iterator(completedEnd));
+    _deletionQueue.erase(_deletionQueue.begin(), completedEnd);
 
-    // Decrease the frame number to wait
-    std::for_each(_deletionQueue.begin(), _deletionQueue.end(), [this](FramesWaitToDeletionList& pair) { pair.first--; });
+    // Queued descriptor writes keep raw handles, they're applied while the resources they reference are still alive
+    FlushDescriptorWrites();
+
+    std::for_each(completed.begin(), completed.end(), [](const TimelineWaitToDeletionList& pair) { std::for_each(pair.second.begin(), pair.second.end(), [](const DeleteFn& fn) { fn(); }); });
 }
 
 RIVkRenderPassInfo
@@ -2456,6 +4086,8 @@ VulkanContext::_createRenderPass(const DRenderPassAttachments& attachments)
 VkRenderPass
 VulkanContext::_createRenderPassFromInfo(const RIVkRenderPassInfo& info)
 {
+    std::lock_guard<std::recursive_mutex> lock(_renderPassMutex);
+
     VkRenderPass   renderPass{};
     const VkResult result = Device.CreateRenderPass(info, &renderPass);
     if (VKFAILED(result))
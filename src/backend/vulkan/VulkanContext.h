@@ -5,13 +5,20 @@
 #include "IContext.h"
 
 #include "DescriptorPool.h"
+#include "RIResourceTable.h"
 #include "RingBufferManager.h"
+#include "VulkanBarrierBatch.h"
+#include "VulkanDescriptorWriteBatch.h"
 #include "VulkanDevice13.h"
 #include "VulkanInstance.h"
 
 #include <array>
+#include <atomic>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -20,7 +27,8 @@ namespace Fox
 
 struct DResource
 {
-    uint8_t Id{};
+    uint32_t Id{}; // The full resource id while alive
+    uint16_t Generation{}; // Increased every time the slot is reused
 };
 
 struct DBufferVulkan : public DResource
@@ -29,12 +37,21 @@ struct DBufferVulkan : public DResource
     RIVulkanBuffer Buffer;
 };
 
+/*State of every mip level and array layer of an image in recording order, index is arrayLayer * MipLevels + mipLevel*/
+struct DSubresourceStates
+{
+    uint32_t                    MipLevels{};
+    uint32_t                    ArrayLayers{};
+    std::vector<EResourceState> States;
+};
+
 struct DImageVulkan : public DResource
 {
     RIVulkanImage      Image;
     VkImageView        View{};
     VkImageAspectFlags ImageAspect{};
     VkSampler          Sampler{};
+    DSubresourceStates States;
 };
 
 struct DRenderTargetVulkan : public DResource
@@ -42,6 +59,8 @@ struct DRenderTargetVulkan : public DResource
     RIVulkanImage      Image;
     VkImageView        View{};
     VkImageAspectFlags ImageAspect{};
+    VmaAllocation      AliasingMemory{}; // Transient render targets only, shared with the other render targets of its alias group
+    DSubresourceStates States;
 };
 
 struct DFramebufferVulkan : public DResource
@@ -64,9 +83,11 @@ struct DSwapchainVulkan : public DResource
     uint32_t                              RenderTargetsId[MAX_IMAGE_COUNT]{};
 };
 
+/*Every vertex stream is a binding of the same index*/
 struct DVertexInputLayoutVulkan : public DResource
 {
-    std::vector<VkVertexInputAttributeDescription> VertexInputAttributes;
+    std::vector<VkVertexInputAttributeDescription>                              VertexInputAttributes;
+    std::array<std::optional<VkVertexInputRate>, VertexLayoutInfo::MAX_STREAMS> StreamInputRates; // Empty if no attribute reads the stream
 };
 
 struct DPipelineVulkan_DEPRECATED : public DPipeline_T
@@ -80,18 +101,92 @@ struct DPipelineVulkan : public DResource
 {
     VkPipeline              Pipeline{};
     const VkPipelineLayout* PipelineLayout{};
+    bool                    BindlessHeap{}; // The heap is bound with the pipeline
 };
 
 struct DCommandPoolVulkan : public DResource
 {
     VkCommandPool Pool{};
+    EQueueType    QueueType{};
+};
+
+/*Transition of a whole buffer or of an image subresource range*/
+struct DTransitionVulkan
+{
+    VkImage            Image{}; // Null for buffer transitions
+    VkBuffer           Buffer{};
+    VkImageAspectFlags Aspect{};
+    EResourceState     CurrentState{};
+    EResourceState     NewState{};
+    uint32_t           MipLevel{};
+    uint32_t           LevelCount{};
+    uint32_t           ArrayLayer{};
+    uint32_t           LayerCount{};
+    EResourceState     AliasedState{}; // Last state of the resource previously using the same memory
+    // Different for a release or acquire of a queue family ownership transfer
+    uint32_t SrcQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED };
+    uint32_t DstQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED };
+};
+
+/*Transition started by a BeginOnly barrier, the matching EndOnly barrier waits for its event*/
+struct DSplitTransitionVulkan
+{
+    DTransitionVulkan Transition;
+    VkEvent           Event{};
+};
+
+/*Descriptor sets bound with the same pipeline layout, binding one with another layout can disturb the others*/
+struct DBoundDescriptorSetsVulkan
+{
+    VkPipelineLayout                                                      Layout{};
+    std::array<VkDescriptorSet, (size_t)EDescriptorFrequency::MAX_COUNT> Sets{};
+};
+
+/*State last bound on a command buffer, it persists across render passes until the recording ends*/
+struct DBoundStateVulkan
+{
+    std::array<VkPipeline, 2>                                     Pipelines{}; // By bind point, graphics and compute
+    std::array<VkPipelineLayout, 2>                               PipelineLayouts{}; // Of the bound pipelines, push constants are written with it
+    std::array<DBoundDescriptorSetsVulkan, 2>                     DescriptorSets{}; // By bind point
+    std::array<DBoundBufferVulkan, VertexLayoutInfo::MAX_STREAMS> VertexBuffers{}; // By stream
+    DBoundBufferVulkan                                            IndexBuffer{};
+    VkIndexType                                                   IndexType{ VK_INDEX_TYPE_UINT32 };
+    std::optional<VkViewport>                                     Viewport;
+    std::optional<VkRect2D>                                       Scissor;
 };
 
 struct DCommandBufferVulkan : public DResource
 {
-    VkCommandBuffer Cmd{};
-    bool            IsRecording{};
-    VkRenderPass    ActiveRenderPass{};
+    VkCommandBuffer                     Cmd{};
+    EQueueType                          QueueType{}; // Queue type of its command pool
+    bool                                IsRecording{};
+    bool                                IsInRenderPass{};
+    RIVkBarrierBatch                    Barriers; // Flushed at the next render pass begin, copy or end of recording
+    std::vector<DSplitTransitionVulkan> SplitTransitions; // Begun and not ended yet
+    std::vector<VkEvent>                Events; // Reset on the host when recording begins again
+    uint32_t                            UsedEvents{};
+    DBoundStateVulkan                   BoundState;
+    DRedundantStateCounters             RedundantState;
+};
+
+/*Render pass compiled ahead of time, binding it only records vkCmdBeginRenderPass or vkCmdBeginRenderingKHR*/
+struct DRenderPassVulkan : public DResource
+{
+    static constexpr uint32_t MAX_CLEAR_VALUES = DFramebufferAttachments::MAX_ATTACHMENTS + 1;
+
+    VkRenderPass            RenderPass{};
+    uint32_t                FramebufferId{};
+    VkClearValue            ClearValues[MAX_CLEAR_VALUES]{};
+    VkRenderPassBeginInfo   BeginInfo{};
+    DFramebufferAttachments Attachments;
+    // Dynamic rendering only
+    VkRenderingAttachmentInfoKHR ColorAttachments[DFramebufferAttachments::MAX_ATTACHMENTS]{};
+    VkRenderingAttachmentInfoKHR DepthAttachment{};
+    VkRenderingAttachmentInfoKHR StencilAttachment{};
+    VkRenderingInfoKHR           RenderingInfo{};
+    // Cleared attachments are transitioned from undefined layout like the render pass would do
+    VkImageMemoryBarrier ClearBarriers[MAX_CLEAR_VALUES]{};
+    uint32_t             ClearBarrierCount{};
 };
 
 struct DFenceVulkan : public DResource
@@ -105,20 +200,50 @@ struct DSemaphoreVulkan : public DResource
     VkSemaphore Semaphore{};
 };
 
+struct DSubmitScratchVulkan
+{
+    std::vector<VkCommandBuffer>      CommandBuffers;
+    std::vector<VkSemaphore>          WaitSemaphores;
+    std::vector<uint64_t>             WaitValues;
+    std::vector<VkPipelineStageFlags> WaitStages;
+    std::vector<VkSemaphore>          SignalSemaphores;
+    std::vector<uint64_t>             SignalValues;
+};
+
+/*Command pool of a thread for one frame in flight, its command buffers are handed out in order and recycled together*/
+struct DManagedCommandPoolVulkan
+{
+    uint32_t              Pool{};
+    std::vector<uint32_t> CommandBuffers;
+    uint32_t              Acquired{};
+    uint64_t              Frame{}; // Frame its command buffers were acquired in
+};
+
+/*Every submission signals the next value of the timeline of its queue, the values reached tell which submissions completed*/
+struct DQueueTimelineVulkan
+{
+    VkSemaphore Semaphore{};
+    uint64_t    SubmittedValue{};
+    uint64_t    CompletedValue{};
+};
+
 struct DShaderVulkan : public DResource
 {
-    VertexInputLayoutId                          VertexLayout{};
-    uint32_t                                     VertexStride{};
-    VkShaderModule                               VertexShaderModule{};
-    VkShaderModule                               PixelShaderModule{};
-    std::vector<VkPipelineShaderStageCreateInfo> ShaderStageCreateInfo;
-    uint32_t                                     ColorAttachments{ 1 };
-    bool                                         DepthStencilAttachment{};
+    VertexInputLayoutId                                 VertexLayout{};
+    std::array<uint32_t, VertexLayoutInfo::MAX_STREAMS> StreamStrides{};
+    VkShaderModule                                      VertexShaderModule{};
+    VkShaderModule                                      PixelShaderModule{};
+    VkShaderModule                                      ComputeShaderModule{};
+    std::vector<VkPipelineShaderStageCreateInfo>        ShaderStageCreateInfo;
+    uint32_t                                            ColorAttachments{ 1 };
+    bool                                                DepthStencilAttachment{};
 };
 
 struct DRootSignature : public DResource
 {
-    VkPipelineLayout PipelineLayout{};
+    VkPipelineLayout    PipelineLayout{};
+    VkPipelineBindPoint BindPoint{}; // Compute if its bindings are compute stage ones
+    bool                BindlessHeap{}; // The pipeline layout has the heap at BINDLESS_HEAP_SET
     /*Since VkDescriptorSetLayout are cached it can be used by multiple shaders, be careful when deleting*/
     VkDescriptorSetLayout DescriptorSetLayouts[(uint32_t)EDescriptorFrequency::MAX_COUNT]{};
     // VkDescriptorPool                  EmptyPools[(uint32_t)EDescriptorFrequency::MAX_COUNT];
@@ -136,6 +261,8 @@ struct DDescriptorSet : public DResource
     EDescriptorFrequency                         Frequency;
     std::map<uint32_t, ShaderDescriptorBindings> Bindings;
     const DRootSignature*                        RootSignature{};
+    // Per set, texture id by binding and array element. Transitioned to shader resource when bound with automatic barriers
+    std::vector<std::unordered_map<uint64_t, uint32_t>> SampledTextures;
 };
 
 struct DSamplerVulkan : public DResource
@@ -143,6 +270,16 @@ struct DSamplerVulkan : public DResource
     VkSampler Sampler{};
 };
 
+/*Single update-after-bind set shared by all the root signatures with the heap, the array of a resource type is as large as
+its resource table unless the device limits are lower*/
+struct DBindlessHeapVulkan
+{
+    VkDescriptorSetLayout                                         Layout{};
+    VkDescriptorPool                                              Pool{};
+    VkDescriptorSet                                               Set{};
+    std::array<uint32_t, (size_t)EBindlessHeapBinding::MAX_COUNT> Sizes{}; // By binding
+};
+
 class VulkanContext final : public IContext
 {
     inline static constexpr uint32_t NUM_OF_FRAMES_IN_FLIGHT{ 2 };
@@ -167,16 +304,19 @@ class VulkanContext final : public IContext
     ShaderId            CreateShader(const ShaderSource& source) override;
     void                DestroyShader(const ShaderId shader) override;
     uint32_t            CreateSampler(uint32_t minLod, uint32_t maxLod) override;
+    uint32_t            GetBindlessIndex(uint32_t resourceId) const override;
 
     uint32_t CreatePipeline(const ShaderId shader, uint32_t rootSignatureId, const DPipelineAttachments& attachments, const PipelineFormat& format) override;
+    uint32_t CreateComputePipeline(const ShaderId shader, uint32_t rootSignatureId) override;
     void     DestroyPipeline(uint32_t pipelineId) override;
     uint32_t CreateRootSignature(const ShaderLayout& layout) override;
     void     DestroyRootSignature(uint32_t rootSignatureId) override;
     uint32_t CreateDescriptorSets(uint32_t rootSignatureId, EDescriptorFrequency frequency, uint32_t count) override;
     void     DestroyDescriptorSet(uint32_t descriptorSetId) override;
     void     UpdateDescriptorSet(uint32_t descriptorSetId, uint32_t setIndex, uint32_t paramCount, DescriptorData* params) override;
+    void     FlushDescriptorWrites() override;
 
-    uint32_t CreateCommandPool() override;
+    uint32_t CreateCommandPool(EQueueType queueType = EQueueType::GRAPHICS) override;
     void     DestroyCommandPool(uint32_t commandPoolId) override;
     void     ResetCommandPool(uint32_t commandPoolId) override;
 
@@ -184,16 +324,32 @@ class VulkanContext final : public IContext
     void     DestroyCommandBuffer(uint32_t commandBufferId) override;
     void     BeginCommandBuffer(uint32_t commandBufferId) override;
     void     EndCommandBuffer(uint32_t commandBufferId) override;
+    uint32_t AcquireCommandBuffer(EQueueType queueType = EQueueType::GRAPHICS) override;
+    void     BeginFrame() override;
+
+    DRedundantStateCounters GetRedundantStateCounters(uint32_t commandBufferId) const override;
+
+    uint32_t CreateRenderPass(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP) override;
+    void     DestroyRenderPass(uint32_t renderPassId) override;
+    void     BindRenderPass(uint32_t commandBufferId, uint32_t renderPassId) override;
 
     void BindRenderTargets(uint32_t commandBufferId, const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP) override;
     void SetViewport(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float znear, float zfar) override;
     void SetScissor(uint32_t commandBufferId, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
     void BindPipeline(uint32_t commandBufferId, uint32_t pipeline) override;
-    void BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId) override;
-    void BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId) override;
+    void BindVertexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0) override;
+    void BindInstanceBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0) override;
+    void BindVertexBuffers(uint32_t commandBufferId, uint32_t firstStream, std::span<const uint32_t> bufferIds, std::span<const uint64_t> offsets) override;
+    void BindIndexBuffer(uint32_t commandBufferId, uint32_t bufferId, uint64_t offset = 0, EIndexType indexType = EIndexType::UINT32) override;
     void Draw(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count) override;
     void DrawIndexed(uint32_t commandBufferId, uint32_t index_count, uint32_t first_index, uint32_t first_vertex) override;
+    void DrawInstanced(uint32_t commandBufferId, uint32_t firstVertex, uint32_t count, uint32_t firstInstance, uint32_t instanceCount) override;
+    void DrawIndexedInstanced(uint32_t commandBufferId, uint32_t indexCount, uint32_t firstIndex, uint32_t firstVertex, uint32_t firstInstance, uint32_t instanceCount) override;
     void DrawIndexedIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t drawCount, uint32_t stride) override;
+    void DrawIndexedIndirectCount(uint32_t commandBufferId, uint32_t buffer, uint32_t offset, uint32_t countBuffer, uint32_t countOffset, uint32_t maxDrawCount, uint32_t stride) override;
+    void Dispatch(uint32_t commandBufferId, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+    void DispatchIndirect(uint32_t commandBufferId, uint32_t buffer, uint32_t offset) override;
+    void PushConstants(uint32_t commandBufferId, EShaderStage stage, uint32_t offset, uint32_t size, const void* data) override;
     void BindDescriptorSet(uint32_t commandBufferId, uint32_t setIndex, uint32_t descriptorSetId) override;
     void CopyImage(uint32_t commandId, uint32_t imageId, uint32_t width, uint32_t height, uint32_t mipMapIndex, uint32_t stagingBufferId, uint32_t stagingBufferOffset) override;
 
@@ -207,9 +363,17 @@ class VulkanContext final : public IContext
     uint32_t CreateGpuSemaphore() override;
     void     DestroyGpuSemaphore(uint32_t semaphoreId) override;
 
+    uint32_t CreateTimelineSemaphore(uint64_t initialValue) override;
+    void     DestroyTimelineSemaphore(uint32_t semaphoreId) override;
+    uint64_t GetTimelineSemaphoreValue(uint32_t semaphoreId) override;
+    bool     WaitTimelineSemaphore(uint32_t semaphoreId, uint64_t value, uint64_t timeoutNanoseconds) override;
+    void     SignalTimelineSemaphore(uint32_t semaphoreId, uint64_t value) override;
+
     uint32_t CreateRenderTarget(EFormat format, ESampleBit samples, bool isDepth, uint32_t width, uint32_t height, uint32_t arrayLength, uint32_t mipMapCount, EResourceState initialState) override;
     void     DestroyRenderTarget(uint32_t renderTargetId) override;
+    void     CreateTransientRenderTargets(uint32_t count, const DTransientRenderTargetDesc* descs, uint32_t* outRenderTargetIds) override;
 
+    void ResourceBarrier(uint32_t commandBufferId, std::span<const BufferBarrier> bufferBarriers, std::span<const TextureBarrier> textureBarriers, std::span<const RenderTargetBarrier> renderTargetBarriers) override;
     void ResourceBarrier(uint32_t commandBufferId,
     uint32_t                      buffer_barrier_count,
     BufferBarrier*                p_buffer_barriers,
@@ -220,18 +384,39 @@ class VulkanContext final : public IContext
 
     void FlushDeletedBuffers() override;
 
+    void QueueSubmit(std::span<const uint32_t> waitSemaphore,
+    std::span<const DTimelineValue>           waitTimeline,
+    std::span<const uint32_t>                 finishSemaphore,
+    std::span<const DTimelineValue>           signalTimeline,
+    std::span<const uint32_t>                 cmdIds,
+    uint32_t                                  fenceId) override;
+    void QueuePresent(uint32_t swapchainId, uint32_t imageIndex, std::span<const uint32_t> waitSemaphore) override;
     void QueueSubmit(const std::vector<uint32_t>& waitSemaphore, const std::vector<uint32_t>& finishSemaphore, const std::vector<uint32_t>& cmdIds, uint32_t fenceId) override;
+    void QueueSubmit(const std::vector<uint32_t>& waitSemaphore,
+    const std::vector<DTimelineValue>&           waitTimeline,
+    const std::vector<uint32_t>&                 finishSemaphore,
+    const std::vector<DTimelineValue>&           signalTimeline,
+    const std::vector<uint32_t>&                 cmdIds) override;
     void QueuePresent(uint32_t swapchainId, uint32_t imageIndex, const std::vector<uint32_t>& waitSemaphore) override;
 
     unsigned char* GetAdapterDescription() const override;
     size_t         GetAdapterDedicatedVideoMemory() const override;
 
 #pragma region Utility
-    RIVulkanDevice13& GetDevice() { return Device; }
+    RIVulkanDevice13&          GetDevice() { return Device; }
+    bool                       HasDrawIndirectCount() const { return _drawIndirectCount; }
+    bool                       HasDynamicRendering() const { return _dynamicRendering; } // Requested and supported by the device
+    bool                       HasSynchronization2() const { return _synchronization2; } // Requested and supported by the device
+    const DImageVulkan&        GetImage(ImageId imageId) const;
+    const DRenderTargetVulkan& GetRenderTarget(uint32_t renderTargetId) const;
+    const DRenderPassVulkan&   GetRenderPass(uint32_t renderPassId) const;
+    /*True if every attachment the render pass was created with is still alive, BindRenderPass checks it in debug*/
+    bool                       IsRenderPassAlive(uint32_t renderPassId) const;
+    /*Layout of the pipeline bound to the bind point of the stage, null if none is bound. PushConstants writes with it*/
+    VkPipelineLayout           GetBoundPipelineLayout(uint32_t commandBufferId, EShaderStage stage) const;
 #pragma endregion
 
   private:
-    static constexpr uint32_t MAX_RESOURCES     = 1024; // Change this number to increase number of allocations per resource
     static constexpr uint64_t MAX_FENCE_TIMEOUT = 0xffff; // 0xffffffffffffffff; // nanoseconds
     RIVulkanInstance          Instance;
     RIVulkanDevice13          Device;
@@ -239,36 +424,68 @@ class VulkanContext final : public IContext
     void (*_warningOutput)(const char*);
     void (*_logOutput)(const char*);
 
-    DBufferVulkan                               _emptyUbo;
-    uint32_t                                    _emptyImageId{};
-    DImageVulkan*                               _emptyImage;
-    DSamplerVulkan                              _emptySampler;
-    std::array<DSwapchainVulkan, MAX_RESOURCES> _swapchains;
-    std::array<DBufferVulkan, MAX_RESOURCES>    _vertexBuffers;
-    std::array<DBufferVulkan, MAX_RESOURCES>    _transferBuffers;
-    std::array<DBufferVulkan, MAX_RESOURCES>    _uniformBuffers;
-    std::array<DBufferVulkan, MAX_RESOURCES>    _indirectBuffers;
-    /*Whenever a render target gets deleted remove also framebuffers that have that image id as attachment*/
-    std::array<DFramebufferVulkan, MAX_RESOURCES>       _framebuffers;
-    std::array<DShaderVulkan, MAX_RESOURCES>            _shaders;
-    std::array<DVertexInputLayoutVulkan, MAX_RESOURCES> _vertexLayouts;
-    std::array<DImageVulkan, MAX_RESOURCES>             _images;
-    std::array<DPipelineVulkan, MAX_RESOURCES>          _pipelines;
-    std::array<DCommandPoolVulkan, MAX_RESOURCES>       _commandPools_DEPRECATED;
-    std::array<DFenceVulkan, MAX_RESOURCES>             _fences;
-    std::array<DSamplerVulkan, MAX_RESOURCES>           _samplers;
-    std::array<DSemaphoreVulkan, MAX_RESOURCES>         _semaphores;
-    std::array<DCommandPoolVulkan, MAX_RESOURCES>       _commandPools;
-    std::array<DCommandBufferVulkan, MAX_RESOURCES>     _commandBuffers;
-    std::array<DRenderTargetVulkan, MAX_RESOURCES>      _renderTargets;
-    std::array<DRootSignature, MAX_RESOURCES>           _rootSignatures;
-    std::array<DDescriptorSet, MAX_RESOURCES>           _descriptorSets;
-    std::unordered_set<VkRenderPass>                    _renderPasses;
-
-    using DeleteFn                 = std::function<void()>;
-    using FramesWaitToDeletionList = std::pair<uint32_t, std::vector<DeleteFn>>;
-    uint32_t                              _frameIndex{};
-    std::vector<FramesWaitToDeletionList> _deletionQueue;
+    DBufferVulkan                             _emptyUbo;
+    uint32_t                                  _emptyImageId{};
+    DImageVulkan*                             _emptyImage;
+    DSamplerVulkan                            _emptySampler;
+    RIResourceTable<DSwapchainVulkan>         _swapchains;
+    RIResourceTable<DBufferVulkan>            _vertexBuffers;
+    RIResourceTable<DBufferVulkan>            _transferBuffers;
+    RIResourceTable<DBufferVulkan>            _uniformBuffers;
+    RIResourceTable<DBufferVulkan>            _indirectBuffers;
+    RIResourceTable<DFramebufferVulkan>       _framebuffers;
+    RIResourceTable<DShaderVulkan>            _shaders;
+    RIResourceTable<DVertexInputLayoutVulkan> _vertexLayouts;
+    RIResourceTable<DImageVulkan>             _images;
+    RIResourceTable<DPipelineVulkan>          _pipelines;
+    RIResourceTable<DFenceVulkan>             _fences;
+    RIResourceTable<DSamplerVulkan>           _samplers;
+    RIResourceTable<DSemaphoreVulkan>         _semaphores;
+    RIResourceTable<DCommandPoolVulkan>       _commandPools;
+    RIResourceTable<DCommandBufferVulkan>     _commandBuffers;
+    RIResourceTable<DRenderTargetVulkan>      _renderTargets;
+    RIResourceTable<DRootSignature>           _rootSignatures;
+    RIResourceTable<DDescriptorSet>           _descriptorSets;
+    RIResourceTable<DRenderPassVulkan>        _renderPassObjects;
+    std::unordered_set<VkRenderPass>          _renderPasses;
+    bool                                      _dynamicRendering{};
+    bool                                      _automaticBarriers{};
+    bool                                      _synchronization2{};
+    bool                                      _drawIndirectCount{}; // VK_KHR_draw_indirect_count is supported
+    /*Framebuffer id by attachments, whenever a render target gets deleted remove also framebuffers that have it as attachment*/
+    std::unordered_map<DFramebufferAttachments, uint32_t, DFramebufferAttachmentsHashFn, DFramebufferAttachmentEqualFn> _framebufferCache;
+    /*Guards the framebuffer and render pass caches, render targets are bound from the recording threads. Recursive because
+    creating a framebuffer creates its render pass*/
+    std::recursive_mutex _renderPassMutex;
+    /*Guards the command pool list of the device, pools are created and destroyed from the recording threads*/
+    std::mutex _commandPoolMutex;
+    /*Number of transient render targets alive per aliasing memory, memory is freed with the last one*/
+    std::unordered_map<VmaAllocation, uint32_t> _aliasingMemoryRefCount;
+
+    std::array<DQueueTimelineVulkan, (size_t)EQueueType::MAX_QUEUE_TYPE> _queueTimelines;
+    DBindlessHeapVulkan                                                   _bindlessHeap;
+    /*Descriptor set updates queued until the next bind of a set, frame or explicit flush. Guarded because sets are bound from
+    the recording threads*/
+    RIVkDescriptorWriteBatch _descriptorWrites;
+    std::mutex               _descriptorWritesMutex;
+    /*Set while writes are queued so binding a set doesn't take the mutex when there is nothing to flush*/
+    std::atomic<bool>        _hasPendingDescriptorWrites{};
+
+    using DeleteFn       = std::function<void()>;
+    using TimelineValues = std::array<uint64_t, (size_t)EQueueType::MAX_QUEUE_TYPE>;
+    /*Submitted value of every queue timeline at destruction, the resources are released once all of them are reached*/
+    using TimelineWaitToDeletionList = std::pair<TimelineValues, std::vector<DeleteFn>>;
+    std::vector<TimelineWaitToDeletionList> _deletionQueue;
+    /*Handles of the last submission or presentation, they keep their capacity so that the frame loop doesn't allocate*/
+    DSubmitScratchVulkan _submitScratch;
+
+    /*Managed command pools of every thread that acquired a command buffer, by frame in flight and queue type*/
+    using ThreadCommandPools = std::array<std::array<DManagedCommandPoolVulkan, (size_t)EQueueType::MAX_QUEUE_TYPE>, NUM_OF_FRAMES_IN_FLIGHT>;
+    std::unordered_map<std::thread::id, ThreadCommandPools> _threadCommandPools;
+    std::mutex                                              _threadCommandPoolsMutex;
+    uint64_t                                                _frameCount{};
+    /*Submitted values when each frame in flight ended, its managed pools are reset once they are reached*/
+    std::array<TimelineValues, NUM_OF_FRAMES_IN_FLIGHT> _frameRetireValues{};
 
     // Staging buffer, used to copy stuff from ram to CPU-VISIBLE-MEMORY then to GPU-ONLY-MEMORY
     std::vector<std::vector<uint32_t>> _perFrameCopySizes;
@@ -315,11 +532,13 @@ class VulkanContext final : public IContext
         "VK_KHR_Maintenance1", // passing negative viewport heights
         "VK_KHR_maintenance4",
         "VK_KHR_dedicated_allocation",
-        "VK_KHR_bind_memory2" };
+        "VK_KHR_bind_memory2",
+        VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME };
 
     void Warning(const std::string& error);
     void Log(const std::string& error);
 
+    void _initializeResourcePools(const DContextConfig* const config);
     void _initializeVolk();
     void _initializeInstance();
     void _initializeDebugger();
@@ -327,9 +546,36 @@ class VulkanContext final : public IContext
     void _initializeDevice();
     void _initializeStagingBuffer(uint32_t stagingBufferSize);
     void _deinitializeStagingBuffer();
+    void _initializeQueueTimelines();
+    void _deinitializeQueueTimelines();
+    void _initializeBindlessHeap(const DContextConfig* const config);
+    void _deinitializeBindlessHeap();
 
     uint32_t               _createFramebuffer(const DFramebufferAttachments& attachments);
     void                   _destroyFramebuffer(uint32_t framebufferId);
+    void                   _destroyFramebuffersWithAttachment(uint32_t renderTargetId);
+    void                   _compileRenderPass(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP, DRenderPassVulkan& renderPassRef);
+    void                   _compileDynamicRendering(const DFramebufferAttachments& attachments, const DLoadOpPass& loadOP, DRenderPassVulkan& renderPassRef);
+    void                   _beginRenderPass(uint32_t commandBufferId, const DRenderPassVulkan& renderPassRef);
+    void                   _endRenderPass(DCommandBufferVulkan& commandBufferRef);
+    void                   _queueImageBarrier(DCommandBufferVulkan& commandBufferRef, VkImage image, VkImageAspectFlags aspect, EResourceState currentState, EResourceState newState, uint32_t mipLevel, uint32_t levelCount, uint32_t arrayLayer, uint32_t layerCount, EResourceState aliasedState = EResourceState::UNDEFINED);
+    void                   _queueBufferBarrier(DCommandBufferVulkan& commandBufferRef, VkBuffer buffer, EResourceState currentState, EResourceState newState);
+    void                   _resourceTransition(DCommandBufferVulkan& commandBufferRef, const DTransitionVulkan& transition, bool beginOnly, bool endOnly);
+    void                   _recordSplitTransition(DCommandBufferVulkan& commandBufferRef, const DSplitTransitionVulkan& split, bool wait);
+    void                   _endSplitTransitions(DCommandBufferVulkan& commandBufferRef);
+    bool                   _setOwnershipTransfer(const DCommandBufferVulkan& commandBufferRef, DTransitionVulkan& transition, bool acquire, bool release, EQueueType queueType);
+    void                   _queueOwnershipTransfer(DCommandBufferVulkan& commandBufferRef, const DTransitionVulkan& transition);
+    void                   _bufferTransition(DCommandBufferVulkan& commandBufferRef, const BufferBarrier& barrier);
+    void                   _textureTransition(DCommandBufferVulkan& commandBufferRef, const TextureBarrier& barrier);
+    void                   _renderTargetTransition(DCommandBufferVulkan& commandBufferRef, const RenderTargetBarrier& barrier);
+    uint32_t               _getQueueFamilyIndex(EQueueType queueType) const;
+    VkQueue                _getQueue(EQueueType queueType) const;
+    VkBuffer               _getBuffer(uint32_t bufferId);
+    void                   _flushBarriers(DCommandBufferVulkan& commandBufferRef);
+    void                   _transitionSubresources(DCommandBufferVulkan& commandBufferRef, VkImage image, VkImageAspectFlags aspect, DSubresourceStates& states, EResourceState newState, bool subresource, uint32_t mipLevel, uint32_t arrayLayer, EResourceState aliasedState = EResourceState::UNDEFINED);
+    void                   _trackedResourceBarrier(uint32_t commandBufferId, uint32_t bufferBarrierCount, const BufferBarrier* bufferBarriers, uint32_t textureBarrierCount, const TextureBarrier* textureBarriers, uint32_t renderTargetBarrierCount, const RenderTargetBarrier* renderTargetBarriers);
+    void                   _transitionAttachments(uint32_t commandBufferId, const DFramebufferAttachments& attachments);
+    void                   _transitionSampledTextures(uint32_t commandBufferId, const DDescriptorSet& descriptorSetRef, uint32_t setIndex);
     DRenderPassAttachments _createGenericRenderPassAttachments(const DFramebufferAttachments& att);
     DRenderPassAttachments _createGenericRenderPassAttachmentsFromPipelineAttachments(const DPipelineAttachments& att);
     void                   _createSwapchain(DSwapchainVulkan& swapchain, const WindowData* windowData, EPresentMode& presentMode, EFormat& outFormat);
@@ -337,14 +583,21 @@ class VulkanContext final : public IContext
     void                   _createVertexBuffer(uint32_t size, DBufferVulkan& buffer);
     void                   _createUniformBuffer(uint32_t size, DBufferVulkan& buffer);
     void                   _createShader(const ShaderSource& source, DShaderVulkan& shader);
+    void                   _updateCompletedValues();
     void                   _performDeletionQueue();
+    void                   _destroyThreadCommandPools();
+    void                   _bindPipeline(DCommandBufferVulkan& commandBufferRef, VkPipelineBindPoint bindPoint, const DPipelineVulkan& pipelineRef);
+    void                   _queueEmptyDescriptorWrites(VkDescriptorSet set, const std::map<uint32_t, ShaderDescriptorBindings>& bindings);
+    void                   _writeBindlessDescriptor(EBindlessHeapBinding binding, uint32_t index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo);
+    void                   _bindVertexBuffers(DCommandBufferVulkan& commandBufferRef, uint32_t firstStream, std::span<const uint32_t> bufferIds, std::span<const uint64_t> offsets);
     void                   _deferDestruction(DeleteFn&& fn);
-    VkPipeline             _createPipeline(VkPipelineLayout         pipelineLayout,
-                VkRenderPass                                        renderPass,
-                const std::vector<VkPipelineShaderStageCreateInfo>& shaderStages,
-                const PipelineFormat&                               format,
-                const DVertexInputLayoutVulkan&                     vertexLayout,
-                uint32_t                                            stride);
+    VkPipeline             _createPipeline(VkPipelineLayout                pipelineLayout,
+                VkRenderPass                                               renderPass,
+                const std::vector<VkPipelineShaderStageCreateInfo>&        shaderStages,
+                const PipelineFormat&                                      format,
+                const DVertexInputLayoutVulkan&                            vertexLayout,
+                const std::array<uint32_t, VertexLayoutInfo::MAX_STREAMS>& streamStrides,
+                const VkPipelineRenderingCreateInfoKHR*                    renderingInfo);
     void                   _recreateSwapchainBlocking(DSwapchainVulkan& swapchain);
     RIVkRenderPassInfo     _computeFramebufferAttachmentsRenderPassInfo(const std::vector<VkFormat>& attachmentFormat);
 
@@ -0,0 +1,92 @@
+// Copyright RedFox Studio 2022
+
+#include "VulkanDescriptorWriteBatch.h"
+
+#include "asserts.h"
+
+namespace Fox
+{
+
+inline bool
+IsImageDescriptor(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+}
+
+VkDescriptorImageInfo*
+RIVkDescriptorWriteBatch::AddImageWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count)
+{
+    check(IsImageDescriptor(type));
+
+    const size_t firstInfo = _imageInfos.size();
+    _addWrite(set, binding, arrayElement, type, count, firstInfo);
+    _imageInfos.resize(firstInfo + count);
+    return &_imageInfos[firstInfo];
+}
+
+VkDescriptorBufferInfo*
+RIVkDescriptorWriteBatch::AddBufferWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count)
+{
+    check(!IsImageDescriptor(type)); // Texel buffers aren't supported
+
+    const size_t firstInfo = _bufferInfos.size();
+    _addWrite(set, binding, arrayElement, type, count, firstInfo);
+    _bufferInfos.resize(firstInfo + count);
+    return &_bufferInfos[firstInfo];
+}
+
+void
+RIVkDescriptorWriteBatch::Flush(VkDevice device)
+{
+    if (_writes.empty())
+        return;
+
+    const auto& writes = GetWrites();
+    vkUpdateDescriptorSets(device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+    Clear();
+}
+
+void
+RIVkDescriptorWriteBatch::Clear()
+{
+    _writes.clear();
+    _firstInfos.clear();
+    _imageInfos.clear();
+    _bufferInfos.clear();
+}
+
+const std::vector<VkWriteDescriptorSet>&
+RIVkDescriptorWriteBatch::GetWrites()
+{
+    for (size_t i = 0; i < _writes.size(); i++)
+        {
+            VkWriteDescriptorSet& write = _writes[i];
+            if (IsImageDescriptor(write.descriptorType))
+                {
+                    write.pImageInfo = &_imageInfos[_firstInfos[i]];
+                }
+            else
+                {
+                    write.pBufferInfo = &_bufferInfos[_firstInfos[i]];
+                }
+        }
+    return _writes;
+}
+
+void
+RIVkDescriptorWriteBatch::_addWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count, size_t firstInfo)
+{
+    check(count > 0);
+
+    VkWriteDescriptorSet write{};
+    write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet          = set;
+    write.dstBinding      = binding;
+    write.dstArrayElement = arrayElement;
+    write.descriptorCount = count;
+    write.descriptorType  = type;
+
+    _writes.push_back(write);
+    _firstInfos.push_back(firstInfo);
+}
+}
@@ -0,0 +1,38 @@
+// Copyright RedFox Studio 2022
+
+#pragma once
+
+#include <volk.h>
+
+#include <vector>
+
+namespace Fox
+{
+/*Descriptor writes queued from several updates and applied together at the next flush by a single vkUpdateDescriptorSets.
+Writes are applied in the order they were queued, a later write of a descriptor overrides the earlier one. The memory is kept
+between flushes, queuing doesn't allocate once the batch has grown*/
+class RIVkDescriptorWriteBatch
+{
+  public:
+    /*Queues a write of count descriptors from arrayElement and returns their infos to be filled, valid until the next call*/
+    VkDescriptorImageInfo*  AddImageWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count);
+    VkDescriptorBufferInfo* AddBufferWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count);
+    /*Updates the sets with the queued writes, none of them can be bound to a command buffer being recorded or executed*/
+    void Flush(VkDevice device);
+    /*Drops the queued writes, eg. when their sets are destroyed*/
+    void Clear();
+
+    bool     IsEmpty() const { return _writes.empty(); };
+    uint32_t GetWriteCount() const { return (uint32_t)_writes.size(); };
+    /*Queued writes pointing to their infos, valid until the next call*/
+    const std::vector<VkWriteDescriptorSet>& GetWrites();
+
+  private:
+    std::vector<VkWriteDescriptorSet>   _writes;
+    std::vector<size_t>                 _firstInfos; // By write, the info arrays can grow so the pointers are set at flush
+    std::vector<VkDescriptorImageInfo>  _imageInfos;
+    std::vector<VkDescriptorBufferInfo> _bufferInfos;
+
+    void _addWrite(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, uint32_t count, size_t firstInfo);
+};
+}
@@ -16,6 +16,7 @@
 
 #include <volk.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace Fox
@@ -40,7 +41,9 @@ std::vector<const char*>                       validationLayers)
 
     PhysicalDevice = hardwareDevice;
 
-    _queueFamilyIndex = _queryGraphicsAndTransferQueueIndex();
+    _queueFamilyIndex         = _queryGraphicsAndTransferQueueIndex();
+    _transferQueueFamilyIndex = _queryTransferQueueIndex();
+    _computeQueueFamilyIndex  = _queryComputeQueueIndex();
 
     // Get it's physical properties
     vkGetPhysicalDeviceProperties(PhysicalDevice, &DeviceProperties);
@@ -50,20 +53,30 @@ std::vector<const char*>                       validationLayers)
 
     const float queuePriority = 1.f;
 
-    VkDeviceQueueCreateInfo queueCreateInfo{};
-    queueCreateInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = _queueFamilyIndex;
-    queueCreateInfo.queueCount       = 1;
-    queueCreateInfo.flags            = 0;
-    queueCreateInfo.pNext            = NULL;
-    queueCreateInfo.pQueuePriorities = &queuePriority;
+    // One queue per family, the transfer and compute queues share it when they fall back to the same family
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    for (const uint32_t queueFamilyIndex : { _queueFamilyIndex, _transferQueueFamilyIndex, _computeQueueFamilyIndex })
+        {
+            const auto sameFamily = [queueFamilyIndex](const VkDeviceQueueCreateInfo& info) { return info.queueFamilyIndex == queueFamilyIndex; };
+            if (std::any_of(queueCreateInfos.begin(), queueCreateInfos.end(), sameFamily))
+                continue;
+
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
+            queueCreateInfo.queueCount       = 1;
+            queueCreateInfo.flags            = 0;
+            queueCreateInfo.pNext            = NULL;
+            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
 
     VkDeviceCreateInfo deviceInfo{};
     deviceInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceInfo.pNext                   = pNext;
     deviceInfo.enabledExtensionCount   = 0;
-    deviceInfo.pQueueCreateInfos       = &queueCreateInfo;
-    deviceInfo.queueCreateInfoCount    = 1;
+    deviceInfo.pQueueCreateInfos       = queueCreateInfos.data();
+    deviceInfo.queueCreateInfoCount    = (uint32_t)queueCreateInfos.size();
     deviceInfo.pEnabledFeatures        = pNext ? nullptr : (optDeviceFeatures ? optDeviceFeatures : nullptr);
     deviceInfo.enabledExtensionCount   = (uint32_t)extensions.size();
     deviceInfo.ppEnabledExtensionNames = extensions.data();
@@ -130,6 +143,8 @@ std::vector<const char*>                       validationLayers)
     }
 
     vkGetDeviceQueue(Device, _queueFamilyIndex, 0, &MainQueue);
+    vkGetDeviceQueue(Device, _transferQueueFamilyIndex, 0, &TransferQueue);
+    vkGetDeviceQueue(Device, _computeQueueFamilyIndex, 0, &ComputeQueue);
 
     return VK_SUCCESS;
 }
@@ -177,4 +192,63 @@ RIVulkanDevice::_queryGraphicsAndTransferQueueIndex() const
 
     return graphicsAndTransferQueueFamilyIndex;
 }
+
+uint32_t
+RIVulkanDevice::_queryTransferQueueIndex() const
+{
+    uint32_t queueFamilyCount;
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+    // A family without graphics and compute is usually backed by the copy engine, otherwise any family without graphics
+    const auto findFamily = [&queueFamilyProperties](VkQueueFlags excludedFlags) {
+        return std::find_if(queueFamilyProperties.begin(), queueFamilyProperties.end(), [excludedFlags](const VkQueueFamilyProperties& p) {
+            return p.queueCount > 0 && (p.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(p.queueFlags & excludedFlags);
+        });
+    };
+
+    auto it = findFamily(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+    if (it == queueFamilyProperties.end())
+        {
+            it = findFamily(VK_QUEUE_GRAPHICS_BIT);
+        }
+
+    if (it == queueFamilyProperties.end())
+        {
+            std::cout << "No transfer only queue family, transfers fall back to the graphics queue\n";
+            return _queueFamilyIndex;
+        }
+
+    const uint32_t transferQueueFamilyIndex{ (uint32_t)std::distance(queueFamilyProperties.begin(), it) };
+
+    std::cout << "Transfer queue family index:" << transferQueueFamilyIndex << "\n";
+
+    return transferQueueFamilyIndex;
+}
+
+uint32_t
+RIVulkanDevice::_queryComputeQueueIndex() const
+{
+    uint32_t queueFamilyCount;
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+    auto it = std::find_if(queueFamilyProperties.begin(), queueFamilyProperties.end(), [](const VkQueueFamilyProperties& p) {
+        return p.queueCount > 0 && (p.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(p.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+    });
+
+    if (it == queueFamilyProperties.end())
+        {
+            std::cout << "No async compute queue family, compute work falls back to the graphics queue\n";
+            return _queueFamilyIndex;
+        }
+
+    const uint32_t computeQueueFamilyIndex{ (uint32_t)std::distance(queueFamilyProperties.begin(), it) };
+
+    std::cout << "Compute queue family index:" << computeQueueFamilyIndex << "\n";
+
+    return computeQueueFamilyIndex;
+}
 }
\ No newline at end of file
@@ -30,6 +30,12 @@ class RIVulkanDevice
     void     Deinit();
 
     inline int32_t GetQueueFamilyIndex() const { return _queueFamilyIndex; };
+    /*Same as the graphics queue family when the device has no transfer only queue family*/
+    inline int32_t GetTransferQueueFamilyIndex() const { return _transferQueueFamilyIndex; };
+    inline bool    HasDedicatedTransferQueue() const { return _transferQueueFamilyIndex != _queueFamilyIndex; };
+    /*Same as the graphics queue family when the device has no compute queue family without graphics*/
+    inline int32_t GetComputeQueueFamilyIndex() const { return _computeQueueFamilyIndex; };
+    inline bool    HasDedicatedComputeQueue() const { return _computeQueueFamilyIndex != _queueFamilyIndex; };
 
     inline int32_t GetMaxImageAllocations() const { return 4096; }
 
@@ -39,9 +45,15 @@ class RIVulkanDevice
     VkPhysicalDeviceProperties       DeviceProperties{}; /*Properties of the physical device*/
     VkPhysicalDeviceMemoryProperties DeviceMemory{}; /*Properties about the physical device memory*/
     VkQueue                          MainQueue{}; /* Graphics and Transfer queue*/
+    VkQueue                          TransferQueue{}; /* Transfer only queue, the main queue if the device has none*/
+    VkQueue                          ComputeQueue{}; /* Async compute queue, the main queue if the device has none*/
   private:
     uint32_t _queueFamilyIndex;
+    uint32_t _transferQueueFamilyIndex;
+    uint32_t _computeQueueFamilyIndex;
     uint32_t _queryGraphicsAndTransferQueueIndex() const;
+    uint32_t _queryTransferQueueIndex() const;
+    uint32_t _queryComputeQueueIndex() const;
 };
 
 }
\ No newline at end of file
@@ -261,6 +261,21 @@ VkPipeline RIVulkanDevice10::CreatePipeline(const VkGraphicsPipelineCreateInfo*
     return pipeline;
 }
 
+VkPipeline
+RIVulkanDevice10::CreatePipeline(const VkComputePipelineCreateInfo* info)
+{
+    VkPipeline     pipeline{};
+    const VkResult result = vkCreateComputePipelines(Device, VK_NULL_HANDLE, 1, info, nullptr, &pipeline);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    _pipelines.insert(pipeline);
+
+    return pipeline;
+}
+
 void
 RIVulkanDevice10::DestroyPipeline(VkPipeline pipeline)
 {
@@ -63,6 +63,7 @@ class RIVulkanDevice10 : public RIVulkanDevice9
   public:
     virtual ~RIVulkanDevice10();
     VkPipeline CreatePipeline(const VkGraphicsPipelineCreateInfo* info);
+    VkPipeline CreatePipeline(const VkComputePipelineCreateInfo* info);
     void       DestroyPipeline(VkPipeline pipeline);
 
   private:
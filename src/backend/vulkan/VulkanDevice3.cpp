@@ -33,6 +33,29 @@ RIVulkanDevice3::CreateVkSemaphore()
     return semaphore;
 }
 
+VkSemaphore
+RIVulkanDevice3::CreateTimelineSemaphore(uint64_t initialValue)
+{
+    VkSemaphoreTypeCreateInfoKHR typeInfo{};
+    typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue  = initialValue;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkSemaphore    semaphore{};
+    const VkResult result = vkCreateSemaphore(Device, &semaphoreInfo, nullptr, &semaphore);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+    _semaphores.insert(semaphore);
+
+    return semaphore;
+}
+
 void
 RIVulkanDevice3::DestroyVkSemaphore(VkSemaphore semaphore)
 {
@@ -40,6 +63,54 @@ RIVulkanDevice3::DestroyVkSemaphore(VkSemaphore semaphore)
     _semaphores.erase(_semaphores.find(semaphore));
 }
 
+uint64_t
+RIVulkanDevice3::GetSemaphoreCounterValue(VkSemaphore semaphore)
+{
+    uint64_t       value{};
+    const VkResult result = vkGetSemaphoreCounterValueKHR(Device, semaphore, &value);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+    return value;
+}
+
+bool
+RIVulkanDevice3::WaitSemaphoreValue(VkSemaphore semaphore, uint64_t value, uint64_t timeoutNanoseconds)
+{
+    VkSemaphoreWaitInfoKHR waitInfo{};
+    waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &semaphore;
+    waitInfo.pValues        = &value;
+
+    const VkResult result = vkWaitSemaphoresKHR(Device, &waitInfo, timeoutNanoseconds);
+    if (result == VK_TIMEOUT)
+        {
+            return false;
+        }
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+    return true;
+}
+
+void
+RIVulkanDevice3::SignalSemaphoreValue(VkSemaphore semaphore, uint64_t value)
+{
+    VkSemaphoreSignalInfoKHR signalInfo{};
+    signalInfo.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+    signalInfo.semaphore = semaphore;
+    signalInfo.value     = value;
+
+    const VkResult result = vkSignalSemaphoreKHR(Device, &signalInfo);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+}
+
 VkFence
 RIVulkanDevice3::CreateFence(bool signaled)
 {
@@ -17,7 +17,13 @@ class RIVulkanDevice3 : public RIVulkanDevice2
   public:
     virtual ~RIVulkanDevice3();
     VkSemaphore CreateVkSemaphore();
+    /*Destroyed with DestroyVkSemaphore*/
+    VkSemaphore CreateTimelineSemaphore(uint64_t initialValue);
     void        DestroyVkSemaphore(VkSemaphore semaphore);
+    uint64_t    GetSemaphoreCounterValue(VkSemaphore semaphore);
+    /*Returns false on timeout*/
+    bool        WaitSemaphoreValue(VkSemaphore semaphore, uint64_t value, uint64_t timeoutNanoseconds);
+    void        SignalSemaphoreValue(VkSemaphore semaphore, uint64_t value);
 
     VkFence CreateFence(bool signaled);
     void    DestroyFence(VkFence fence);
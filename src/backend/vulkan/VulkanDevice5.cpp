@@ -13,6 +13,7 @@ RIVulkanDevice5::~RIVulkanDevice5()
 {
     check(_images.size() == 0);
     check(_imageViews.size() == 0);
+    check(_aliasingAllocations.size() == 0);
 }
 
 RIVulkanImage
@@ -185,4 +186,138 @@ RIVulkanDevice5::UnmapImage(const RIVulkanImage& image)
     vmaUnmapMemory(VmaAllocator, image.Allocation);
 }
 
+bool
+RIVulkanDevice5::HasLazilyAllocatedMemory() const
+{
+    for (uint32_t i = 0; i < DeviceMemory.memoryTypeCount; i++)
+        {
+            if (DeviceMemory.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+                {
+                    return true;
+                }
+        }
+    return false;
+}
+
+RIVulkanImage
+RIVulkanDevice5::CreateImageLazilyAllocated(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage)
+{
+    check(HasLazilyAllocatedMemory());
+    check(usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width  = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth  = 1;
+    imageInfo.mipLevels     = 1;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.format        = format;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = usage;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+    RIVulkanImage  image{};
+    const VkResult result = vmaCreateImage(VmaAllocator, &imageInfo, &allocInfo, &image.Image, &image.Allocation, nullptr);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    image.Format     = format;
+    image.Width      = width;
+    image.Height     = height;
+    image.MipLevels  = 1;
+    image.UsageFlags = usage;
+
+    _images.insert(image);
+
+    return image;
+}
+
+RIVulkanImage
+RIVulkanDevice5::CreateImageWithoutMemory(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageUsageFlags usage)
+{
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width  = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth  = 1;
+    imageInfo.mipLevels     = mipLevels;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.format        = format;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = usage;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    RIVulkanImage  image{};
+    const VkResult result = vkCreateImage(Device, &imageInfo, nullptr, &image.Image);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    image.Format     = format;
+    image.Width      = width;
+    image.Height     = height;
+    image.MipLevels  = mipLevels;
+    image.UsageFlags = usage;
+
+    // The allocation is null, DestroyImage only destroys the image and leaves the memory to its owner
+    _images.insert(image);
+
+    return image;
+}
+
+VkMemoryRequirements
+RIVulkanDevice5::GetImageMemoryRequirements(const RIVulkanImage& image)
+{
+    VkMemoryRequirements requirements{};
+    vkGetImageMemoryRequirements(Device, image.Image, &requirements);
+    return requirements;
+}
+
+VmaAllocation
+RIVulkanDevice5::AllocateAliasingMemory(const VkMemoryRequirements& requirements)
+{
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.requiredFlags           = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    VmaAllocation  allocation{};
+    const VkResult result = vmaAllocateMemory(VmaAllocator, &requirements, &allocInfo, &allocation, nullptr);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+
+    _aliasingAllocations.insert(allocation);
+
+    return allocation;
+}
+
+void
+RIVulkanDevice5::FreeAliasingMemory(VmaAllocation allocation)
+{
+    vmaFreeMemory(VmaAllocator, allocation);
+    _aliasingAllocations.erase(_aliasingAllocations.find(allocation));
+}
+
+void
+RIVulkanDevice5::BindImageMemory(const RIVulkanImage& image, VmaAllocation allocation)
+{
+    check(image.Allocation == nullptr); // Only images created without memory
+    const VkResult result = vmaBindImageMemory(VmaAllocator, allocation, image.Image);
+    if (VKFAILED(result))
+        {
+            throw std::runtime_error(VkUtils::VkErrorString(result));
+        }
+}
+
 }
\ No newline at end of file
@@ -59,8 +59,19 @@ class RIVulkanDevice5 : public RIVulkanDevice4
     void*         MapImage(const RIVulkanImage& image);
     void          UnmapImage(const RIVulkanImage& image);
 
+    /*Transient attachments can use lazily allocated memory, committed only if the tiler needs to spill the attachment*/
+    bool          HasLazilyAllocatedMemory() const;
+    RIVulkanImage CreateImageLazilyAllocated(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage);
+    /*Image without memory, memory is bound later to alias it with other images*/
+    RIVulkanImage        CreateImageWithoutMemory(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageUsageFlags usage);
+    VkMemoryRequirements GetImageMemoryRequirements(const RIVulkanImage& image);
+    VmaAllocation        AllocateAliasingMemory(const VkMemoryRequirements& requirements);
+    void                 FreeAliasingMemory(VmaAllocation allocation);
+    void                 BindImageMemory(const RIVulkanImage& image, VmaAllocation allocation);
+
   private:
     std::unordered_set<RIVulkanImage, RIVulkanImageHasher, RIVulkanImageEqualFn> _images;
     std::unordered_set<VkImageView>                                              _imageViews;
+    std::unordered_set<VmaAllocation>                                            _aliasingAllocations;
 };
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+TEST_F(WindowFixture, ShouldTrackResourceStatesWithAutomaticBarriers)
+{
+    Fox::DContextConfig config;
+    config.warningFunction   = &WarningAssert;
+    config.automaticBarriers = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto color = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::UNDEFINED);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]         = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    // Transitioned from undefined to render target by the bind
+    context->BindRenderTargets(cmd, attachments, loadOp);
+
+    // Current state is ignored, the second barrier is redundant and dropped
+    Fox::RenderTargetBarrier barrier{};
+    barrier.RenderTarget  = color;
+    barrier.mCurrentState = Fox::EResourceState::UNDEFINED;
+    barrier.mNewState     = Fox::EResourceState::SHADER_RESOURCE;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // Back to render target and loaded, the tracked state gives the right previous layout
+    loadOp.LoadColor[0] = Fox::ERenderPassLoad::Load;
+    context->BindRenderTargets(cmd, attachments, loadOp);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
@@ -0,0 +1,78 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <set>
+#include <vector>
+
+TEST_F(WindowFixture, ShouldGiveStableBindlessIndices)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto image        = context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 4, 4, 1);
+    const auto otherImage   = context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 4, 4, 1);
+    const auto sampler      = context->CreateSampler(0, 1);
+    const auto uniform      = context->CreateBuffer(256, Fox::EResourceType::UNIFORM_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_TO_GPU);
+    const auto vertexBuffer = context->CreateBuffer(256, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY);
+
+    // Every resource type has its own array, indices are unique within it and don't change
+    const uint32_t imageIndex = context->GetBindlessIndex(image);
+    EXPECT_NE(imageIndex, context->GetBindlessIndex(otherImage));
+    EXPECT_EQ(imageIndex, context->GetBindlessIndex(image));
+    EXPECT_EQ(context->GetBindlessIndex(sampler), context->GetBindlessIndex(sampler));
+    EXPECT_EQ(context->GetBindlessIndex(uniform), context->GetBindlessIndex(uniform));
+    EXPECT_EQ(context->GetBindlessIndex(vertexBuffer), context->GetBindlessIndex(vertexBuffer));
+
+    // The heap takes the set of the NEVER frequency, the other sets are allocated as usual
+    Fox::ShaderLayout layout;
+    layout.BindlessHeap = true;
+    layout.SetsLayout[(uint32_t)Fox::EDescriptorFrequency::PER_FRAME].insert({ 0, Fox::ShaderDescriptorBindings("Camera", Fox::EBindingType::UNIFORM_BUFFER_OBJECT, 64, 1, Fox::EShaderStage::VERTEX) });
+    layout.PushConstants.push_back({ Fox::EShaderStage::VERTEX, 0, 4 }); // Index of the draw data
+    const auto rootSignature = context->CreateRootSignature(layout);
+    const auto set           = context->CreateDescriptorSets(rootSignature, Fox::EDescriptorFrequency::PER_FRAME, 2);
+
+    context->DestroyDescriptorSet(set);
+    context->DestroyRootSignature(rootSignature);
+    context->DestroyBuffer(vertexBuffer);
+    context->DestroyBuffer(uniform);
+    context->DestroyImage(otherImage);
+    context->DestroyImage(image);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldSizeTheBindlessHeapFromTheConfig)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+    // Larger than the initial image pool, the images created after it grows still have an index
+    config.bindlessHeapSize = 128;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    std::vector<uint32_t> images;
+    for (uint32_t i = 0; i < config.imageCapacity.Initial + 8; i++)
+        {
+            images.push_back(context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 4, 4, 1));
+        }
+
+    std::set<uint32_t> indices;
+    for (const auto image : images)
+        {
+            const uint32_t index = context->GetBindlessIndex(image);
+            EXPECT_LT(index, config.bindlessHeapSize);
+            EXPECT_TRUE(indices.insert(index).second);
+        }
+
+    for (const auto image : images)
+        {
+            context->DestroyImage(image);
+        }
+
+    delete context;
+}
@@ -0,0 +1,101 @@
+#include "WindowFixture.h"
+
+#include "TestShaders.h"
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+#include "backend/vulkan/VulkanDevice13.h"
+
+#include <array>
+#include <cstring>
+
+TEST_F(WindowFixture, ShouldDispatchOnTheComputeQueue)
+{
+    constexpr uint32_t ValueCount = 128;
+
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    Fox::ShaderSource source;
+    source.SourceCode.ComputeShader = SpirvBytes(MultiplyIndexComputeShader, std::size(MultiplyIndexComputeShader));
+    const auto shader               = context->CreateShader(source);
+
+    // Only compute stage bindings, the root signature binds to the compute bind point
+    Fox::ShaderLayout layout;
+    layout.SetsLayout[(uint32_t)Fox::EDescriptorFrequency::NEVER].insert(
+    { 0, Fox::ShaderDescriptorBindings("Values", Fox::EBindingType::STORAGE_BUFFER_OBJECT, ValueCount * sizeof(uint32_t), 1, Fox::EShaderStage::COMPUTE) });
+    layout.PushConstants.push_back({ Fox::EShaderStage::COMPUTE, 0, sizeof(uint32_t) });
+    const auto rootSignature = context->CreateRootSignature(layout);
+    const auto pipeline      = context->CreateComputePipeline(shader, rootSignature);
+
+    const auto values = context->CreateBuffer(ValueCount * sizeof(uint32_t), Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_TO_GPU);
+    const auto set    = context->CreateDescriptorSets(rootSignature, Fox::EDescriptorFrequency::NEVER, 1);
+    {
+        uint32_t            buffers[] = { values };
+        Fox::DescriptorData param{};
+        param.Index   = 0;
+        param.Buffers = buffers;
+        context->UpdateDescriptorSet(set, 0, 1, &param);
+    }
+
+    // Two groups of 64 invocations
+    const auto indirect = context->CreateBuffer(sizeof(Fox::DispatchIndirectCommand), Fox::EResourceType::INDIRECT_DRAW_COMMAND, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_TO_GPU);
+    {
+        const Fox::DispatchIndirectCommand command{ ValueCount / 64, 1, 1 };
+        std::memcpy(context->BeginMapBuffer(indirect), &command, sizeof(command));
+        context->EndMapBuffer(indirect);
+    }
+
+    const auto pool = context->CreateCommandPool(Fox::EQueueType::COMPUTE);
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindPipeline(cmd, pipeline);
+    context->BindDescriptorSet(cmd, 0, set);
+
+    // Every value is written by the indirect dispatch, then the first group is overwritten by the direct one
+    const uint32_t indirectMultiplier = 5;
+    context->PushConstants(cmd, Fox::EShaderStage::COMPUTE, 0, sizeof(uint32_t), &indirectMultiplier);
+    context->DispatchIndirect(cmd, indirect, 0);
+
+    Fox::BufferBarrier barrier{};
+    barrier.BufferId     = values;
+    barrier.CurrentState = Fox::EResourceState::UNORDERED_ACCESS;
+    barrier.NewState     = Fox::EResourceState::UNORDERED_ACCESS;
+    context->ResourceBarrier(cmd, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    const uint32_t multiplier = 3;
+    context->PushConstants(cmd, Fox::EShaderStage::COMPUTE, 0, sizeof(uint32_t), &multiplier);
+    context->Dispatch(cmd, 1, 1, 1);
+    context->EndCommandBuffer(cmd);
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    context->QueueSubmit({}, {}, {}, { { timeline, 1 } }, { cmd });
+
+    // Submitted to the compute queue, it's the main queue if the device has no dedicated one
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+    vkQueueWaitIdle(vkContext->GetDevice().ComputeQueue);
+    EXPECT_EQ(context->GetTimelineSemaphoreValue(timeline), 1);
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+
+    std::array<uint32_t, ValueCount> result{};
+    std::memcpy(result.data(), context->BeginMapBuffer(values), sizeof(result));
+    context->EndMapBuffer(values);
+    for (uint32_t i = 0; i < ValueCount; i++)
+        {
+            EXPECT_EQ(result[i], i * (i < 64 ? multiplier : indirectMultiplier));
+        }
+
+    context->DestroyTimelineSemaphore(timeline);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyBuffer(indirect);
+    context->DestroyDescriptorSet(set);
+    context->DestroyBuffer(values);
+    context->DestroyPipeline(pipeline);
+    context->DestroyRootSignature(rootSignature);
+    context->DestroyShader(shader);
+
+    delete context;
+}
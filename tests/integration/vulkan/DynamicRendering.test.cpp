@@ -0,0 +1,79 @@
+#include "WindowFixture.h"
+
+#include "ExtractImage.h"
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <vector>
+
+TEST_F(WindowFixture, ShouldBindRenderTargetsWithDynamicRendering)
+{
+    Fox::DContextConfig config;
+    config.warningFunction  = &WarningAssert;
+    config.dynamicRendering = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+    if (!vkContext->HasDynamicRendering())
+        {
+            delete context;
+            GTEST_SKIP() << "VK_KHR_dynamic_rendering isn't supported";
+        }
+
+    const auto color = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto depth = context->CreateRenderTarget(Fox::EFormat::DEPTH32_FLOAT, Fox::ESampleBit::COUNT_1_BIT, true, 64, 64, 1, 1, Fox::EResourceState::DEPTH_WRITE);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+    attachments.DepthStencil     = depth;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]                   = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0]           = Fox::ERenderPassStore::Store;
+    loadOp.ClearColor[0].color.float32[0] = 1.f;
+    loadOp.ClearColor[0].color.float32[1] = 0.f;
+    loadOp.ClearColor[0].color.float32[2] = 1.f;
+    loadOp.ClearColor[0].color.float32[3] = 1.f;
+    loadOp.LoadDepth                      = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreDepth                     = Fox::ERenderPassStore::Store;
+
+    const auto renderPass = context->CreateRenderPass(attachments, loadOp);
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindRenderTargets(cmd, attachments, loadOp);
+    context->BindRenderPass(cmd, renderPass);
+
+    // Ends the rendering, the clear is read back with a copy
+    Fox::RenderTargetBarrier barrier{};
+    barrier.RenderTarget  = color;
+    barrier.mCurrentState = Fox::EResourceState::RENDER_TARGET;
+    barrier.mNewState     = Fox::EResourceState::COPY_SOURCE;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    std::vector<unsigned char> pixels(64 * 64 * 4);
+    ExtractImage(vkContext, vkContext->GetRenderTarget(color).Image.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 64, 64, (uint32_t)pixels.size(), pixels.data());
+    for (size_t i = 0; i < pixels.size(); i += 4)
+        {
+            ASSERT_EQ(pixels[i], 0xff);
+            ASSERT_EQ(pixels[i + 1], 0);
+            ASSERT_EQ(pixels[i + 2], 0xff);
+            ASSERT_EQ(pixels[i + 3], 0xff);
+        }
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderPass(renderPass);
+    context->DestroyRenderTarget(depth);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
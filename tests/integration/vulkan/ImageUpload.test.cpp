@@ -52,7 +52,7 @@ TEST_F(WindowFixture, ShouldCorrectlyUploadImage)
         vkContext->WaitDeviceIdle(); // wait copy operations to finish
 
         std::array<unsigned char, 16> expected;
-        ExtractImage(vkContext, img, 2, 2, 1, VK_FORMAT_R8G8B8A8_UNORM, data.size(), (void*)expected.data());
+        ExtractImage(vkContext, static_cast<Fox::DImageVulkan*>(img)->Image.Image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 2, 2, data.size(), (void*)expected.data());
 
         EXPECT_EQ(data, expected);
     }
@@ -0,0 +1,104 @@
+#include "WindowFixture.h"
+
+#include "TestShaders.h"
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <array>
+#include <cstring>
+
+TEST_F(WindowFixture, ShouldRecordInstancedAndIndirectCountDraws)
+{
+    constexpr std::array<float, 6>    vertices{ -1, -1, 0, -1, -1, 0 };
+    constexpr std::array<float, 4>    offsets{ 0, 0, 1, 1 }; // One per instance
+    constexpr std::array<uint16_t, 3> indices{ 0, 1, 2 };
+
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto vertexLayout = context->CreateVertexLayout({ { "POSITION", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA },
+    { "OFFSET", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1 } });
+
+    Fox::ShaderSource source;
+    source.SourceCode.VertexShader = SpirvBytes(OffsetInstanceVertexShader, std::size(OffsetInstanceVertexShader));
+    source.SourceCode.PixelShader  = SpirvBytes(RedPixelShader, std::size(RedPixelShader));
+    source.VertexLayout            = vertexLayout;
+    source.VertexStride            = 2 * sizeof(float);
+    source.InstanceStride          = 2 * sizeof(float);
+    source.ColorAttachments        = 1;
+    const auto shader              = context->CreateShader(source);
+
+    const auto rootSignature = context->CreateRootSignature({});
+
+    Fox::DPipelineAttachments pipelineAttachments;
+    pipelineAttachments.RenderTargets[0] = Fox::EFormat::R8G8B8A8_UNORM;
+    const auto pipeline                  = context->CreatePipeline(shader, rootSignature, pipelineAttachments, {});
+
+    const auto createBuffer = [context](const void* data, uint32_t size, Fox::EResourceType type) {
+        const auto buffer = context->CreateBuffer(size, type, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_TO_GPU);
+        std::memcpy(context->BeginMapBuffer(buffer), data, size);
+        context->EndMapBuffer(buffer);
+        return buffer;
+    };
+    const auto vertexBuffer   = createBuffer(vertices.data(), sizeof(vertices), Fox::EResourceType::VERTEX_INDEX_BUFFER);
+    const auto instanceBuffer = createBuffer(offsets.data(), sizeof(offsets), Fox::EResourceType::VERTEX_INDEX_BUFFER);
+    const auto indexBuffer    = createBuffer(indices.data(), sizeof(indices), Fox::EResourceType::VERTEX_INDEX_BUFFER);
+
+    // The second command is past the count, it's never drawn
+    const std::array<Fox::DrawIndexedIndirectCommand, 2> commands{ { { 3, 2, 0, 0, 0 }, { 3, 2, 0, 0, 0 } } };
+    const uint32_t                                       drawCount = 1;
+
+    const auto indirectBuffer = createBuffer(commands.data(), sizeof(commands), Fox::EResourceType::INDIRECT_DRAW_COMMAND);
+    const auto countBuffer    = createBuffer(&drawCount, sizeof(drawCount), Fox::EResourceType::INDIRECT_DRAW_COMMAND);
+
+    const auto color = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]         = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindRenderTargets(cmd, attachments, loadOp);
+    context->SetViewport(cmd, 0, 0, 64, 64, 0.f, 1.f);
+    context->SetScissor(cmd, 0, 0, 64, 64);
+    context->BindPipeline(cmd, pipeline);
+    context->BindVertexBuffer(cmd, vertexBuffer);
+    context->BindInstanceBuffer(cmd, instanceBuffer);
+    context->BindIndexBuffer(cmd, indexBuffer, 0, Fox::EIndexType::UINT16);
+
+    // Both instances, then only the second one
+    context->DrawInstanced(cmd, 0, 3, 0, 2);
+    context->DrawIndexedInstanced(cmd, 3, 0, 0, 1, 1);
+    if (static_cast<Fox::VulkanContext*>(context)->HasDrawIndirectCount())
+        {
+            context->DrawIndexedIndirectCount(cmd, indirectBuffer, 0, countBuffer, 0, (uint32_t)commands.size(), sizeof(Fox::DrawIndexedIndirectCommand));
+        }
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderTarget(color);
+    context->DestroyBuffer(countBuffer);
+    context->DestroyBuffer(indirectBuffer);
+    context->DestroyBuffer(indexBuffer);
+    context->DestroyBuffer(instanceBuffer);
+    context->DestroyBuffer(vertexBuffer);
+    context->DestroyPipeline(pipeline);
+    context->DestroyRootSignature(rootSignature);
+    context->DestroyShader(shader);
+
+    delete context;
+}
@@ -0,0 +1,82 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <thread>
+
+TEST_F(WindowFixture, ShouldRecycleManagedCommandBuffersAfterFramesInFlight)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto            timeline = context->CreateTimelineSemaphore(0);
+    std::vector<uint32_t> firstFrame;
+    uint64_t              value{};
+    for (uint32_t frame = 0; frame < 4; frame++)
+        {
+            const auto cmd      = context->AcquireCommandBuffer();
+            const auto otherCmd = context->AcquireCommandBuffer();
+            EXPECT_NE(cmd, otherCmd);
+
+            if (frame == 0)
+                {
+                    firstFrame = { cmd, otherCmd };
+                }
+            else if (frame == 2)
+                {
+                    // Same frame in flight as the first one, its command buffers are handed out again in the same order
+                    EXPECT_EQ(cmd, firstFrame[0]);
+                    EXPECT_EQ(otherCmd, firstFrame[1]);
+                }
+            else
+                {
+                    EXPECT_NE(cmd, firstFrame[0]);
+                    EXPECT_NE(otherCmd, firstFrame[1]);
+                }
+
+            context->BeginCommandBuffer(cmd);
+            context->EndCommandBuffer(cmd);
+            context->BeginCommandBuffer(otherCmd);
+            context->EndCommandBuffer(otherCmd);
+            context->QueueSubmit({}, {}, {}, { { timeline, ++value } }, { cmd, otherCmd });
+            context->BeginFrame();
+        }
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, value, 0xFFFFFFFF));
+
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldAcquireManagedCommandBuffersPerThread)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto cmd = context->AcquireCommandBuffer();
+
+    uint32_t    threadCmd{};
+    std::thread thread([context, &threadCmd]() {
+        threadCmd = context->AcquireCommandBuffer();
+        context->BeginCommandBuffer(threadCmd);
+        context->EndCommandBuffer(threadCmd);
+    });
+    thread.join();
+    EXPECT_NE(cmd, threadCmd);
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    context->BeginCommandBuffer(cmd);
+    context->EndCommandBuffer(cmd);
+    context->QueueSubmit({}, {}, {}, { { timeline, 1 } }, { cmd, threadCmd });
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
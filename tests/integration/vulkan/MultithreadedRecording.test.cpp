@@ -0,0 +1,130 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <set>
+#include <thread>
+
+TEST_F(WindowFixture, ShouldRecordCommandBuffersFromSeveralThreads)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    constexpr size_t threadCount = 8;
+
+    const auto            timeline = context->CreateTimelineSemaphore(0);
+    std::vector<uint32_t> buffers;
+    for (size_t i = 0; i < threadCount; i++)
+        {
+            buffers.push_back(context->CreateBuffer(1024, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY));
+        }
+
+    // Every thread records with its own pool, each one transitions a different buffer
+    std::vector<uint32_t>    pools(threadCount);
+    std::vector<uint32_t>    cmds(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([context, &pools, &cmds, &buffers, i]() {
+                pools[i] = context->CreateCommandPool();
+                cmds[i]  = context->CreateCommandBuffer(pools[i]);
+                context->BeginCommandBuffer(cmds[i]);
+
+                Fox::BufferBarrier barrier{};
+                barrier.BufferId     = buffers[i];
+                barrier.CurrentState = Fox::EResourceState::UNDEFINED;
+                barrier.NewState     = Fox::EResourceState::VERTEX_AND_CONSTANT_BUFFER;
+                context->ResourceBarrier(cmds[i], 1, &barrier, 0, nullptr, 0, nullptr);
+                context->EndCommandBuffer(cmds[i]);
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    // Ids allocated concurrently are all different
+    EXPECT_EQ(std::set<uint32_t>(pools.begin(), pools.end()).size(), threadCount);
+    EXPECT_EQ(std::set<uint32_t>(cmds.begin(), cmds.end()).size(), threadCount);
+
+    // Merged in a single submission
+    context->QueueSubmit({}, {}, {}, { { timeline, 1 } }, cmds);
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+
+    for (size_t i = 0; i < threadCount; i++)
+        {
+            context->DestroyCommandBuffer(cmds[i]);
+            context->DestroyCommandPool(pools[i]);
+            context->DestroyBuffer(buffers[i]);
+        }
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldRenderIntoTheSameRenderTargetFromSeveralThreadsWithAutomaticBarriers)
+{
+    Fox::DContextConfig config;
+    config.warningFunction   = &WarningAssert;
+    config.automaticBarriers = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    constexpr size_t threadCount = 4;
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    const auto color    = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::UNDEFINED);
+
+    // Transitioned before recording, binding it from the threads only reads its tracked state
+    const auto            pool = context->CreateCommandPool();
+    std::vector<uint32_t> cmds{ context->CreateCommandBuffer(pool) };
+    context->BeginCommandBuffer(cmds[0]);
+    Fox::RenderTargetBarrier barrier{};
+    barrier.RenderTarget = color;
+    barrier.mNewState    = Fox::EResourceState::RENDER_TARGET;
+    context->ResourceBarrier(cmds[0], 0, nullptr, 0, nullptr, 1, &barrier);
+    context->EndCommandBuffer(cmds[0]);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]         = Fox::ERenderPassLoad::Load;
+    loadOp.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+
+    std::vector<uint32_t>    pools(threadCount);
+    std::vector<std::thread> threads;
+    cmds.resize(threadCount + 1);
+    for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([context, &pools, &cmds, &attachments, &loadOp, i]() {
+                pools[i]    = context->CreateCommandPool();
+                cmds[i + 1] = context->CreateCommandBuffer(pools[i]);
+                context->BeginCommandBuffer(cmds[i + 1]);
+                context->BindRenderTargets(cmds[i + 1], attachments, loadOp);
+                context->EndCommandBuffer(cmds[i + 1]);
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    context->QueueSubmit({}, {}, {}, { { timeline, 1 } }, cmds);
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+
+    for (size_t i = 0; i < threadCount; i++)
+        {
+            context->DestroyCommandBuffer(cmds[i + 1]);
+            context->DestroyCommandPool(pools[i]);
+        }
+    context->DestroyCommandBuffer(cmds[0]);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderTarget(color);
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
@@ -0,0 +1,97 @@
+#include "WindowFixture.h"
+
+#include "TestShaders.h"
+#include "backend/vulkan/UtilsVK.h"
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+#include "backend/vulkan/VulkanDevice13.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+TEST_F(WindowFixture, ShouldPushConstantsWithTheBoundPipelineLayout)
+{
+    constexpr uint32_t ValueCount = 128;
+
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+
+    // The range covers the whole device push constant size, the shader only reads the first 4 bytes of it
+    const uint32_t maxPushConstantsSize = vkContext->GetDevice().DeviceProperties.limits.maxPushConstantsSize;
+    ASSERT_GE(maxPushConstantsSize, 128);
+
+    Fox::ShaderLayout layout;
+    layout.SetsLayout[(uint32_t)Fox::EDescriptorFrequency::NEVER].insert(
+    { 0, Fox::ShaderDescriptorBindings("Values", Fox::EBindingType::STORAGE_BUFFER_OBJECT, ValueCount * sizeof(uint32_t), 1, Fox::EShaderStage::COMPUTE) });
+    layout.PushConstants.push_back({ Fox::EShaderStage::COMPUTE, 0, maxPushConstantsSize });
+    EXPECT_TRUE(VkUtils::fitsPushConstantSize(layout.PushConstants, maxPushConstantsSize));
+    {
+        // CreateRootSignature checks it in debug
+        std::vector<Fox::ShaderPushConstantRange> pastTheLimit = layout.PushConstants;
+        pastTheLimit.front().Offset += 4;
+        EXPECT_FALSE(VkUtils::fitsPushConstantSize(pastTheLimit, maxPushConstantsSize));
+    }
+
+    Fox::ShaderSource source;
+    source.SourceCode.ComputeShader = SpirvBytes(MultiplyIndexComputeShader, std::size(MultiplyIndexComputeShader));
+    const auto shader               = context->CreateShader(source);
+    const auto rootSignature        = context->CreateRootSignature(layout);
+    const auto pipeline             = context->CreateComputePipeline(shader, rootSignature);
+
+    const auto values = context->CreateBuffer(ValueCount * sizeof(uint32_t), Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_TO_GPU);
+    const auto set    = context->CreateDescriptorSets(rootSignature, Fox::EDescriptorFrequency::NEVER, 1);
+    {
+        uint32_t            buffers[] = { values };
+        Fox::DescriptorData param{};
+        param.Index   = 0;
+        param.Buffers = buffers;
+        context->UpdateDescriptorSet(set, 0, 1, &param);
+    }
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+
+    // PushConstants requires a pipeline bound to the bind point of the stage
+    EXPECT_EQ(vkContext->GetBoundPipelineLayout(cmd, Fox::EShaderStage::COMPUTE), VK_NULL_HANDLE);
+    context->BindPipeline(cmd, pipeline);
+    EXPECT_NE(vkContext->GetBoundPipelineLayout(cmd, Fox::EShaderStage::COMPUTE), VK_NULL_HANDLE);
+    EXPECT_EQ(vkContext->GetBoundPipelineLayout(cmd, Fox::EShaderStage::VERTEX), VK_NULL_HANDLE);
+    context->BindDescriptorSet(cmd, 0, set);
+
+    // The whole range in one push, then the multiplier alone at the start of it
+    std::vector<uint32_t> block(maxPushConstantsSize / sizeof(uint32_t), 2);
+    context->PushConstants(cmd, Fox::EShaderStage::COMPUTE, 0, maxPushConstantsSize, block.data());
+    const uint32_t multiplier = 7;
+    context->PushConstants(cmd, Fox::EShaderStage::COMPUTE, 0, sizeof(uint32_t), &multiplier);
+    context->Dispatch(cmd, ValueCount / 64, 1, 1);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    std::array<uint32_t, ValueCount> result{};
+    std::memcpy(result.data(), context->BeginMapBuffer(values), sizeof(result));
+    context->EndMapBuffer(values);
+    for (uint32_t i = 0; i < ValueCount; i++)
+        {
+            EXPECT_EQ(result[i], i * multiplier);
+        }
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyDescriptorSet(set);
+    context->DestroyBuffer(values);
+    context->DestroyPipeline(pipeline);
+    context->DestroyRootSignature(rootSignature);
+    context->DestroyShader(shader);
+
+    delete context;
+}
@@ -0,0 +1,81 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <array>
+
+TEST_F(WindowFixture, ShouldSkipBindingTheStateAlreadyBound)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto color  = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto buffer = context->CreateBuffer(1024, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY);
+    const auto other  = context->CreateBuffer(1024, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]         = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindRenderTargets(cmd, attachments, loadOp);
+
+    context->SetViewport(cmd, 0, 0, 64, 64, 0.f, 1.f);
+    context->SetViewport(cmd, 0, 0, 64, 64, 0.f, 1.f);
+    context->SetScissor(cmd, 0, 0, 64, 64);
+    context->SetScissor(cmd, 0, 0, 32, 32);
+    context->SetScissor(cmd, 0, 0, 32, 32);
+    context->BindVertexBuffer(cmd, buffer);
+    context->BindVertexBuffer(cmd, buffer);
+    context->BindVertexBuffer(cmd, other);
+    // The instance binding is tracked apart from the vertex one
+    context->BindInstanceBuffer(cmd, other);
+    context->BindInstanceBuffer(cmd, other);
+    // A different offset into the same buffer is a new binding
+    context->BindVertexBuffer(cmd, other, 256);
+    // Both streams are already bound with these offsets
+    const std::array<uint32_t, 2> streams{ other, other };
+    const std::array<uint64_t, 2> offsets{ 256, 0 };
+    context->BindVertexBuffers(cmd, 0, streams, offsets);
+    context->BindIndexBuffer(cmd, buffer);
+    context->BindIndexBuffer(cmd, buffer);
+    // So is the same index buffer with another index type
+    context->BindIndexBuffer(cmd, buffer, 0, Fox::EIndexType::UINT16);
+    context->BindIndexBuffer(cmd, buffer, 0, Fox::EIndexType::UINT16);
+
+    const Fox::DRedundantStateCounters counters = context->GetRedundantStateCounters(cmd);
+    EXPECT_EQ(counters.Viewports, 1);
+    EXPECT_EQ(counters.Scissors, 1);
+    EXPECT_EQ(counters.VertexBuffers, 3);
+    EXPECT_EQ(counters.IndexBuffers, 2);
+    EXPECT_EQ(counters.Pipelines, 0);
+    EXPECT_EQ(counters.DescriptorSets, 0);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    // A new recording starts with nothing bound
+    context->ResetCommandPool(pool);
+    context->BeginCommandBuffer(cmd);
+    EXPECT_EQ(context->GetRedundantStateCounters(cmd).Viewports, 0);
+    context->EndCommandBuffer(cmd);
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyBuffer(other);
+    context->DestroyBuffer(buffer);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
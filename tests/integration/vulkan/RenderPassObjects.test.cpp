@@ -0,0 +1,96 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+
+TEST_F(WindowFixture, ShouldPrebuildTheRenderPassBeginInfo)
+{
+    Fox::DContextConfig config;
+    config.warningFunction  = &WarningAssert;
+    config.dynamicRendering = false;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+
+    const auto color = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 32, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto depth = context->CreateRenderTarget(Fox::EFormat::DEPTH32_FLOAT, Fox::ESampleBit::COUNT_1_BIT, true, 64, 32, 1, 1, Fox::EResourceState::DEPTH_WRITE);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+    attachments.DepthStencil     = depth;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]                   = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0]           = Fox::ERenderPassStore::Store;
+    loadOp.ClearColor[0].color.float32[0] = 0.25f;
+    loadOp.ClearColor[0].color.float32[1] = 0.5f;
+    loadOp.ClearColor[0].color.float32[2] = 0.75f;
+    loadOp.ClearColor[0].color.float32[3] = 1.f;
+    loadOp.LoadDepth                      = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreDepth                     = Fox::ERenderPassStore::Store;
+    loadOp.ClearDepthStencil.depth        = 0.5f;
+    loadOp.ClearDepthStencil.stencil      = 0;
+
+    const auto renderPass = context->CreateRenderPass(attachments, loadOp);
+    {
+        // Clear values are indexed by attachment index, the depth stencil comes after the color attachments
+        const Fox::DRenderPassVulkan& renderPassRef = vkContext->GetRenderPass(renderPass);
+        ASSERT_NE(renderPassRef.RenderPass, nullptr);
+        EXPECT_NE(renderPassRef.FramebufferId, 0);
+
+        const VkRenderPassBeginInfo& beginInfo = renderPassRef.BeginInfo;
+        EXPECT_EQ(beginInfo.renderPass, renderPassRef.RenderPass);
+        EXPECT_NE(beginInfo.framebuffer, nullptr);
+        EXPECT_EQ(beginInfo.renderArea.extent.width, 64);
+        EXPECT_EQ(beginInfo.renderArea.extent.height, 32);
+        ASSERT_EQ(beginInfo.clearValueCount, 2);
+        ASSERT_EQ(beginInfo.pClearValues, renderPassRef.ClearValues);
+        EXPECT_EQ(beginInfo.pClearValues[0].color.float32[0], 0.25f);
+        EXPECT_EQ(beginInfo.pClearValues[0].color.float32[1], 0.5f);
+        EXPECT_EQ(beginInfo.pClearValues[0].color.float32[2], 0.75f);
+        EXPECT_EQ(beginInfo.pClearValues[0].color.float32[3], 1.f);
+        EXPECT_EQ(beginInfo.pClearValues[1].depthStencil.depth, 0.5f);
+        EXPECT_EQ(beginInfo.pClearValues[1].depthStencil.stencil, 0);
+    }
+
+    // Same attachments share the cached framebuffer, the color is loaded but the depth clear value keeps its attachment index
+    Fox::DLoadOpPass loadOnly{};
+    loadOnly.LoadColor[0]         = Fox::ERenderPassLoad::Load;
+    loadOnly.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+    loadOnly.LoadDepth            = Fox::ERenderPassLoad::Clear;
+    loadOnly.StoreDepth           = Fox::ERenderPassStore::DontCare;
+
+    const auto secondRenderPass = context->CreateRenderPass(attachments, loadOnly);
+    EXPECT_EQ(vkContext->GetRenderPass(secondRenderPass).FramebufferId, vkContext->GetRenderPass(renderPass).FramebufferId);
+    EXPECT_EQ(vkContext->GetRenderPass(secondRenderPass).BeginInfo.clearValueCount, 2);
+    EXPECT_EQ(vkContext->GetRenderPass(secondRenderPass).BeginInfo.pClearValues[1].depthStencil.depth, 0.f);
+
+    EXPECT_TRUE(vkContext->IsRenderPassAlive(renderPass));
+    EXPECT_TRUE(vkContext->IsRenderPassAlive(secondRenderPass));
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindRenderPass(cmd, renderPass);
+    context->BindRenderPass(cmd, secondRenderPass);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    // The framebuffer goes with any of its render targets, both render passes can't be bound anymore
+    context->DestroyRenderTarget(depth);
+    EXPECT_FALSE(vkContext->IsRenderPassAlive(renderPass));
+    EXPECT_FALSE(vkContext->IsRenderPassAlive(secondRenderPass));
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderPass(secondRenderPass);
+    context->DestroyRenderPass(renderPass);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
@@ -0,0 +1,81 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+TEST_F(WindowFixture, ShouldRecordBufferAndSplitBarriers)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto color  = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto other  = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto buffer = context->CreateBuffer(1024, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY);
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]         = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0] = Fox::ERenderPassStore::Store;
+
+    Fox::DFramebufferAttachments colorAttachments;
+    colorAttachments.RenderTargets[0] = color;
+    Fox::DFramebufferAttachments otherAttachments;
+    otherAttachments.RenderTargets[0] = other;
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+
+    Fox::BufferBarrier bufferBarrier{};
+    bufferBarrier.BufferId     = buffer;
+    bufferBarrier.CurrentState = Fox::EResourceState::UNDEFINED;
+    bufferBarrier.NewState     = Fox::EResourceState::VERTEX_AND_CONSTANT_BUFFER;
+    context->ResourceBarrier(cmd, 1, &bufferBarrier, 0, nullptr, 0, nullptr);
+
+    context->BindRenderTargets(cmd, colorAttachments, loadOp);
+
+    // The transition of the first render target overlaps with the second pass
+    Fox::RenderTargetBarrier barrier{};
+    barrier.RenderTarget  = color;
+    barrier.mCurrentState = Fox::EResourceState::RENDER_TARGET;
+    barrier.mNewState     = Fox::EResourceState::PIXEL_SHADER_RESOURCE;
+    barrier.mBeginOnly    = 1;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    context->BindRenderTargets(cmd, otherAttachments, loadOp);
+
+    barrier.mBeginOnly = 0;
+    barrier.mEndOnly   = 1;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    // Events are reset when the command buffer is recorded again
+    context->BeginCommandBuffer(cmd);
+    barrier.mCurrentState = Fox::EResourceState::PIXEL_SHADER_RESOURCE;
+    barrier.mNewState     = Fox::EResourceState::RENDER_TARGET;
+    barrier.mBeginOnly    = 1;
+    barrier.mEndOnly      = 0;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+    barrier.mBeginOnly = 0;
+    barrier.mEndOnly   = 1;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barrier);
+    context->EndCommandBuffer(cmd);
+
+    context->ResetFence(fence);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyBuffer(buffer);
+    context->DestroyRenderTarget(other);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
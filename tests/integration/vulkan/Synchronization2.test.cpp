@@ -0,0 +1,149 @@
+#include "WindowFixture.h"
+
+#include "ExtractImage.h"
+#include "backend/vulkan/VulkanContext.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+TEST_F(WindowFixture, ShouldRecordBarriersWithSynchronization2)
+{
+    Fox::DContextConfig config;
+    config.warningFunction  = &WarningAssert;
+    config.synchronization2 = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+    if (!vkContext->HasSynchronization2())
+        {
+            delete context;
+            GTEST_SKIP() << "VK_KHR_synchronization2 isn't supported";
+        }
+
+    const auto color  = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+    const auto normal = context->CreateRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, Fox::ESampleBit::COUNT_1_BIT, false, 64, 64, 1, 1, Fox::EResourceState::RENDER_TARGET);
+
+    Fox::DFramebufferAttachments attachments;
+    attachments.RenderTargets[0] = color;
+    attachments.RenderTargets[1] = normal;
+
+    Fox::DLoadOpPass loadOp{};
+    loadOp.LoadColor[0]                   = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[0]           = Fox::ERenderPassStore::Store;
+    loadOp.LoadColor[1]                   = Fox::ERenderPassLoad::Clear;
+    loadOp.StoreActionsColor[1]           = Fox::ERenderPassStore::Store;
+    loadOp.ClearColor[1].color.float32[0] = 0.f;
+    loadOp.ClearColor[1].color.float32[1] = 1.f;
+    loadOp.ClearColor[1].color.float32[2] = 0.f;
+    loadOp.ClearColor[1].color.float32[3] = 1.f;
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->BindRenderTargets(cmd, attachments, loadOp);
+
+    // Each barrier waits only on the stages of its own previous state
+    std::array<Fox::RenderTargetBarrier, 2> barriers{};
+    barriers[0].RenderTarget  = color;
+    barriers[0].mCurrentState = Fox::EResourceState::RENDER_TARGET;
+    barriers[0].mNewState     = Fox::EResourceState::PIXEL_SHADER_RESOURCE;
+    barriers[1].RenderTarget  = normal;
+    barriers[1].mCurrentState = Fox::EResourceState::RENDER_TARGET;
+    barriers[1].mNewState     = Fox::EResourceState::COPY_SOURCE;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, (uint32_t)barriers.size(), barriers.data());
+
+    // Queued transitions of the same render targets are merged before being recorded
+    std::swap(barriers[0].mCurrentState, barriers[0].mNewState);
+    std::swap(barriers[1].mCurrentState, barriers[1].mNewState);
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, (uint32_t)barriers.size(), barriers.data());
+
+    loadOp.LoadColor[0] = Fox::ERenderPassLoad::Load;
+    loadOp.LoadColor[1] = Fox::ERenderPassLoad::Load;
+    context->BindRenderTargets(cmd, attachments, loadOp);
+
+    // The clear survives the merged transitions only if they kept the content and layout of the render target
+    barriers[1].mCurrentState = Fox::EResourceState::RENDER_TARGET;
+    barriers[1].mNewState     = Fox::EResourceState::COPY_SOURCE;
+    context->ResourceBarrier(cmd, 0, nullptr, 0, nullptr, 1, &barriers[1]);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    std::vector<unsigned char> pixels(64 * 64 * 4);
+    ExtractImage(vkContext, vkContext->GetRenderTarget(normal).Image.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 64, 64, (uint32_t)pixels.size(), pixels.data());
+    for (size_t i = 0; i < pixels.size(); i += 4)
+        {
+            ASSERT_EQ(pixels[i], 0);
+            ASSERT_EQ(pixels[i + 1], 0xff);
+            ASSERT_EQ(pixels[i + 2], 0);
+            ASSERT_EQ(pixels[i + 3], 0xff);
+        }
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyRenderTarget(normal);
+    context->DestroyRenderTarget(color);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldMakeCopiesVisibleWithSynchronization2)
+{
+    constexpr std::array<unsigned char, 4 * 4> data{ 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff, 0, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+    Fox::DContextConfig config;
+    config.warningFunction  = &WarningAssert;
+    config.synchronization2 = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+    Fox::VulkanContext* vkContext = static_cast<Fox::VulkanContext*>(context);
+    if (!vkContext->HasSynchronization2())
+        {
+            delete context;
+            GTEST_SKIP() << "VK_KHR_synchronization2 isn't supported";
+        }
+
+    const auto image   = context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 2, 2, 1);
+    const auto staging = context->CreateBuffer((uint32_t)data.size(), Fox::EResourceType::TRANSFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_ONLY);
+    std::memcpy(context->BeginMapBuffer(staging), data.data(), data.size());
+    context->EndMapBuffer(staging);
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    Fox::TextureBarrier barrier{};
+    barrier.ImageId      = image;
+    barrier.CurrentState = Fox::EResourceState::UNDEFINED;
+    barrier.NewState     = Fox::EResourceState::COPY_DEST;
+    context->ResourceBarrier(cmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->CopyImage(cmd, image, 2, 2, 0, staging, 0);
+
+    // The copy is read back only if this barrier made it visible and moved the image to the transfer source layout
+    barrier.CurrentState = Fox::EResourceState::COPY_DEST;
+    barrier.NewState     = Fox::EResourceState::COPY_SOURCE;
+    context->ResourceBarrier(cmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->EndCommandBuffer(cmd);
+
+    const auto fence = context->CreateFence(false);
+    context->QueueSubmit({}, {}, { cmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    std::array<unsigned char, 4 * 4> result{};
+    ExtractImage(vkContext, vkContext->GetImage(image).Image.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 2, 2, (uint32_t)result.size(), result.data());
+    EXPECT_EQ(result, data);
+
+    context->DestroyFence(fence);
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyBuffer(staging);
+    context->DestroyImage(image);
+
+    delete context;
+}
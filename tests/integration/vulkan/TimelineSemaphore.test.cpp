@@ -0,0 +1,76 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+TEST_F(WindowFixture, ShouldSignalAndWaitTimelineSemaphoreValues)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    EXPECT_EQ(context->GetTimelineSemaphoreValue(timeline), 0);
+
+    const auto pool    = context->CreateCommandPool();
+    const auto cmd     = context->CreateCommandBuffer(pool);
+    const auto waitCmd = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+    context->EndCommandBuffer(cmd);
+    context->BeginCommandBuffer(waitCmd);
+    context->EndCommandBuffer(waitCmd);
+
+    context->QueueSubmit({}, {}, {}, { { timeline, 1 } }, { cmd });
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+    EXPECT_EQ(context->GetTimelineSemaphoreValue(timeline), 1);
+
+    // The submission waits for the value signaled by the cpu
+    context->QueueSubmit({}, { { timeline, 2 } }, {}, { { timeline, 3 } }, { waitCmd });
+    EXPECT_FALSE(context->WaitTimelineSemaphore(timeline, 3, 0));
+    context->SignalTimelineSemaphore(timeline, 2);
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 3, 0xFFFFFFFF));
+    EXPECT_EQ(context->GetTimelineSemaphoreValue(timeline), 3);
+
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandBuffer(waitCmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldSubmitAndRecordBarriersFromSpans)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    const auto buffer   = context->CreateBuffer(1024, Fox::EResourceType::VERTEX_INDEX_BUFFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_GPU_ONLY);
+
+    const auto pool = context->CreateCommandPool();
+    const auto cmd  = context->CreateCommandBuffer(pool);
+    context->BeginCommandBuffer(cmd);
+
+    std::array<Fox::BufferBarrier, 1> bufferBarriers{};
+    bufferBarriers[0].BufferId     = buffer;
+    bufferBarriers[0].CurrentState = Fox::EResourceState::UNDEFINED;
+    bufferBarriers[0].NewState     = Fox::EResourceState::VERTEX_AND_CONSTANT_BUFFER;
+    context->ResourceBarrier(cmd, bufferBarriers, {}, {});
+    context->EndCommandBuffer(cmd);
+
+    const std::array<uint32_t, 1>            cmds{ cmd };
+    const std::array<Fox::DTimelineValue, 1> signal{ { { timeline, 1 } } };
+    context->QueueSubmit({}, {}, {}, signal, cmds, NULL);
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, 1, 0xFFFFFFFF));
+
+    context->DestroyCommandBuffer(cmd);
+    context->DestroyCommandPool(pool);
+    context->DestroyBuffer(buffer);
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
@@ -0,0 +1,127 @@
+#include "WindowFixture.h"
+
+#include "backend/vulkan/VulkanContextFactory.h"
+
+#include <array>
+#include <cstring>
+
+TEST_F(WindowFixture, ShouldUploadImageOnTheTransferQueue)
+{
+    constexpr std::array<unsigned char, 4 * 4> data{ 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff, 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff };
+
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto image   = context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 2, 2, 1);
+    const auto staging = context->CreateBuffer((uint32_t)data.size(), Fox::EResourceType::TRANSFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_ONLY);
+    std::memcpy(context->BeginMapBuffer(staging), data.data(), data.size());
+    context->EndMapBuffer(staging);
+
+    const auto transferPool = context->CreateCommandPool(Fox::EQueueType::TRANSFER);
+    const auto transferCmd  = context->CreateCommandBuffer(transferPool);
+    const auto graphicsPool = context->CreateCommandPool();
+    const auto graphicsCmd  = context->CreateCommandBuffer(graphicsPool);
+
+    context->BeginCommandBuffer(transferCmd);
+    Fox::TextureBarrier barrier{};
+    barrier.ImageId      = image;
+    barrier.CurrentState = Fox::EResourceState::UNDEFINED;
+    barrier.NewState     = Fox::EResourceState::COPY_DEST;
+    context->ResourceBarrier(transferCmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->CopyImage(transferCmd, image, 2, 2, 0, staging, 0);
+
+    // Released by the transfer queue and acquired by the graphics queue with the same states
+    barrier.CurrentState = Fox::EResourceState::COPY_DEST;
+    barrier.NewState     = Fox::EResourceState::SHADER_RESOURCE;
+    barrier.Release      = 1;
+    barrier.QueueType    = (uint8_t)Fox::EQueueType::GRAPHICS;
+    context->ResourceBarrier(transferCmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->EndCommandBuffer(transferCmd);
+
+    context->BeginCommandBuffer(graphicsCmd);
+    barrier.Release   = 0;
+    barrier.Acquire   = 1;
+    barrier.QueueType = (uint8_t)Fox::EQueueType::TRANSFER;
+    context->ResourceBarrier(graphicsCmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->EndCommandBuffer(graphicsCmd);
+
+    const auto uploaded = context->CreateGpuSemaphore();
+    const auto fence    = context->CreateFence(false);
+    context->QueueSubmit({}, { uploaded }, { transferCmd }, NULL);
+    context->QueueSubmit({ uploaded }, {}, { graphicsCmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    context->DestroyFence(fence);
+    context->DestroyGpuSemaphore(uploaded);
+    context->DestroyCommandBuffer(graphicsCmd);
+    context->DestroyCommandPool(graphicsPool);
+    context->DestroyCommandBuffer(transferCmd);
+    context->DestroyCommandPool(transferPool);
+    context->DestroyBuffer(staging);
+    context->DestroyImage(image);
+
+    delete context;
+}
+
+TEST_F(WindowFixture, ShouldTransferOwnershipWithAutomaticBarriers)
+{
+    constexpr std::array<unsigned char, 4 * 4> data{ 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff, 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff };
+
+    Fox::DContextConfig config;
+    config.warningFunction   = &WarningAssert;
+    config.automaticBarriers = true;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto image   = context->CreateImage(Fox::EFormat::R8G8B8A8_UNORM, 2, 2, 1);
+    const auto staging = context->CreateBuffer((uint32_t)data.size(), Fox::EResourceType::TRANSFER, Fox::EMemoryUsage::RESOURCE_MEMORY_USAGE_CPU_ONLY);
+    std::memcpy(context->BeginMapBuffer(staging), data.data(), data.size());
+    context->EndMapBuffer(staging);
+
+    const auto transferPool = context->CreateCommandPool(Fox::EQueueType::TRANSFER);
+    const auto transferCmd  = context->CreateCommandBuffer(transferPool);
+    const auto graphicsPool = context->CreateCommandPool();
+    const auto graphicsCmd  = context->CreateCommandBuffer(graphicsPool);
+
+    // The copy transitions the image, the ownership transfer isn't dropped by the tracking
+    context->BeginCommandBuffer(transferCmd);
+    context->CopyImage(transferCmd, image, 2, 2, 0, staging, 0);
+
+    Fox::TextureBarrier barrier{};
+    barrier.ImageId      = image;
+    barrier.CurrentState = Fox::EResourceState::COPY_DEST;
+    barrier.NewState     = Fox::EResourceState::SHADER_RESOURCE;
+    barrier.Release      = 1;
+    barrier.QueueType    = (uint8_t)Fox::EQueueType::GRAPHICS;
+    context->ResourceBarrier(transferCmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->EndCommandBuffer(transferCmd);
+
+    // Recorded even if the tracked state is already the new one
+    context->BeginCommandBuffer(graphicsCmd);
+    barrier.Release   = 0;
+    barrier.Acquire   = 1;
+    barrier.QueueType = (uint8_t)Fox::EQueueType::TRANSFER;
+    context->ResourceBarrier(graphicsCmd, 0, nullptr, 1, &barrier, 0, nullptr);
+    context->EndCommandBuffer(graphicsCmd);
+
+    const auto uploaded = context->CreateGpuSemaphore();
+    const auto fence    = context->CreateFence(false);
+    context->QueueSubmit({}, { uploaded }, { transferCmd }, NULL);
+    context->QueueSubmit({ uploaded }, {}, { graphicsCmd }, fence);
+    context->WaitForFence(fence, 0xFFFFFFFF);
+
+    context->DestroyFence(fence);
+    context->DestroyGpuSemaphore(uploaded);
+    context->DestroyCommandBuffer(graphicsCmd);
+    context->DestroyCommandPool(graphicsPool);
+    context->DestroyCommandBuffer(transferCmd);
+    context->DestroyCommandPool(transferPool);
+    context->DestroyBuffer(staging);
+    context->DestroyImage(image);
+
+    delete context;
+}
@@ -0,0 +1,43 @@
+#include "WindowFixture.h"
+
+#include "RenderGraph.h"
+#include "backend/vulkan/VulkanContextFactory.h"
+
+TEST_F(WindowFixture, ShouldReleaseTransientRenderTargetsAfterTheirSubmissions)
+{
+    Fox::DContextConfig config;
+    config.warningFunction = &WarningAssert;
+
+    Fox::IContext* context = Fox::CreateVulkanContext(&config);
+    ASSERT_NE(context, nullptr);
+
+    const auto timeline = context->CreateTimelineSemaphore(0);
+    uint64_t   value{};
+    {
+        Fox::RenderGraph graph(context);
+        for (const uint32_t size : { 64u, 128u })
+            {
+                graph.Reset();
+                const auto target = graph.CreateTransientRenderTarget(Fox::EFormat::R8G8B8A8_UNORM, false, size, size);
+                const auto pass   = graph.AddPass("Clear", {});
+                graph.AddColorAttachment(pass, target, Fox::ERenderPassLoad::Clear, Fox::ERenderPassStore::Store);
+                graph.SetSideEffect(pass);
+                // The second frame is resized, the transient render targets of the first one are destroyed while it may be executing
+                graph.Compile();
+
+                const auto cmd = context->AcquireCommandBuffer();
+                context->BeginCommandBuffer(cmd);
+                graph.Execute(cmd);
+                context->EndCommandBuffer(cmd);
+                context->QueueSubmit({}, {}, {}, { { timeline, ++value } }, { cmd });
+                context->BeginFrame();
+            }
+        graph.ReleaseTransientRenderTargets();
+    }
+
+    EXPECT_TRUE(context->WaitTimelineSemaphore(timeline, value, 0xFFFFFFFF));
+    context->FlushDeletedBuffers();
+    context->DestroyTimelineSemaphore(timeline);
+
+    delete context;
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+// Must be included after gtest, X11 defines None
+#include "IContext.h"
+
+#include <unordered_map>
+
+using namespace Fox;
+
+TEST(UnitFramebufferAttachments, EqualFnShouldCompareDepthStencil)
+{
+    DFramebufferAttachments lhs;
+    lhs.RenderTargets[0] = 1;
+    lhs.DepthStencil     = 2;
+
+    DFramebufferAttachments rhs = lhs;
+    EXPECT_TRUE(DFramebufferAttachmentEqualFn{}(lhs, rhs));
+
+    rhs.DepthStencil = 3;
+    EXPECT_FALSE(DFramebufferAttachmentEqualFn{}(lhs, rhs));
+}
+
+TEST(UnitFramebufferAttachments2, HashFnShouldDependOnOrderAndDepthStencil)
+{
+    DFramebufferAttachments lhs;
+    lhs.RenderTargets[0] = 1;
+    lhs.RenderTargets[1] = 2;
+
+    DFramebufferAttachments swapped;
+    swapped.RenderTargets[0] = 2;
+    swapped.RenderTargets[1] = 1;
+
+    DFramebufferAttachments withDepth = lhs;
+    withDepth.DepthStencil            = 3;
+
+    EXPECT_NE(DFramebufferAttachmentsHashFn{}(lhs), DFramebufferAttachmentsHashFn{}(swapped));
+    EXPECT_NE(DFramebufferAttachmentsHashFn{}(lhs), DFramebufferAttachmentsHashFn{}(withDepth));
+}
+
+TEST(UnitFramebufferAttachments3, ShouldBeUsableAsMapKey)
+{
+    std::unordered_map<DFramebufferAttachments, uint32_t, DFramebufferAttachmentsHashFn, DFramebufferAttachmentEqualFn> cache;
+
+    DFramebufferAttachments color;
+    color.RenderTargets[0] = 1;
+
+    DFramebufferAttachments colorDepth = color;
+    colorDepth.DepthStencil            = 2;
+
+    cache.emplace(color, 10);
+    cache.emplace(colorDepth, 20);
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.at(color), 10);
+    EXPECT_EQ(cache.at(colorDepth), 20);
+
+    cache.erase(color);
+    EXPECT_EQ(cache.find(color), cache.end());
+    EXPECT_EQ(cache.at(colorDepth), 20);
+}
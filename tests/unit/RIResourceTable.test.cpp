@@ -0,0 +1,169 @@
+#include "RIResourceTable.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace Fox;
+
+struct DummyResource
+{
+    uint8_t Id{};
+};
+
+TEST(UnitRIResourceTable, ShouldAllocateContiguousIndices)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(4, 4);
+
+    EXPECT_EQ(table.Allocate(), 0);
+    EXPECT_EQ(table.Allocate(), 1);
+    EXPECT_EQ(table.Allocate(), 2);
+    EXPECT_EQ(table.Allocate(), 3);
+    EXPECT_EQ(table.FreeCount(), 0);
+}
+
+TEST(UnitRIResourceTable2, ShouldReuseReleasedSlotsInLifoOrder)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(4, 4);
+
+    table.Allocate();
+    table.Allocate();
+    table.Allocate();
+
+    table.Release(0);
+    table.Release(2);
+
+    EXPECT_EQ(table.Allocate(), 2);
+    EXPECT_EQ(table.Allocate(), 0);
+    EXPECT_EQ(table.Allocate(), 3);
+}
+
+TEST(UnitRIResourceTable3, ShouldThrowWhenFull)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(2, 2);
+
+    table.Allocate();
+    table.Allocate();
+
+    EXPECT_THROW(table.Allocate(), std::runtime_error);
+
+    table.Release(1);
+    EXPECT_EQ(table.Allocate(), 1);
+}
+
+TEST(UnitRIResourceTable4, ShouldGrowInChunksUpToMaxCapacity)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(0, 10);
+    EXPECT_EQ(table.size(), 0);
+
+    for (size_t i = 0; i < 10; i++)
+        {
+            EXPECT_EQ(table.Allocate(), i);
+        }
+    EXPECT_EQ(table.size(), 10);
+    EXPECT_THROW(table.Allocate(), std::runtime_error);
+}
+
+TEST(UnitRIResourceTable5, ElementsShouldNotMoveWhenGrowing)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(4, 1024);
+
+    const auto     index   = table.Allocate();
+    DummyResource* element = &table.at(index);
+    element->Id            = 42;
+
+    for (size_t i = 0; i < 512; i++)
+        {
+            table.Allocate();
+        }
+
+    EXPECT_EQ(&table.at(index), element);
+    EXPECT_EQ(table.at(index).Id, 42);
+}
+
+TEST(UnitRIResourceTable6, ShouldIterateOverAllSlots)
+{
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(0, 16);
+
+    table.at(table.Allocate()).Id = 1;
+    table.Allocate();
+    table.at(table.Allocate()).Id = 1;
+    table.Allocate();
+    table.at(table.Allocate()).Id = 1;
+
+    const auto count = std::count_if(table.begin(), table.end(), [](const DummyResource& r) { return r.Id == 1; });
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(std::distance(table.begin(), table.end()), 8);
+}
+
+TEST(UnitRIResourceTable7, ShouldAllocateUniqueIndicesFromManyThreads)
+{
+    constexpr size_t threadCount = 8;
+    constexpr size_t perThread   = 256;
+
+    RIResourceTable<DummyResource, 4> table;
+    table.Initialize(0, threadCount * perThread);
+
+    std::vector<std::vector<size_t>> indices(threadCount);
+    std::vector<std::thread>         threads;
+    for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&table, &indices, t]() {
+                for (size_t i = 0; i < perThread; i++)
+                    {
+                        const size_t index = table.Allocate();
+                        table.at(index).Id = (uint8_t)t;
+                        indices[t].push_back(index);
+                    }
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    std::vector<bool> used(threadCount * perThread);
+    for (size_t t = 0; t < threadCount; t++)
+        {
+            for (const size_t index : indices[t])
+                {
+                    EXPECT_FALSE(used[index]);
+                    used[index] = true;
+                    EXPECT_EQ(table.at(index).Id, t);
+                }
+        }
+    EXPECT_EQ(table.FreeCount(), 0);
+    EXPECT_EQ(table.size(), threadCount * perThread);
+}
+
+TEST(UnitRIResourceTable8, RetiredSlotsShouldOnlyBeReusedWhenTheTableIsFull)
+{
+    RIResourceTable<DummyResource, 2> table;
+    table.Initialize(2, 4);
+
+    EXPECT_EQ(table.Allocate(), 0);
+    EXPECT_EQ(table.Allocate(), 1);
+
+    table.Retire(1);
+    table.Retire(0);
+    EXPECT_EQ(table.FreeCount(), 0);
+    EXPECT_EQ(table.RetiredCount(), 2);
+
+    // Grows before reusing a retired slot
+    EXPECT_EQ(table.Allocate(), 2);
+    EXPECT_EQ(table.Allocate(), 3);
+
+    // Released slots come first, then the retired ones in retirement order
+    table.Release(3);
+    EXPECT_EQ(table.Allocate(), 3);
+    EXPECT_EQ(table.Allocate(), 1);
+    EXPECT_EQ(table.Allocate(), 0);
+    EXPECT_EQ(table.RetiredCount(), 0);
+    EXPECT_THROW(table.Allocate(), std::runtime_error);
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+// Must be included after gtest, X11 defines None
+#include "RenderGraph.h"
+
+using namespace Fox;
+
+TEST(UnitRenderGraph, ShouldCullPassesNotContributingToOutputs)
+{
+    RenderGraph graph(nullptr);
+
+    const auto backbuffer = graph.ImportRenderTarget(1, EResourceState::UNDEFINED, EResourceState::PRESENT);
+    const auto unused     = graph.ImportRenderTarget(2, EResourceState::UNDEFINED, EResourceState::UNDEFINED);
+    graph.MarkOutput(backbuffer);
+
+    const auto unusedPass = graph.AddPass("Unused", {});
+    graph.AddColorAttachment(unusedPass, unused, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+    const auto mainPass = graph.AddPass("Main", {});
+    graph.AddColorAttachment(mainPass, backbuffer, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+    const auto readbackPass = graph.AddPass("Readback", {});
+    graph.AddRead(readbackPass, unused, EResourceState::COPY_SOURCE);
+    graph.SetSideEffect(readbackPass);
+
+    graph.Compile();
+
+    EXPECT_FALSE(graph.IsPassCulled(unusedPass)); // Read by a pass with side effects
+    EXPECT_FALSE(graph.IsPassCulled(mainPass));
+    EXPECT_FALSE(graph.IsPassCulled(readbackPass));
+
+    graph.Reset();
+
+    const auto backbuffer2 = graph.ImportRenderTarget(1, EResourceState::UNDEFINED, EResourceState::PRESENT);
+    const auto unused2     = graph.ImportRenderTarget(2, EResourceState::UNDEFINED, EResourceState::UNDEFINED);
+    graph.MarkOutput(backbuffer2);
+
+    const auto unusedPass2 = graph.AddPass("Unused", {});
+    graph.AddColorAttachment(unusedPass2, unused2, ERenderPassLoad::Clear, ERenderPassStore::Store);
+    const auto mainPass2 = graph.AddPass("Main", {});
+    graph.AddColorAttachment(mainPass2, backbuffer2, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+    graph.Compile();
+
+    EXPECT_TRUE(graph.IsPassCulled(unusedPass2));
+    EXPECT_FALSE(graph.IsPassCulled(mainPass2));
+    EXPECT_EQ(graph.GetExecutionOrder(), std::vector<uint32_t>{ mainPass2 });
+}
+
+TEST(UnitRenderGraph2, ClearedAttachmentShouldCullPreviousWriter)
+{
+    RenderGraph graph(nullptr);
+
+    const auto target = graph.ImportRenderTarget(1, EResourceState::RENDER_TARGET, EResourceState::UNDEFINED);
+    graph.MarkOutput(target);
+
+    const auto overwritten = graph.AddPass("Overwritten", {});
+    graph.AddColorAttachment(overwritten, target, ERenderPassLoad::Clear, ERenderPassStore::Store);
+    const auto cleared = graph.AddPass("Cleared", {});
+    graph.AddColorAttachment(cleared, target, ERenderPassLoad::Clear, ERenderPassStore::Store);
+    const auto loaded = graph.AddPass("Loaded", {});
+    graph.AddColorAttachment(loaded, target, ERenderPassLoad::Load, ERenderPassStore::Store);
+
+    graph.Compile();
+
+    EXPECT_TRUE(graph.IsPassCulled(overwritten));
+    EXPECT_FALSE(graph.IsPassCulled(cleared));
+    EXPECT_FALSE(graph.IsPassCulled(loaded));
+}
+
+TEST(UnitRenderGraph3, ShouldEmitOnlyNeededBarriers)
+{
+    RenderGraph graph(nullptr);
+
+    const auto shadow     = graph.ImportRenderTarget(1, EResourceState::SHADER_RESOURCE, EResourceState::UNDEFINED);
+    const auto backbuffer = graph.ImportRenderTarget(2, EResourceState::PRESENT, EResourceState::PRESENT);
+    graph.MarkOutput(backbuffer);
+
+    const auto shadowPass = graph.AddPass("Shadow", {});
+    graph.AddDepthStencilAttachment(shadowPass, shadow, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+    const auto mainPass = graph.AddPass("Main", {});
+    graph.AddRead(mainPass, shadow, EResourceState::SHADER_RESOURCE);
+    graph.AddColorAttachment(mainPass, backbuffer, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+    const auto overlayPass = graph.AddPass("Overlay", {});
+    graph.AddColorAttachment(overlayPass, backbuffer, ERenderPassLoad::Load, ERenderPassStore::Store);
+
+    graph.Compile();
+
+    const auto& shadowBarriers = graph.GetPassBarriers(shadowPass).RenderTargetBarriers;
+    ASSERT_EQ(shadowBarriers.size(), 1);
+    EXPECT_EQ(shadowBarriers[0].RenderTarget, 1);
+    EXPECT_EQ(shadowBarriers[0].mCurrentState, EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(shadowBarriers[0].mNewState, EResourceState::DEPTH_WRITE);
+
+    const auto& mainBarriers = graph.GetPassBarriers(mainPass).RenderTargetBarriers;
+    ASSERT_EQ(mainBarriers.size(), 2);
+    EXPECT_EQ(mainBarriers[0].mNewState, EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(mainBarriers[1].mNewState, EResourceState::RENDER_TARGET);
+
+    // Same state, no barrier
+    EXPECT_EQ(graph.GetPassBarriers(overlayPass).RenderTargetBarriers.size(), 0);
+
+    // Back to present, shadow map is left in its last state
+    const auto& finalBarriers = graph.GetFinalBarriers().RenderTargetBarriers;
+    ASSERT_EQ(finalBarriers.size(), 1);
+    EXPECT_EQ(finalBarriers[0].RenderTarget, 2);
+    EXPECT_EQ(finalBarriers[0].mCurrentState, EResourceState::RENDER_TARGET);
+    EXPECT_EQ(finalBarriers[0].mNewState, EResourceState::PRESENT);
+}
+
+TEST(UnitRenderGraph4, ShouldReorderPassesToReduceTransitions)
+{
+    RenderGraph graph(nullptr);
+
+    const auto texture = graph.ImportTexture(1, EResourceState::SHADER_RESOURCE, EResourceState::UNDEFINED);
+    uint32_t   outputs[3];
+    uint32_t   passes[3];
+    for (uint32_t i = 0; i < 3; i++)
+        {
+            outputs[i] = graph.ImportTexture(10 + i, EResourceState::COPY_DEST, EResourceState::UNDEFINED);
+            graph.MarkOutput(outputs[i]);
+            passes[i] = graph.AddPass("Pass", {});
+            graph.AddWrite(passes[i], outputs[i], EResourceState::COPY_DEST);
+        }
+    graph.AddRead(passes[0], texture, EResourceState::SHADER_RESOURCE);
+    graph.AddRead(passes[1], texture, EResourceState::COPY_SOURCE);
+    graph.AddRead(passes[2], texture, EResourceState::SHADER_RESOURCE);
+
+    graph.Compile();
+
+    const std::vector<uint32_t> expected{ passes[0], passes[2], passes[1] };
+    EXPECT_EQ(graph.GetExecutionOrder(), expected);
+    EXPECT_EQ(graph.GetPassBarriers(passes[0]).TextureBarriers.size(), 0);
+    EXPECT_EQ(graph.GetPassBarriers(passes[2]).TextureBarriers.size(), 0);
+    EXPECT_EQ(graph.GetPassBarriers(passes[1]).TextureBarriers.size(), 1);
+}
+
+TEST(UnitRenderGraph5, ReorderingShouldKeepDependencies)
+{
+    RenderGraph graph(nullptr);
+
+    const auto texture = graph.ImportTexture(1, EResourceState::SHADER_RESOURCE, EResourceState::UNDEFINED);
+    const auto output  = graph.ImportTexture(2, EResourceState::UNORDERED_ACCESS, EResourceState::UNDEFINED);
+    graph.MarkOutput(output);
+
+    // Write after read, must not be moved before the first pass even if it would save a transition
+    const auto reader = graph.AddPass("Reader", {});
+    graph.AddRead(reader, texture, EResourceState::COPY_SOURCE);
+    graph.AddWrite(reader, output, EResourceState::UNORDERED_ACCESS);
+
+    const auto writer = graph.AddPass("Writer", {});
+    graph.AddWrite(writer, texture, EResourceState::SHADER_RESOURCE);
+    graph.AddWrite(writer, output, EResourceState::UNORDERED_ACCESS);
+
+    graph.Compile();
+
+    const std::vector<uint32_t> expected{ reader, writer };
+    EXPECT_EQ(graph.GetExecutionOrder(), expected);
+    // Both write the output as unordered access
+    ASSERT_EQ(graph.GetPassBarriers(writer).TextureBarriers.size(), 2);
+    EXPECT_EQ(graph.GetPassBarriers(writer).TextureBarriers[1].CurrentState, EResourceState::UNORDERED_ACCESS);
+    EXPECT_EQ(graph.GetPassBarriers(writer).TextureBarriers[1].NewState, EResourceState::UNORDERED_ACCESS);
+}
+
+TEST(UnitRenderGraph6, TransientsWithDisjointLifetimesShouldAlias)
+{
+    RenderGraph graph(nullptr);
+
+    const auto backbuffer = graph.ImportRenderTarget(1, EResourceState::RENDER_TARGET, EResourceState::PRESENT);
+    graph.MarkOutput(backbuffer);
+
+    // Blur chain, each target is read only by the next pass
+    uint32_t targets[3];
+    uint32_t passes[4];
+    for (uint32_t i = 0; i < 3; i++)
+        {
+            targets[i] = graph.CreateTransientRenderTarget(EFormat::R8G8B8A8_UNORM, false, 64, 64);
+            passes[i]  = graph.AddPass("Blur", {});
+            if (i > 0)
+                {
+                    graph.AddRead(passes[i], targets[i - 1], EResourceState::SHADER_RESOURCE);
+                }
+            graph.AddColorAttachment(passes[i], targets[i], ERenderPassLoad::Clear, ERenderPassStore::Store);
+        }
+    passes[3] = graph.AddPass("Composite", {});
+    graph.AddRead(passes[3], targets[2], EResourceState::SHADER_RESOURCE);
+    graph.AddColorAttachment(passes[3], backbuffer, ERenderPassLoad::Load, ERenderPassStore::Store);
+
+    const auto unused = graph.CreateTransientRenderTarget(EFormat::R8G8B8A8_UNORM, false, 64, 64);
+
+    graph.Compile();
+
+    EXPECT_EQ(graph.GetAliasGroupCount(), 2);
+    EXPECT_EQ(graph.GetAliasGroup(targets[0]), graph.GetAliasGroup(targets[2]));
+    EXPECT_NE(graph.GetAliasGroup(targets[0]), graph.GetAliasGroup(targets[1]));
+    EXPECT_EQ(graph.GetAliasGroup(unused), RenderGraph::NO_ALIAS_GROUP);
+
+    // The first use of the third target waits for the last accesses of the first one, that used the same memory
+    const auto& barriers = graph.GetPassBarriers(passes[2]).RenderTargetBarriers;
+    ASSERT_EQ(barriers.size(), 2);
+    EXPECT_EQ(barriers[0].mCurrentState, EResourceState::RENDER_TARGET);
+    EXPECT_EQ(barriers[0].mNewState, EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(barriers[0].mAliasedState, EResourceState::UNDEFINED);
+    EXPECT_EQ(barriers[1].mCurrentState, EResourceState::UNDEFINED);
+    EXPECT_EQ(barriers[1].mNewState, EResourceState::RENDER_TARGET);
+    EXPECT_EQ(barriers[1].mAliasedState, EResourceState::SHADER_RESOURCE);
+}
+
+TEST(UnitRenderGraph7, TransientsUsedInTheSamePassShouldNotAlias)
+{
+    RenderGraph graph(nullptr);
+
+    const auto backbuffer = graph.ImportRenderTarget(1, EResourceState::RENDER_TARGET, EResourceState::PRESENT);
+    graph.MarkOutput(backbuffer);
+
+    const auto color = graph.CreateTransientRenderTarget(EFormat::R8G8B8A8_UNORM, false, 64, 64);
+    const auto depth = graph.CreateTransientRenderTarget(EFormat::DEPTH32_FLOAT, true, 64, 64);
+
+    const auto scene = graph.AddPass("Scene", {});
+    graph.AddColorAttachment(scene, color, ERenderPassLoad::Clear, ERenderPassStore::Store);
+    graph.AddDepthStencilAttachment(scene, depth, ERenderPassLoad::Clear, ERenderPassStore::DontCare);
+
+    const auto composite = graph.AddPass("Composite", {});
+    graph.AddRead(composite, color, EResourceState::SHADER_RESOURCE);
+    graph.AddColorAttachment(composite, backbuffer, ERenderPassLoad::Load, ERenderPassStore::Store);
+
+    graph.Compile();
+
+    EXPECT_EQ(graph.GetAliasGroupCount(), 2);
+    EXPECT_NE(graph.GetAliasGroup(color), graph.GetAliasGroup(depth));
+}
+
+TEST(UnitRenderGraph8, KeptTransientsShouldWaitForThePreviousFrame)
+{
+    RenderGraph graph(nullptr);
+
+    uint32_t   scene{};
+    const auto buildFrame = [&graph, &scene]() {
+        const auto backbuffer = graph.ImportRenderTarget(1, EResourceState::RENDER_TARGET, EResourceState::PRESENT);
+        graph.MarkOutput(backbuffer);
+
+        const auto color = graph.CreateTransientRenderTarget(EFormat::R8G8B8A8_UNORM, false, 64, 64);
+        scene            = graph.AddPass("Scene", {});
+        graph.AddColorAttachment(scene, color, ERenderPassLoad::Clear, ERenderPassStore::Store);
+
+        const auto composite = graph.AddPass("Composite", {});
+        graph.AddRead(composite, color, EResourceState::SHADER_RESOURCE);
+        graph.AddColorAttachment(composite, backbuffer, ERenderPassLoad::Load, ERenderPassStore::Store);
+        graph.Compile();
+    };
+
+    buildFrame();
+    {
+        const auto& barriers = graph.GetPassBarriers(scene).RenderTargetBarriers;
+        ASSERT_EQ(barriers.size(), 1);
+        EXPECT_EQ(barriers[0].mCurrentState, EResourceState::UNDEFINED);
+        EXPECT_EQ(barriers[0].mAliasedState, EResourceState::UNDEFINED);
+    }
+
+    // The previous frame might still be reading the same memory
+    graph.Reset();
+    buildFrame();
+    {
+        const auto& barriers = graph.GetPassBarriers(scene).RenderTargetBarriers;
+        ASSERT_EQ(barriers.size(), 1);
+        EXPECT_EQ(barriers[0].mCurrentState, EResourceState::UNDEFINED);
+        EXPECT_EQ(barriers[0].mNewState, EResourceState::RENDER_TARGET);
+        EXPECT_EQ(barriers[0].mAliasedState, EResourceState::SHADER_RESOURCE);
+    }
+}
@@ -0,0 +1,88 @@
+#include "RIResourceTable.h"
+#include "ResourceId.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace Fox;
+
+struct DummySlot
+{
+    uint8_t Id{};
+};
+
+TEST(UnitResourceId, ShouldPackAndUnpackAllFields)
+{
+    const ResourceId id(17, 1234, 65535);
+
+    EXPECT_EQ(id.First(), 17);
+    EXPECT_EQ(id.Second(), 1234);
+    EXPECT_EQ(id.Value(), 65535);
+
+    const ResourceId copy(*id);
+    EXPECT_EQ(copy.First(), 17);
+    EXPECT_EQ(copy.Second(), 1234);
+    EXPECT_EQ(copy.Value(), 65535);
+}
+
+TEST(UnitResourceId2, GenerationShouldNeverBeZero)
+{
+    uint16_t generation{};
+    for (uint32_t i = 0; i < ResourceId::MAX_GENERATION * 2; i++)
+        {
+            generation = ResourceId::NextGeneration(generation);
+            EXPECT_NE(generation, 0);
+            EXPECT_LE(generation, ResourceId::MAX_GENERATION);
+        }
+}
+
+TEST(UnitResourceId3, GenerationShouldIncreaseMonotonicallyAndWrap)
+{
+    EXPECT_EQ(ResourceId::NextGeneration(0), 1);
+    EXPECT_EQ(ResourceId::NextGeneration(1), 2);
+    EXPECT_EQ(ResourceId::NextGeneration(ResourceId::MAX_GENERATION - 1), ResourceId::MAX_GENERATION);
+    EXPECT_EQ(ResourceId::NextGeneration(ResourceId::MAX_GENERATION), 1);
+}
+
+TEST(UnitResourceId4, ReusedSlotShouldProduceDifferentId)
+{
+    const uint16_t   generation = ResourceId::NextGeneration(0);
+    const ResourceId first(0, generation, 0);
+    const ResourceId second(0, ResourceId::NextGeneration(generation), 0);
+
+    EXPECT_NE(*first, 0u);
+    EXPECT_NE(*first, *second);
+}
+
+TEST(UnitResourceId5, SaturatedSlotShouldBeRetiredInsteadOfAliasingOldHandles)
+{
+    // Mirrors the context alloc/free of a single slot churned until its generation is exhausted
+    RIResourceTable<DummySlot, 4> table;
+    table.Initialize(1, 2);
+
+    std::set<uint32_t> ids;
+    uint16_t           generation{};
+    for (;;)
+        {
+            const size_t index = table.Allocate();
+            EXPECT_EQ(index, 0);
+            generation = ResourceId::NextGeneration(generation);
+            EXPECT_TRUE(ids.insert(*ResourceId(0, generation, (uint16_t)index)).second); // Never hands out an old handle
+            if (ResourceId::IsLastGeneration(generation))
+                {
+                    table.Retire(index);
+                    break;
+                }
+            table.Release(index);
+        }
+
+    EXPECT_EQ(ids.size(), ResourceId::MAX_GENERATION);
+    EXPECT_EQ(table.RetiredCount(), 1);
+
+    // Other slots are used first, once the pool is full the retired slot wraps around
+    EXPECT_EQ(table.Allocate(), 1);
+    EXPECT_EQ(table.Allocate(), 0);
+    EXPECT_EQ(ResourceId::NextGeneration(generation), 1);
+    EXPECT_THROW(table.Allocate(), std::runtime_error);
+}
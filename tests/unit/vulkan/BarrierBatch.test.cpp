@@ -0,0 +1,220 @@
+#include "backend/vulkan/VulkanBarrierBatch.h"
+
+#include <gtest/gtest.h>
+
+using namespace Fox;
+
+VkImageMemoryBarrier
+GetImageBarrier(VkImage image, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.srcAccessMask                   = srcAccess;
+    barrier.dstAccessMask                   = dstAccess;
+    barrier.oldLayout                       = oldLayout;
+    barrier.newLayout                       = newLayout;
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = image;
+    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel   = 0;
+    barrier.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+    return barrier;
+}
+
+const auto IMAGE_A = reinterpret_cast<VkImage>(0x1);
+const auto IMAGE_B = reinterpret_cast<VkImage>(0x2);
+
+TEST(UnitBarrierBatch, ShouldGroupBarriersWithTheSameStages)
+{
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.IsEmpty());
+
+    const auto toShaderRead =
+    [](VkImage image) { return GetImageBarrier(image, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL); };
+    EXPECT_TRUE(batch.Add(toShaderRead(IMAGE_A)));
+    EXPECT_TRUE(batch.Add(toShaderRead(IMAGE_B)));
+
+    ASSERT_EQ(batch.GetBarrierCount(), 2);
+    ASSERT_EQ(batch.GetStagePairs().size(), 1);
+    EXPECT_EQ(batch.GetStagePairs()[0].SrcStage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    EXPECT_EQ(batch.GetStagePairs()[0].ImageBarriers.size(), 2);
+
+    // Different destination stage, recorded in its own vkCmdPipelineBarrier
+    const auto image = reinterpret_cast<VkImage>(0x3);
+    EXPECT_TRUE(batch.Add(GetImageBarrier(image, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)));
+    EXPECT_EQ(batch.GetBarrierCount(), 3);
+    EXPECT_EQ(batch.GetStagePairs().size(), 2);
+}
+
+TEST(UnitBarrierBatch2, ShouldMergeTransitionsOfTheSameSubresources)
+{
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(
+    batch.Add(GetImageBarrier(IMAGE_A, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)));
+    EXPECT_TRUE(batch.Add(GetImageBarrier(IMAGE_A, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)));
+
+    ASSERT_EQ(batch.GetBarrierCount(), 1);
+    for (const auto& pair : batch.GetStagePairs())
+        {
+            if (pair.ImageBarriers.size() == 0)
+                continue;
+
+            EXPECT_EQ(pair.SrcStage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            EXPECT_EQ(pair.DstStage, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            EXPECT_EQ(pair.ImageBarriers[0].srcAccessMask, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+            EXPECT_EQ(pair.ImageBarriers[0].dstAccessMask, VK_ACCESS_TRANSFER_READ_BIT);
+            EXPECT_EQ(pair.ImageBarriers[0].oldLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            EXPECT_EQ(pair.ImageBarriers[0].newLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        }
+}
+
+TEST(UnitBarrierBatch3, ShouldRefuseOverlappingTransitionsWithDifferentRanges)
+{
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.Add(GetImageBarrier(IMAGE_A, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)));
+
+    auto mip = GetImageBarrier(IMAGE_A, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    mip.subresourceRange.baseMipLevel = 1;
+    mip.subresourceRange.levelCount   = 1;
+    EXPECT_FALSE(batch.Add(mip));
+    EXPECT_EQ(batch.GetBarrierCount(), 1);
+
+    // Disjoint ranges of the same image are recorded together
+    batch.Clear();
+    EXPECT_TRUE(batch.IsEmpty());
+    auto mip0 = mip;
+    mip0.subresourceRange.baseMipLevel = 0;
+    EXPECT_TRUE(batch.Add(mip0));
+    EXPECT_TRUE(batch.Add(mip));
+    EXPECT_EQ(batch.GetBarrierCount(), 2);
+}
+
+TEST(UnitBarrierBatch4, ShouldMergeSynchronization2Barriers)
+{
+    VkImageMemoryBarrier2KHR toShaderRead{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR };
+    toShaderRead.srcStageMask                = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+    toShaderRead.srcAccessMask               = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+    toShaderRead.dstStageMask                = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    toShaderRead.dstAccessMask               = VK_ACCESS_2_SHADER_READ_BIT_KHR;
+    toShaderRead.oldLayout                   = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    toShaderRead.newLayout                   = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    toShaderRead.image                       = IMAGE_A;
+    toShaderRead.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    toShaderRead.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    toShaderRead.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+    VkImageMemoryBarrier2KHR toCopySource = toShaderRead;
+    toCopySource.srcStageMask             = toShaderRead.dstStageMask;
+    toCopySource.srcAccessMask            = toShaderRead.dstAccessMask;
+    toCopySource.dstStageMask             = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    toCopySource.dstAccessMask            = VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+    toCopySource.oldLayout                = toShaderRead.newLayout;
+    toCopySource.newLayout                = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.Add(toShaderRead));
+    EXPECT_TRUE(batch.Add(toCopySource));
+
+    ASSERT_EQ(batch.GetBarrierCount(), 1);
+    const auto& merged = batch.GetImageBarriers2()[0];
+    EXPECT_EQ(merged.srcStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+    EXPECT_EQ(merged.dstStageMask, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+    EXPECT_EQ(merged.oldLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    EXPECT_EQ(merged.newLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+    // Another image keeps its own stages, it isn't serialized against the first one
+    toShaderRead.image = IMAGE_B;
+    EXPECT_TRUE(batch.Add(toShaderRead));
+    EXPECT_EQ(batch.GetBarrierCount(), 2);
+    EXPECT_EQ(batch.GetImageBarriers2()[1].dstStageMask, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+}
+
+TEST(UnitBarrierBatch5, ShouldMergeBufferBarriersOfTheSameRange)
+{
+    const auto buffer = reinterpret_cast<VkBuffer>(0x4);
+
+    VkBufferMemoryBarrier toCopyDest{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    toCopyDest.srcAccessMask       = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    toCopyDest.dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toCopyDest.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toCopyDest.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toCopyDest.buffer              = buffer;
+    toCopyDest.size                = VK_WHOLE_SIZE;
+
+    VkBufferMemoryBarrier toVertex = toCopyDest;
+    toVertex.srcAccessMask         = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toVertex.dstAccessMask         = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.Add(toCopyDest));
+    // Images and buffers never overlap
+    EXPECT_TRUE(batch.Add(GetImageBarrier(IMAGE_A, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)));
+    EXPECT_TRUE(batch.Add(toVertex));
+    ASSERT_EQ(batch.GetBarrierCount(), 2);
+
+    for (const auto& pair : batch.GetStagePairs())
+        {
+            if (pair.BufferBarriers.size() == 0)
+                continue;
+
+            EXPECT_EQ(pair.DstStage, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+            EXPECT_EQ(pair.BufferBarriers[0].srcAccessMask, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+            EXPECT_EQ(pair.BufferBarriers[0].dstAccessMask, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+        }
+
+    // A range inside the whole buffer must wait for the flush
+    toCopyDest.offset = 256;
+    toCopyDest.size   = 256;
+    EXPECT_FALSE(batch.Add(toCopyDest));
+    EXPECT_EQ(batch.GetBarrierCount(), 2);
+}
+
+TEST(UnitBarrierBatch6, ShouldNotMergeOwnershipTransfers)
+{
+    auto release                = GetImageBarrier(IMAGE_A, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    release.srcQueueFamilyIndex = 1;
+    release.dstQueueFamilyIndex = 0;
+
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.Add(GetImageBarrier(IMAGE_A, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)));
+    EXPECT_FALSE(batch.Add(release));
+
+    batch.Clear();
+    EXPECT_TRUE(batch.Add(release));
+    EXPECT_TRUE(batch.Add(GetImageBarrier(IMAGE_B, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)));
+    EXPECT_EQ(batch.GetBarrierCount(), 2);
+}
+
+TEST(UnitBarrierBatch7, AliasedImageShouldWaitForThePreviousResource)
+{
+    // The previous render target of the memory was last sampled, the new one is written as attachment
+    const auto barrier = MakeImageBarrier(IMAGE_A, VK_IMAGE_ASPECT_COLOR_BIT, EResourceState::UNDEFINED, EResourceState::RENDER_TARGET, 0, 1, 0, 1, EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(barrier.oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+    EXPECT_EQ(barrier.newLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    EXPECT_EQ(barrier.srcAccessMask, VK_ACCESS_SHADER_READ_BIT);
+
+    RIVkBarrierBatch batch;
+    EXPECT_TRUE(batch.Add(barrier));
+    ASSERT_EQ(batch.GetStagePairs().size(), 1);
+    EXPECT_NE(batch.GetStagePairs()[0].SrcStage & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0);
+    EXPECT_EQ(batch.GetStagePairs()[0].DstStage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    // Synchronization2 waits for the stages of the previous state instead of none
+    const auto barrier2 = MakeImageBarrier2(IMAGE_A, VK_IMAGE_ASPECT_COLOR_BIT, EResourceState::UNDEFINED, EResourceState::RENDER_TARGET, 0, 1, 0, 1, EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(barrier2.oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+    EXPECT_EQ(barrier2.srcStageMask, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+    EXPECT_EQ(barrier2.srcAccessMask, VK_ACCESS_2_SHADER_READ_BIT_KHR);
+    EXPECT_EQ(barrier2.dstStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+
+    // Previously written as attachment
+    const auto afterWrite = MakeImageBarrier2(IMAGE_A, VK_IMAGE_ASPECT_COLOR_BIT, EResourceState::UNDEFINED, EResourceState::RENDER_TARGET, 0, 1, 0, 1, EResourceState::RENDER_TARGET);
+    EXPECT_EQ(afterWrite.srcStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+    EXPECT_EQ(afterWrite.srcAccessMask, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR);
+
+    // Without aliasing a transition from undefined waits for nothing
+    const auto fresh = MakeImageBarrier2(IMAGE_A, VK_IMAGE_ASPECT_COLOR_BIT, EResourceState::UNDEFINED, EResourceState::RENDER_TARGET, 0, 1, 0, 1);
+    EXPECT_EQ(fresh.srcStageMask, VK_PIPELINE_STAGE_2_NONE_KHR);
+    EXPECT_EQ(fresh.srcAccessMask, 0);
+}
@@ -0,0 +1,60 @@
+#include "backend/vulkan/VulkanDescriptorWriteBatch.h"
+
+#include <gtest/gtest.h>
+
+using namespace Fox;
+
+const auto SET_A = reinterpret_cast<VkDescriptorSet>(0x1);
+const auto SET_B = reinterpret_cast<VkDescriptorSet>(0x2);
+
+TEST(UnitDescriptorWriteBatch, ShouldResolveTheInfosOfEveryWriteInOrder)
+{
+    RIVkDescriptorWriteBatch batch;
+    EXPECT_TRUE(batch.IsEmpty());
+
+    VkDescriptorImageInfo* images = batch.AddImageWrite(SET_A, 0, 2, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2);
+    images[0].imageView           = reinterpret_cast<VkImageView>(0x10);
+    images[1].imageView           = reinterpret_cast<VkImageView>(0x11);
+
+    VkDescriptorBufferInfo* buffer = batch.AddBufferWrite(SET_B, 1, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+    buffer->buffer                 = reinterpret_cast<VkBuffer>(0x20);
+
+    // Queued after the first ones grew the image infos, it must not invalidate them
+    VkDescriptorImageInfo* samplers = batch.AddImageWrite(SET_A, 1, 0, VK_DESCRIPTOR_TYPE_SAMPLER, 3);
+    samplers[2].sampler             = reinterpret_cast<VkSampler>(0x30);
+
+    ASSERT_EQ(batch.GetWriteCount(), 3);
+    const auto& writes = batch.GetWrites();
+
+    EXPECT_EQ(writes[0].dstSet, SET_A);
+    EXPECT_EQ(writes[0].dstBinding, 0);
+    EXPECT_EQ(writes[0].dstArrayElement, 2);
+    EXPECT_EQ(writes[0].descriptorCount, 2);
+    ASSERT_NE(writes[0].pImageInfo, nullptr);
+    EXPECT_EQ(writes[0].pImageInfo[0].imageView, reinterpret_cast<VkImageView>(0x10));
+    EXPECT_EQ(writes[0].pImageInfo[1].imageView, reinterpret_cast<VkImageView>(0x11));
+
+    EXPECT_EQ(writes[1].dstSet, SET_B);
+    EXPECT_EQ(writes[1].descriptorType, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    EXPECT_EQ(writes[1].pImageInfo, nullptr);
+    ASSERT_NE(writes[1].pBufferInfo, nullptr);
+    EXPECT_EQ(writes[1].pBufferInfo->buffer, reinterpret_cast<VkBuffer>(0x20));
+
+    EXPECT_EQ(writes[2].descriptorType, VK_DESCRIPTOR_TYPE_SAMPLER);
+    EXPECT_EQ(writes[2].descriptorCount, 3);
+    EXPECT_EQ(writes[2].pImageInfo, writes[0].pImageInfo + 2);
+    EXPECT_EQ(writes[2].pImageInfo[2].sampler, reinterpret_cast<VkSampler>(0x30));
+}
+
+TEST(UnitDescriptorWriteBatch, ShouldBeEmptyAfterClear)
+{
+    RIVkDescriptorWriteBatch batch;
+    batch.AddBufferWrite(SET_A, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4);
+    batch.AddImageWrite(SET_A, 1, 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1);
+    EXPECT_FALSE(batch.IsEmpty());
+
+    batch.Clear();
+    EXPECT_TRUE(batch.IsEmpty());
+    EXPECT_EQ(batch.GetWriteCount(), 0);
+    EXPECT_TRUE(batch.GetWrites().empty());
+}
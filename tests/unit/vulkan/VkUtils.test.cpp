@@ -37,4 +37,190 @@ TEST(UnitFilterExclusive, ShouldFilterAsExpected)
         const auto found = std::find_if(onlyIncluded.begin(), onlyIncluded.end(), [&source](const char* a) { return strcmp(a, source[2]) == 0; });
         ASSERT_NE(found, onlyIncluded.end());
     }
-}
\ No newline at end of file
+}
+TEST(UnitResourceStateToPipelineStage2, ShouldOnlyIncludeTheStagesOfTheState)
+{
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::UNDEFINED), VK_PIPELINE_STAGE_2_NONE_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::PRESENT), VK_PIPELINE_STAGE_2_NONE_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::RENDER_TARGET), VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::COPY_SOURCE), VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::PIXEL_SHADER_RESOURCE), VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::NON_PIXEL_SHADER_RESOURCE), VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+    EXPECT_EQ(resourceStateToPipelineStage2(Fox::EResourceState::COMMON), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+
+    // Combined states wait on the stages of all of them
+    const auto generalRead = resourceStateToPipelineStage2(Fox::EResourceState::GENERAL_READ);
+    EXPECT_NE(generalRead & VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR, 0);
+    EXPECT_NE(generalRead & VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, 0);
+    EXPECT_NE(generalRead & VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, 0);
+    EXPECT_EQ(generalRead & VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, 0);
+}
+
+TEST(UnitRestrictPipelineStages2, ShouldOnlyKeepTheStagesOfTheQueue)
+{
+    const auto shaderResource = resourceStateToPipelineStage2(Fox::EResourceState::SHADER_RESOURCE);
+    EXPECT_EQ(restrictPipelineStages2(shaderResource, Fox::EQueueType::GRAPHICS), shaderResource);
+    EXPECT_EQ(restrictPipelineStages2(shaderResource, Fox::EQueueType::COMPUTE), VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+    EXPECT_EQ(restrictPipelineStages2(VK_PIPELINE_STAGE_2_NONE_KHR, Fox::EQueueType::COMPUTE), VK_PIPELINE_STAGE_2_NONE_KHR);
+
+    // No stage left, waits on everything the queue does
+    EXPECT_EQ(restrictPipelineStages2(VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, Fox::EQueueType::TRANSFER), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+    EXPECT_EQ(restrictPipelineStages2(VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, Fox::EQueueType::TRANSFER), VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+}
+
+TEST(UnitConvertPushConstantRanges, ShouldConvertOneRangePerStage)
+{
+    const std::vector<Fox::ShaderPushConstantRange> ranges{ { Fox::EShaderStage::VERTEX, 0, 64 }, { Fox::EShaderStage::FRAGMENT, 64, 16 } };
+    const auto                                      pushConstantRanges = convertPushConstantRanges(ranges);
+
+    ASSERT_EQ(pushConstantRanges.size(), 2);
+    EXPECT_EQ(pushConstantRanges[0].stageFlags, VK_SHADER_STAGE_VERTEX_BIT);
+    EXPECT_EQ(pushConstantRanges[0].offset, 0);
+    EXPECT_EQ(pushConstantRanges[0].size, 64);
+    EXPECT_EQ(pushConstantRanges[1].stageFlags, VK_SHADER_STAGE_FRAGMENT_BIT);
+    EXPECT_EQ(pushConstantRanges[1].offset, 64);
+    EXPECT_EQ(pushConstantRanges[1].size, 16);
+
+    EXPECT_TRUE(convertPushConstantRanges({}).empty());
+    EXPECT_EQ(convertShaderStage(Fox::EShaderStage::COMPUTE), VK_SHADER_STAGE_COMPUTE_BIT);
+    EXPECT_EQ(convertShaderStage(Fox::EShaderStage::ALL), VK_SHADER_STAGE_ALL_GRAPHICS);
+}
+
+TEST(UnitConvertVertexLayout, ShouldReadPerInstanceAttributesFromTheInstanceStream)
+{
+    const std::vector<Fox::VertexLayoutInfo> info{ { "POSITION", Fox::EFormat::R32G32B32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA },
+        { "UV", Fox::EFormat::R32G32_FLOAT, 12, Fox::EVertexInputClassification::PER_VERTEX_DATA },
+        { "OFFSET", Fox::EFormat::R32G32B32A32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1 } };
+
+    std::vector<VkVertexInputAttributeDescription>                                   attributes;
+    std::array<std::optional<VkVertexInputRate>, Fox::VertexLayoutInfo::MAX_STREAMS> streamInputRates;
+    ASSERT_TRUE(convertVertexLayout(info, attributes, streamInputRates));
+
+    ASSERT_EQ(attributes.size(), 3);
+    EXPECT_EQ(attributes[0].location, 0);
+    EXPECT_EQ(attributes[0].binding, Fox::VertexLayoutInfo::VERTEX_STREAM);
+    EXPECT_EQ(attributes[0].format, VK_FORMAT_R32G32B32_SFLOAT);
+    EXPECT_EQ(attributes[1].location, 1);
+    EXPECT_EQ(attributes[1].binding, Fox::VertexLayoutInfo::VERTEX_STREAM);
+    EXPECT_EQ(attributes[1].offset, 12);
+    EXPECT_EQ(attributes[2].location, 2);
+    EXPECT_EQ(attributes[2].binding, Fox::VertexLayoutInfo::INSTANCE_STREAM);
+    EXPECT_EQ(attributes[2].offset, 0);
+
+    EXPECT_EQ(streamInputRates[Fox::VertexLayoutInfo::VERTEX_STREAM], VK_VERTEX_INPUT_RATE_VERTEX);
+    EXPECT_EQ(streamInputRates[Fox::VertexLayoutInfo::INSTANCE_STREAM], VK_VERTEX_INPUT_RATE_INSTANCE);
+    EXPECT_FALSE(streamInputRates[2].has_value());
+
+    // The instance stream advances by InstanceStride
+    const std::array<uint32_t, Fox::VertexLayoutInfo::MAX_STREAMS> strides{ 20, 16 };
+    const auto                                                     bindings = convertVertexInputBindings(streamInputRates, strides);
+    ASSERT_EQ(bindings.size(), 2);
+    EXPECT_EQ(bindings[0].binding, Fox::VertexLayoutInfo::VERTEX_STREAM);
+    EXPECT_EQ(bindings[0].stride, 20);
+    EXPECT_EQ(bindings[0].inputRate, VK_VERTEX_INPUT_RATE_VERTEX);
+    EXPECT_EQ(bindings[1].binding, Fox::VertexLayoutInfo::INSTANCE_STREAM);
+    EXPECT_EQ(bindings[1].stride, 16);
+    EXPECT_EQ(bindings[1].inputRate, VK_VERTEX_INPUT_RATE_INSTANCE);
+}
+
+TEST(UnitConvertVertexLayout2, ShouldRejectLayoutsRequiringAttributeDivisors)
+{
+    std::vector<VkVertexInputAttributeDescription>                                   attributes;
+    std::array<std::optional<VkVertexInputRate>, Fox::VertexLayoutInfo::MAX_STREAMS> streamInputRates;
+
+    // 0 and 1 advance every instance, every 2 instances requires a divisor
+    EXPECT_TRUE(convertVertexLayout({ { "OFFSET", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 0 } }, attributes, streamInputRates));
+    EXPECT_TRUE(convertVertexLayout({ { "OFFSET", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1 } }, attributes, streamInputRates));
+    EXPECT_FALSE(convertVertexLayout({ { "OFFSET", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 2 } }, attributes, streamInputRates));
+
+    // The step rate of per vertex attributes is ignored
+    EXPECT_TRUE(convertVertexLayout({ { "POSITION", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA, 2 } }, attributes, streamInputRates));
+
+    // A binding has a single input rate
+    const std::vector<Fox::VertexLayoutInfo> sharedStream{ { "POSITION", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA, 0, 0 },
+        { "OFFSET", Fox::EFormat::R32G32_FLOAT, 8, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1, 0 } };
+    EXPECT_FALSE(convertVertexLayout(sharedStream, attributes, streamInputRates));
+    EXPECT_FALSE(convertVertexLayout({ { "POSITION", Fox::EFormat::R32G32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA, 0, Fox::VertexLayoutInfo::MAX_STREAMS } }, attributes, streamInputRates));
+}
+
+TEST(UnitConvertVertexLayout3, ShouldBindEveryStreamReadByAnAttribute)
+{
+    // Positions, normals and per instance transforms each in their own buffer, stream 1 isn't used
+    const std::vector<Fox::VertexLayoutInfo> info{ { "POSITION", Fox::EFormat::R32G32B32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA, 0, 0 },
+        { "NORMAL", Fox::EFormat::R32G32B32_FLOAT, 0, Fox::EVertexInputClassification::PER_VERTEX_DATA, 0, 2 },
+        { "TRANSFORM", Fox::EFormat::R32G32B32A32_FLOAT, 0, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1, 3 },
+        { "COLOR", Fox::EFormat::R32G32B32A32_FLOAT, 16, Fox::EVertexInputClassification::PER_INSTANCE_DATA, 1, 3 } };
+
+    std::vector<VkVertexInputAttributeDescription>                                   attributes;
+    std::array<std::optional<VkVertexInputRate>, Fox::VertexLayoutInfo::MAX_STREAMS> streamInputRates;
+    ASSERT_TRUE(convertVertexLayout(info, attributes, streamInputRates));
+
+    ASSERT_EQ(attributes.size(), 4);
+    EXPECT_EQ(attributes[0].binding, 0);
+    EXPECT_EQ(attributes[1].binding, 2);
+    EXPECT_EQ(attributes[2].binding, 3);
+    EXPECT_EQ(attributes[3].binding, 3);
+    EXPECT_EQ(attributes[3].location, 3);
+    EXPECT_EQ(attributes[3].offset, 16);
+
+    Fox::ShaderSource source;
+    source.StreamStrides = { 12, 0, 12, 32 };
+    const auto bindings  = convertVertexInputBindings(streamInputRates, resolveStreamStrides(source));
+    ASSERT_EQ(bindings.size(), 3);
+    EXPECT_EQ(bindings[0].binding, 0);
+    EXPECT_EQ(bindings[0].stride, 12);
+    EXPECT_EQ(bindings[0].inputRate, VK_VERTEX_INPUT_RATE_VERTEX);
+    EXPECT_EQ(bindings[1].binding, 2);
+    EXPECT_EQ(bindings[1].stride, 12);
+    EXPECT_EQ(bindings[1].inputRate, VK_VERTEX_INPUT_RATE_VERTEX);
+    EXPECT_EQ(bindings[2].binding, 3);
+    EXPECT_EQ(bindings[2].stride, 32);
+    EXPECT_EQ(bindings[2].inputRate, VK_VERTEX_INPUT_RATE_INSTANCE);
+}
+
+TEST(UnitResolveStreamStrides, ShouldFallBackToTheVertexAndInstanceStrides)
+{
+    Fox::ShaderSource source;
+    source.VertexStride   = 20;
+    source.InstanceStride = 64;
+
+    using Strides = std::array<uint32_t, Fox::VertexLayoutInfo::MAX_STREAMS>;
+    EXPECT_EQ(resolveStreamStrides(source), (Strides{ 20, 64, 0, 0 }));
+
+    // The stream strides take precedence, the other streams have no fallback
+    source.StreamStrides = { 12, 0, 8, 0 };
+    EXPECT_EQ(resolveStreamStrides(source), (Strides{ 12, 64, 8, 0 }));
+    source.StreamStrides = { 0, 16, 0, 4 };
+    EXPECT_EQ(resolveStreamStrides(source), (Strides{ 20, 16, 0, 4 }));
+}
+
+TEST(UnitConvertIndexType, ShouldConvertBothIndexSizes)
+{
+    EXPECT_EQ(convertIndexType(Fox::EIndexType::UINT16), VK_INDEX_TYPE_UINT16);
+    EXPECT_EQ(convertIndexType(Fox::EIndexType::UINT32), VK_INDEX_TYPE_UINT32);
+}
+
+TEST(UnitIsIndexOffsetAligned, ShouldRequireMultiplesOfTheIndexSize)
+{
+    EXPECT_TRUE(isIndexOffsetAligned(0, Fox::EIndexType::UINT16));
+    EXPECT_TRUE(isIndexOffsetAligned(6, Fox::EIndexType::UINT16));
+    EXPECT_FALSE(isIndexOffsetAligned(3, Fox::EIndexType::UINT16));
+
+    EXPECT_TRUE(isIndexOffsetAligned(0, Fox::EIndexType::UINT32));
+    EXPECT_TRUE(isIndexOffsetAligned(8, Fox::EIndexType::UINT32));
+    EXPECT_FALSE(isIndexOffsetAligned(6, Fox::EIndexType::UINT32));
+    EXPECT_FALSE(isIndexOffsetAligned(2, Fox::EIndexType::UINT32));
+}
+
+TEST(UnitFitsPushConstantSize, ShouldRequireEveryRangeToEndWithinTheLimit)
+{
+    // Every device supports at least 128 bytes
+    const std::vector<Fox::ShaderPushConstantRange> ranges{ { Fox::EShaderStage::VERTEX, 0, 64 }, { Fox::EShaderStage::FRAGMENT, 64, 64 } };
+    EXPECT_TRUE(fitsPushConstantSize(ranges, 128));
+    EXPECT_TRUE(fitsPushConstantSize(ranges, 256));
+    EXPECT_FALSE(fitsPushConstantSize(ranges, 124));
+    EXPECT_TRUE(fitsPushConstantSize({}, 128));
+
+    const std::vector<Fox::ShaderPushConstantRange> pastTheLimit{ { Fox::EShaderStage::COMPUTE, 128, 4 } };
+    EXPECT_FALSE(fitsPushConstantSize(pastTheLimit, 128));
+}
@@ -5,20 +5,19 @@
 #include "backend/vulkan/VulkanContextFactory.h"
 #include "backend/vulkan/VulkanDevice13.h"
 
+/*Copies the first mip of the image to outData, the image is left in currentLayout. Work writing to it must be completed*/
 static void
-ExtractImage(Fox::VulkanContext* vkContext, Fox::DImage src, uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, uint32_t bytes, void* outData)
+ExtractImage(Fox::VulkanContext* vkContext, VkImage src, VkImageLayout currentLayout, uint32_t width, uint32_t height, uint32_t bytes, void* outData)
 {
-    Fox::DImageVulkan* vkSrcImg = static_cast<Fox::DImageVulkan*>(src);
-
     Fox::RIVulkanDevice13& device = vkContext->GetDevice();
 
     auto                   cmdPool   = device.CreateCommandPool();
     auto                   cmdBuffer = cmdPool->Allocate();
     Fox::CResourceTransfer transfer(cmdBuffer->Cmd);
 
-    auto outImg = device.CreateBufferHostVisible(16, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    auto outImg = device.CreateBufferHostVisible(bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
 
-    transfer.CopyImageToBuffer(outImg.Buffer, vkSrcImg->Image.Image, { width, height }, 0);
+    transfer.CopyImageToBuffer(outImg.Buffer, src, { width, height }, 0, currentLayout);
 
     transfer.FinishCommandBuffer();
 
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+/*SPIR-V of the shaders of the integration tests, assembled by hand to not depend on a shader compiler*/
+
+static std::vector<unsigned char>
+SpirvBytes(const uint32_t* words, size_t count)
+{
+    std::vector<unsigned char> bytes(count * sizeof(uint32_t));
+    std::memcpy(bytes.data(), words, bytes.size());
+    return bytes;
+};
+
+/*
+#version 450
+layout(local_size_x = 64) in;
+layout(set = 0, binding = 0) buffer Values { uint values[]; };
+layout(push_constant) uniform Push { uint multiplier; };
+void main() { values[gl_GlobalInvocationID.x] = gl_GlobalInvocationID.x * multiplier; }
+*/
+static constexpr uint32_t MultiplyIndexComputeShader[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x0000001c, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+    0x00000000, 0x00000001, 0x0006000f, 0x00000005, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+    0x00060010, 0x00000001, 0x00000011, 0x00000040, 0x00000001, 0x00000001, 0x00040047, 0x00000002,
+    0x0000000b, 0x0000001c, 0x00040047, 0x00000003, 0x00000006, 0x00000004, 0x00050048, 0x00000004,
+    0x00000000, 0x00000023, 0x00000000, 0x00030047, 0x00000004, 0x00000003, 0x00040047, 0x00000005,
+    0x00000022, 0x00000000, 0x00040047, 0x00000005, 0x00000021, 0x00000000, 0x00050048, 0x00000006,
+    0x00000000, 0x00000023, 0x00000000, 0x00030047, 0x00000006, 0x00000002, 0x00020013, 0x00000007,
+    0x00030021, 0x00000008, 0x00000007, 0x00040015, 0x00000009, 0x00000020, 0x00000000, 0x00040015,
+    0x0000000a, 0x00000020, 0x00000001, 0x00040017, 0x0000000b, 0x00000009, 0x00000003, 0x00040020,
+    0x0000000c, 0x00000001, 0x0000000b, 0x0004003b, 0x0000000c, 0x00000002, 0x00000001, 0x0003001d,
+    0x00000003, 0x00000009, 0x0003001e, 0x00000004, 0x00000003, 0x00040020, 0x0000000d, 0x00000002,
+    0x00000004, 0x0004003b, 0x0000000d, 0x00000005, 0x00000002, 0x0003001e, 0x00000006, 0x00000009,
+    0x00040020, 0x0000000e, 0x00000009, 0x00000006, 0x0004003b, 0x0000000e, 0x0000000f, 0x00000009,
+    0x0004002b, 0x0000000a, 0x00000010, 0x00000000, 0x0004002b, 0x00000009, 0x00000011, 0x00000000,
+    0x00040020, 0x00000012, 0x00000001, 0x00000009, 0x00040020, 0x00000013, 0x00000009, 0x00000009,
+    0x00040020, 0x00000014, 0x00000002, 0x00000009, 0x00050036, 0x00000007, 0x00000001, 0x00000000,
+    0x00000008, 0x000200f8, 0x00000015, 0x00050041, 0x00000012, 0x00000016, 0x00000002, 0x00000011,
+    0x0004003d, 0x00000009, 0x00000017, 0x00000016, 0x00050041, 0x00000013, 0x00000018, 0x0000000f,
+    0x00000010, 0x0004003d, 0x00000009, 0x00000019, 0x00000018, 0x00050084, 0x00000009, 0x0000001a,
+    0x00000017, 0x00000019, 0x00060041, 0x00000014, 0x0000001b, 0x00000005, 0x00000010, 0x00000017,
+    0x0003003e, 0x0000001b, 0x0000001a, 0x000100fd, 0x00010038,
+};
+
+/*
+#version 450
+layout(location = 0) in vec2 position; // Per vertex
+layout(location = 1) in vec2 offset; // Per instance
+void main() { gl_Position = vec4(position + offset, 0.0, 1.0); }
+*/
+static constexpr uint32_t OffsetInstanceVertexShader[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x00000015, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+    0x00000000, 0x00000001, 0x0008000f, 0x00000000, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+    0x00000003, 0x00000004, 0x00040047, 0x00000002, 0x0000001e, 0x00000000, 0x00040047, 0x00000003,
+    0x0000001e, 0x00000001, 0x00040047, 0x00000004, 0x0000000b, 0x00000000, 0x00020013, 0x00000005,
+    0x00030021, 0x00000006, 0x00000005, 0x00030016, 0x00000007, 0x00000020, 0x00040017, 0x00000008,
+    0x00000007, 0x00000002, 0x00040017, 0x00000009, 0x00000007, 0x00000004, 0x00040020, 0x0000000a,
+    0x00000001, 0x00000008, 0x0004003b, 0x0000000a, 0x00000002, 0x00000001, 0x0004003b, 0x0000000a,
+    0x00000003, 0x00000001, 0x00040020, 0x0000000b, 0x00000003, 0x00000009, 0x0004003b, 0x0000000b,
+    0x00000004, 0x00000003, 0x0004002b, 0x00000007, 0x0000000c, 0x00000000, 0x0004002b, 0x00000007,
+    0x0000000d, 0x3f800000, 0x00050036, 0x00000005, 0x00000001, 0x00000000, 0x00000006, 0x000200f8,
+    0x0000000e, 0x0004003d, 0x00000008, 0x0000000f, 0x00000002, 0x0004003d, 0x00000008, 0x00000010,
+    0x00000003, 0x00050081, 0x00000008, 0x00000011, 0x0000000f, 0x00000010, 0x00050051, 0x00000007,
+    0x00000012, 0x00000011, 0x00000000, 0x00050051, 0x00000007, 0x00000013, 0x00000011, 0x00000001,
+    0x00070050, 0x00000009, 0x00000014, 0x00000012, 0x00000013, 0x0000000c, 0x0000000d, 0x0003003e,
+    0x00000004, 0x00000014, 0x000100fd, 0x00010038,
+};
+
+/*
+#version 450
+layout(location = 0) out vec4 color;
+void main() { color = vec4(1.0, 0.0, 0.0, 1.0); }
+*/
+static constexpr uint32_t RedPixelShader[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x0000000c, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+    0x00000000, 0x00000001, 0x0006000f, 0x00000004, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+    0x00030010, 0x00000001, 0x00000007, 0x00040047, 0x00000002, 0x0000001e, 0x00000000, 0x00020013,
+    0x00000003, 0x00030021, 0x00000004, 0x00000003, 0x00030016, 0x00000005, 0x00000020, 0x00040017,
+    0x00000006, 0x00000005, 0x00000004, 0x00040020, 0x00000007, 0x00000003, 0x00000006, 0x0004003b,
+    0x00000007, 0x00000002, 0x00000003, 0x0004002b, 0x00000005, 0x00000008, 0x00000000, 0x0004002b,
+    0x00000005, 0x00000009, 0x3f800000, 0x0007002c, 0x00000006, 0x0000000a, 0x00000009, 0x00000008,
+    0x00000008, 0x00000009, 0x00050036, 0x00000003, 0x00000001, 0x00000000, 0x00000004, 0x000200f8,
+    0x0000000b, 0x0003003e, 0x00000002, 0x0000000a, 0x000100fd, 0x00010038,
+};